@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file smf_player.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "smf_player.h"
+#include "core/event_bus.h"
+#include "core/smf.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "hal/song_bank.h"
+#include "hal/synth.h"
+#include <stdio.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define TAG "smf_player"
+
+#define PLAYER_TASK_PRIO 5
+#define PLAYER_TASK_STACK (3 * 1024)
+#define PLAYER_TASK_CORE (0) // Away from the render task
+
+#define POLL_MS 10
+// Events are queued this far ahead of the output, well over the poll period
+// so a late wake-up does not delay a note
+#define LOOKAHEAD_SAMPLES (SYNTH_SAMPLING_RATE_HZ * 5 * POLL_MS / 1000)
+#define STOP_TIMEOUT_MS 100
+
+// Task notification values
+#define REQUEST_STOP (1UL << 8)
+#define REQUEST_PLAY (1UL << 9) // Song index in the low byte
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static TaskHandle_t player_task_handle = NULL;
+static char names[SONG_BANK_MAX_SONGS][SMF_NAME_LEN] = {0};
+
+// Owned by the player task
+static smf_t smf;
+static smf_event_t pending;
+static bool pending_valid = false;
+static uint32_t start_time = 0; // Play clock sample of the song start
+static uint32_t last_time = 0;  // Latest event handed to the synth
+static uint32_t last_bar = 0;
+static volatile bool playing = false;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void publish(smf_player_event_t type, uint32_t value)
+{
+    event_t event = {.source = EVENT_SRC_SMF_PLAYER, .type = type, .value = value};
+    event_bus_publish(&event);
+}
+
+/**
+ * @brief Queue an event, waiting for room if need be
+ *
+ * Used outside of the song flow, where dropping an event would leave notes
+ * hanging. Gives up if the synth does not drain its queue (stopped timer).
+ */
+static void schedule_blocking(uint32_t time, synth_cmd_type_t type, uint8_t channel, uint8_t data1, uint8_t data2)
+{
+    synth_cmd_t cmd = {.type = type, .channel = channel, .data1 = data1, .data2 = data2};
+
+    for (int waited = 0; synth_schedule(time, &cmd) != ESP_OK; waited += POLL_MS)
+    {
+        if (waited >= STOP_TIMEOUT_MS)
+        {
+            ESP_LOGW(TAG, "Synth queue stuck, event dropped");
+            return;
+        }
+        vTaskDelay(pdMS_TO_TICKS(POLL_MS));
+    }
+}
+
+/**
+ * @brief Put every channel back to its default state
+ *
+ * Events already queued are kept in order: the reset goes after the last
+ * one, or at once if they have all played.
+ */
+static void reset_channels(void)
+{
+    uint32_t now = synth_now();
+    uint32_t time = (int32_t)(last_time - now) > 0 ? last_time : now;
+
+    for (uint8_t ch = 0; ch < SYNTH_CHANNEL_COUNT; ++ch)
+    {
+        schedule_blocking(time, SYNTH_CMD_CONTROL_CHANGE, ch, SYNTH_CC_ALL_NOTES_OFF, 0);
+        schedule_blocking(time, SYNTH_CMD_CONTROL_CHANGE, ch, SYNTH_CC_RESET_CONTROLLERS, 0);
+    }
+
+    last_time = time;
+}
+
+static bool to_cmd(const smf_event_t *event, synth_cmd_t *cmd)
+{
+    cmd->channel = event->status & 0x0F;
+    cmd->data1 = event->data1;
+    cmd->data2 = event->data2;
+
+    switch (event->status >> 4)
+    {
+    case 0x8:
+        cmd->type = SYNTH_CMD_NOTE_OFF;
+        return true;
+    case 0x9:
+        cmd->type = event->data2 ? SYNTH_CMD_NOTE_ON : SYNTH_CMD_NOTE_OFF;
+        return true;
+    case 0xB:
+        cmd->type = SYNTH_CMD_CONTROL_CHANGE;
+        return true;
+    case 0xC:
+        cmd->type = SYNTH_CMD_PROGRAM_CHANGE;
+        return true;
+    case 0xE:
+        cmd->type = SYNTH_CMD_PITCH_BEND;
+        return true;
+    default:
+        return false; // Aftertouch is not used by the synth
+    }
+}
+
+static void start_song(uint8_t index)
+{
+    const uint8_t *data;
+    size_t size;
+
+    if (song_bank_get(index, &data, &size) != ESP_OK ||
+        smf_open(&smf, data, size, SYNTH_SAMPLING_RATE_HZ) != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Song %d is not a playable MIDI file", (int)index);
+        publish(SMF_PLAYER_EVENT_FINISHED, 0);
+        return;
+    }
+
+    // Programs from a previous song or the keyboard do not carry over
+    reset_channels();
+    for (uint8_t ch = 0; ch < SYNTH_CHANNEL_COUNT; ++ch)
+        schedule_blocking(last_time, SYNTH_CMD_PROGRAM_CHANGE, ch, 0, 0);
+
+    start_time = last_time;
+    pending_valid = false;
+    last_bar = 0;
+    playing = true;
+
+    ESP_LOGI(TAG, "Playing %s", names[index]);
+}
+
+static void stop_song(void)
+{
+    playing = false;
+    reset_channels();
+}
+
+/**
+ * @brief Hand the synth every event up to the lookahead horizon
+ */
+static void feed(void)
+{
+    uint32_t horizon = synth_now() + LOOKAHEAD_SAMPLES;
+
+    while (1)
+    {
+        if (!pending_valid && !(pending_valid = smf_next(&smf, &pending)))
+        {
+            stop_song();
+            publish(SMF_PLAYER_EVENT_FINISHED, 0);
+            return;
+        }
+
+        uint32_t time = start_time + pending.time;
+        if ((int32_t)(time - horizon) > 0) break;
+
+        synth_cmd_t cmd;
+        if (to_cmd(&pending, &cmd) && synth_schedule(time, &cmd) != ESP_OK) break; // Full, retried next poll
+
+        last_time = time;
+        pending_valid = false;
+    }
+
+    uint32_t bar;
+    uint8_t beat;
+    smf_position(&smf, &bar, &beat);
+    if (bar != last_bar) publish(SMF_PLAYER_EVENT_BAR, bar);
+    last_bar = bar;
+}
+
+static void player_task(void *pvParams)
+{
+    uint32_t request;
+
+    while (1)
+    {
+        TickType_t wait = playing ? pdMS_TO_TICKS(POLL_MS) : portMAX_DELAY;
+        if (xTaskNotifyWait(0, UINT32_MAX, &request, wait) == pdTRUE)
+        {
+            if (playing) stop_song();
+            if (request & REQUEST_PLAY) start_song(request & 0xFF);
+        }
+
+        if (playing) feed();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+esp_err_t smf_player_init(void)
+{
+    ESP_RETURN_ON_ERROR(song_bank_init(), TAG, "No songs to play");
+
+    for (uint8_t i = 0; i < song_bank_count(); ++i)
+    {
+        const uint8_t *data;
+        size_t size;
+        song_bank_get(i, &data, &size);
+
+        smf_name(data, size, names[i], SMF_NAME_LEN);
+        if (names[i][0] == '\0') snprintf(names[i], SMF_NAME_LEN, "Song %d", i + 1);
+    }
+
+    BaseType_t task_created = xTaskCreatePinnedToCore(
+        player_task, "smf_player", PLAYER_TASK_STACK, NULL, PLAYER_TASK_PRIO, &player_task_handle, PLAYER_TASK_CORE);
+    ESP_RETURN_ON_FALSE(task_created == pdPASS, ESP_ERR_NO_MEM, TAG, "Failed to create player task");
+
+    ESP_LOGI(TAG, "Initialization succeeded");
+
+    return ESP_OK;
+}
+
+uint8_t smf_player_song_count(void) { return player_task_handle ? song_bank_count() : 0; }
+
+const char *smf_player_song_name(uint8_t index) { return index < song_bank_count() ? names[index] : ""; }
+
+esp_err_t smf_player_play(uint8_t index)
+{
+    ESP_RETURN_ON_FALSE(index < smf_player_song_count(), ESP_ERR_INVALID_ARG, TAG, "No song %d", (int)index);
+
+    xTaskNotify(player_task_handle, REQUEST_PLAY | index, eSetValueWithOverwrite);
+
+    return ESP_OK;
+}
+
+esp_err_t smf_player_stop(void)
+{
+    ESP_RETURN_ON_FALSE(player_task_handle, ESP_ERR_INVALID_STATE, TAG, "Player not initialized");
+
+    xTaskNotify(player_task_handle, REQUEST_STOP, eSetValueWithOverwrite);
+
+    return ESP_OK;
+}
+
+bool smf_player_is_playing(void) { return playing; }
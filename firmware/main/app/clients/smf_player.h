@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file smf_player.h
+ * @brief Standalone player for the MIDI files of the song bank
+ *
+ * A task reads the song a little ahead of the output and hands each event to
+ * the synth with the play clock sample it is due at, so timing does not
+ * depend on when the task gets to run. Progress is published on the event
+ * bus: a SMF_PLAYER_EVENT_BAR at each new bar (value is the bar, from 1) and
+ * SMF_PLAYER_EVENT_FINISHED at the end of the song.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef SMF_PLAYER_H
+#define SMF_PLAYER_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    SMF_PLAYER_EVENT_BAR,
+    SMF_PLAYER_EVENT_FINISHED
+} smf_player_event_t;
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+esp_err_t smf_player_init(void);
+uint8_t smf_player_song_count(void);
+const char *smf_player_song_name(uint8_t index);
+esp_err_t smf_player_play(uint8_t index);
+esp_err_t smf_player_stop(void);
+bool smf_player_is_playing(void);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !SMF_PLAYER_H */
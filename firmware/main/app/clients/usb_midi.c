@@ -18,9 +18,9 @@
 // -----------------------------------------------------------------------------
 #include "usb_midi.h"
 #include "core/event_bus.h"
+#include "dsp/note_table.h"
 #include "esp_check.h"
 #include "usb/usb_host.h"
-#include <math.h>
 #include <string.h>
 
 // -----------------------------------------------------------------------------
@@ -59,8 +59,6 @@ volatile bool transfer_active = false;
 static midi_on_receive_cb_t on_receive_cb = NULL;
 static char dev_name[32] = "NO NAME";
 
-const char *notes[12] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
-
 // -----------------------------------------------------------------------------
 // Static Function Declarations
 // -----------------------------------------------------------------------------
@@ -73,6 +71,8 @@ static void client_event_cb(const usb_host_client_event_msg_t *event_msg, void *
 // -----------------------------------------------------------------------------
 esp_err_t usb_midi_init(void)
 {
+    note_table_init();
+
     BaseType_t task_created = xTaskCreatePinnedToCore(
         usb_client_task, "usb_midi", CLIENT_TASK_STACK, NULL, CLIENT_TASK_PRIO, &client_task_handle, 0);
     ESP_RETURN_ON_FALSE(task_created == pdPASS, ESP_ERR_NO_MEM, TAG, "Failed to create USB MIDI client task");
@@ -93,9 +93,9 @@ midi_msg_parsed_t usb_midi_parse_msg(midi_message_t *msg)
     if (msg == NULL) return parsed_msg;
 
     parsed_msg.velocity = msg->velocity / 127.f;
-    parsed_msg.octave = -2 + msg->note / 12;
-    parsed_msg.freq_hz = 440.0f * powf(2.0f, (msg->note - 69) / 12.0f);
-    strncpy(parsed_msg.note, notes[msg->note % 12], sizeof(parsed_msg.note));
+    parsed_msg.octave = note_table_octave(msg->note);
+    parsed_msg.freq_hz = note_table_freq_hz(msg->note);
+    strncpy(parsed_msg.note, note_table_name(msg->note), sizeof(parsed_msg.note));
 
     return parsed_msg;
 }
@@ -108,19 +108,34 @@ static void midi_in_cb(usb_transfer_t *transfer)
     for (int i = 0; i < transfer->actual_num_bytes; i += 4)
     {
         uint8_t cin = transfer->data_buffer[i] & 0x0F;
+        uint8_t channel = transfer->data_buffer[i + 1] & 0x0F;
         uint8_t note = transfer->data_buffer[i + 2];
         uint8_t vel = transfer->data_buffer[i + 3];
 
-        midi_message_t msg = {.note = note};
+        midi_message_t msg = {.type = cin, .channel = channel, .note = note};
 
         switch (cin)
         {
-        case 0x9: // Note On
+        case MIDI_MSG_NOTE_ON:
+            // Note On with velocity 0 is a Note Off
+            msg.state = vel > 0;
+            msg.velocity = vel;
+            break;
+        case MIDI_MSG_NOTE_OFF:
+            break;
+        case MIDI_MSG_CONTROL_CHANGE:
+        case MIDI_MSG_PROGRAM_CHANGE:
+        case MIDI_MSG_PITCH_BEND:
             msg.state = 1;
             msg.velocity = vel;
             break;
-        default:
+        case MIDI_MSG_REALTIME:
+            // Clock, start, continue, stop; other single bytes are not used
+            if (transfer->data_buffer[i + 1] < 0xF8) continue;
+            msg.state = 1;
             break;
+        default:
+            continue;
         }
 
         if (on_receive_cb) on_receive_cb(msg);
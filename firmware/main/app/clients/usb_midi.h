@@ -43,8 +43,25 @@ typedef enum
     USB_MIDI_EVENT_DISCONNECTED
 } usb_midi_event_t;
 
+typedef enum
+{
+    MIDI_MSG_NOTE_OFF = 0x8,
+    MIDI_MSG_NOTE_ON = 0x9,
+    MIDI_MSG_CONTROL_CHANGE = 0xB,
+    MIDI_MSG_PROGRAM_CHANGE = 0xC,
+    MIDI_MSG_PITCH_BEND = 0xE,
+    MIDI_MSG_REALTIME = 0xF, // Single byte, low nibble of the status in channel
+} midi_msg_type_t;
+
+/*
+ * For note messages note/velocity hold the key and velocity, for other types
+ * they carry the first and second data bytes (e.g. controller number in note
+ * and its value in velocity).
+ */
 typedef struct
 {
+    uint8_t type: 4;
+    uint8_t channel: 4;
     uint8_t state: 1;
     uint8_t note: 7;
     uint8_t velocity;
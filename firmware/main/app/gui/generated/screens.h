@@ -24,6 +24,8 @@ typedef struct _objects_t {
     lv_obj_t *state_label;
     lv_obj_t *pd_arc;
     lv_obj_t *prf_arc;
+    lv_obj_t *bon_arc;
+    lv_obj_t *bof_arc;
     lv_obj_t *gdb_arc;
     lv_obj_t *pwr_arc;
     lv_obj_t *message_box;
@@ -46,6 +46,10 @@
 #error "CONFIG_INTERRUPTER_PRF_DEFAULT must be between PRF_MIN and PRF_MAX"
 #endif
 
+#if CONFIG_INTERRUPTER_BURST_ON_DEFAULT > CONFIG_INTERRUPTER_BURST_ON_MAX
+#error "CONFIG_INTERRUPTER_BURST_ON_DEFAULT must be <= CONFIG_INTERRUPTER_BURST_ON_MAX"
+#endif
+
 #define PD_MIN 0
 #define PD_DEFAULT CONFIG_INTERRUPTER_PD_DEFAULT
 #define PD_MAX CONFIG_INTERRUPTER_TON_MAX
@@ -66,6 +70,14 @@
 #define GAIN_MAX 50
 #define GAIN_STEP CONFIG_INTERRUPTER_GAIN_STEP
 
+#define BURST_ON_MIN 1
+#define BURST_ON_DEFAULT CONFIG_INTERRUPTER_BURST_ON_DEFAULT
+#define BURST_ON_MAX CONFIG_INTERRUPTER_BURST_ON_MAX
+#define BURST_OFF_MIN 0 // Continuous
+#define BURST_OFF_DEFAULT 0
+#define BURST_OFF_MAX CONFIG_INTERRUPTER_BURST_OFF_MAX
+#define BURST_STEP CONFIG_INTERRUPTER_BURST_STEP
+
 #define INIT_KNOB(knob, type_val, arc_obj, min_val, max_val, value_val, step0_val, step1_val)                          \
     do                                                                                                                 \
     {                                                                                                                  \
@@ -101,7 +113,7 @@ typedef struct
     uint16_t steps[2];
 } knob_data_t;
 
-knob_data_t prf, pd, pwr, gdb;
+knob_data_t prf, pd, pwr, gdb, bon, bof;
 knob_data_t *all[KNOB_COUNT];
 knob_t *knobs_pub[KNOB_COUNT] = {NULL};
 
@@ -132,6 +144,10 @@ esp_err_t knobs_init(void)
     INIT_KNOB(pwr, KNOB_PWR, objects.pwr_arc, POWER_MIN, POWER_MAX, POWER_DEFAULT, 1, 10);
     /* Gain Range */
     INIT_KNOB(gdb, KNOB_GDB, objects.gdb_arc, GAIN_MIN, GAIN_MAX, GAIN_DEFAULT, 5, 10);
+    /* Burst On Time Range */
+    INIT_KNOB(bon, KNOB_BON, objects.bon_arc, BURST_ON_MIN, BURST_ON_MAX, BURST_ON_DEFAULT, 1, BURST_STEP);
+    /* Burst Off Time Range */
+    INIT_KNOB(bof, KNOB_BOF, objects.bof_arc, BURST_OFF_MIN, BURST_OFF_MAX, BURST_OFF_DEFAULT, 1, BURST_STEP);
 
     // Common assignations
     for (int i = 0; i < KNOB_COUNT; ++i)
@@ -42,6 +42,8 @@ typedef enum
     KNOB_PRF,
     KNOB_PWR,
     KNOB_GDB,
+    KNOB_BON,
+    KNOB_BOF,
     KNOB_COUNT
 } knob_name_t;
 
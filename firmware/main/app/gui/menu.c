@@ -179,6 +179,8 @@ esp_err_t menu_set_mode(menu_mode_t m, bool msg_box)
         // Display the corresponding knobs
         lv_obj_clear_flag(objects.pd_arc, LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(objects.prf_arc, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_flag(objects.bon_arc, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_flag(objects.bof_arc, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(objects.pwr_arc, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(objects.gdb_arc, LV_OBJ_FLAG_HIDDEN);
 
@@ -196,6 +198,8 @@ esp_err_t menu_set_mode(menu_mode_t m, bool msg_box)
         // Display the corresponding knobs
         lv_obj_add_flag(objects.pd_arc, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(objects.prf_arc, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(objects.bon_arc, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(objects.bof_arc, LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(objects.pwr_arc, LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(objects.gdb_arc, LV_OBJ_FLAG_HIDDEN);
 
@@ -213,6 +217,8 @@ esp_err_t menu_set_mode(menu_mode_t m, bool msg_box)
         // Display the corresponding knobs
         lv_obj_add_flag(objects.pd_arc, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(objects.prf_arc, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(objects.bon_arc, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(objects.bof_arc, LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(objects.pwr_arc, LV_OBJ_FLAG_HIDDEN);
         lv_obj_add_flag(objects.gdb_arc, LV_OBJ_FLAG_HIDDEN);
 
@@ -221,6 +227,23 @@ esp_err_t menu_set_mode(menu_mode_t m, bool msg_box)
         // Display message bow
         if (msg_box) menu_display_msg_box("MIDI mode", 1000);
         break;
+    case MENU_MODE_PLAYER:
+        // Same knobs as MIDI, the header shows the song
+        lv_label_set_text(objects.aux_type_label, "SONG");
+        lv_obj_clear_flag(objects.aux_icon, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_flag(objects.aux_type_label, LV_OBJ_FLAG_HIDDEN);
+
+        lv_obj_add_flag(objects.pd_arc, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(objects.prf_arc, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(objects.bon_arc, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(objects.bof_arc, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_flag(objects.pwr_arc, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(objects.gdb_arc, LV_OBJ_FLAG_HIDDEN);
+
+        lv_group_focus_obj(objects.pwr_arc);
+
+        if (msg_box) menu_display_msg_box("Player mode", 1000);
+        break;
     default:
         break;
     }
@@ -232,6 +255,16 @@ esp_err_t menu_set_mode(menu_mode_t m, bool msg_box)
 
 inline menu_mode_t menu_get_mode(void) { return mode; }
 
+bool menu_is_editing(void)
+{
+    lvgl_port_lock(0);
+    lv_group_t *group = lv_group_get_default();
+    bool editing = group && lv_group_get_editing(group);
+    lvgl_port_unlock();
+
+    return editing;
+}
+
 inline esp_err_t menu_set_state(menu_state_t s)
 {
     state = s;
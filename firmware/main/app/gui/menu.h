@@ -41,7 +41,8 @@ typedef enum
 {
     MENU_MODE_MANUAL,
     MENU_MODE_AUDIO_JACK,
-    MENU_MODE_MIDI
+    MENU_MODE_MIDI,
+    MENU_MODE_PLAYER
 } menu_mode_t;
 
 typedef enum
@@ -62,6 +63,7 @@ typedef uint8_t menu_state_mask_t;
 esp_err_t menu_init(void);
 esp_err_t menu_set_mode(menu_mode_t m, bool msg_box);
 menu_mode_t menu_get_mode(void);
+bool menu_is_editing(void);
 esp_err_t menu_set_state(menu_state_t s);
 void menu_set_header_text(const char *text);
 void menu_display_msg_box(const char *msg, uint16_t duration_ms);
@@ -16,6 +16,7 @@
 // -----------------------------------------------------------------------------
 // Includes
 // -----------------------------------------------------------------------------
+#include "app/clients/smf_player.h"
 #include "app/clients/usb_midi.h"
 #include "app/gui/knobs.h"
 #include "clients/usb_midi.h"
@@ -30,6 +31,7 @@
 #include "hal/pwm.h"
 #include "hal/synth.h"
 #include "hal/usb.h"
+#include <stdio.h>
 
 // -----------------------------------------------------------------------------
 // Macros and Constants
@@ -42,9 +44,19 @@
         if (ret != ESP_OK) return;                                                                                     \
     }
 
+#define PLAYER_EXIT (-1) // Selection before the first song leaves the player
+
+// Output stage the synth plays through, in MIDI and player modes
+#if CONFIG_INTERRUPTER_SYNTH_OUTPUT_PULSES
+#define SYNTH_PWM_MODE PWM_MODE_PULSES
+#else
+#define SYNTH_PWM_MODE PWM_MODE_MODULATION
+#endif
+
 // -----------------------------------------------------------------------------
 // Static Variables
 // -----------------------------------------------------------------------------
+static int8_t song = 0;
 
 // -----------------------------------------------------------------------------
 // Static Function Declarations
@@ -57,13 +69,34 @@ static void midi_on_receive_cb(midi_message_t msg)
 {
     if (menu_get_mode() != MENU_MODE_MIDI) return;
 
+    if (msg.type == MIDI_MSG_PROGRAM_CHANGE)
+    {
+        synth_set_program(msg.channel, msg.note);
+        return;
+    }
+    if (msg.type == MIDI_MSG_CONTROL_CHANGE)
+    {
+        synth_control_change(msg.channel, msg.note, msg.velocity);
+        return;
+    }
+    if (msg.type == MIDI_MSG_PITCH_BEND)
+    {
+        synth_pitch_bend(msg.channel, msg.note, msg.velocity);
+        return;
+    }
+    if (msg.type == MIDI_MSG_REALTIME)
+    {
+        synth_realtime(0xF0 | msg.channel);
+        return;
+    }
+
     static synth_note_t synth_note = {0};
     synth_note.note = msg.note % 12;
     synth_note.octave = -2 + msg.note / 12;
 
     if (msg.state == 1)
     {
-        synth_play_note(synth_note);
+        synth_play_note(synth_note, msg.channel, msg.velocity);
 
         midi_msg_parsed_t parsed_msg = usb_midi_parse_msg(&msg);
 
@@ -73,15 +106,80 @@ static void midi_on_receive_cb(midi_message_t msg)
     }
     else
     {
-        synth_stop_note(synth_note);
+        synth_stop_note(synth_note, msg.channel);
+        menu_set_header_text("");
+    }
+}
+
+static void show_song(uint32_t bar)
+{
+    char header[16];
+
+    if (song == PLAYER_EXIT)
+        snprintf(header, sizeof(header), "< Manual");
+    else if (bar)
+        snprintf(header, sizeof(header), "%.10s %lu", smf_player_song_name(song), (unsigned long)bar);
+    else
+        snprintf(header, sizeof(header), "%s", smf_player_song_name(song));
+
+    menu_set_header_text(header);
+}
+
+/**
+ * @brief Encoder in player mode, while the power knob is not being edited
+ *
+ * Turning selects a song, a long press plays or stops it. The entry before
+ * the first song goes back to manual mode.
+ */
+static void player_on_encoder(const event_t *e)
+{
+    if (e->type == CONTROLS_EVENT_RE_CHANGED)
+    {
+        int next = song + (int32_t)e->value;
+        if (next < PLAYER_EXIT) next = PLAYER_EXIT;
+        if (next >= smf_player_song_count()) next = smf_player_song_count() - 1;
+        song = next;
+        show_song(0);
+    }
+    else if (song == PLAYER_EXIT)
+    {
+        ESP_LOGI(TAG, "Manual mode");
+        smf_player_stop();
+        menu_set_mode(MENU_MODE_MANUAL, true);
         menu_set_header_text("");
+        synth_disable();
+        pwm_set_mode(PWM_MODE_MANUAL);
+    }
+    else if (smf_player_is_playing())
+    {
+        smf_player_stop();
+        show_song(0);
+    }
+    else
+    {
+        smf_player_play(song);
     }
 }
 
+/**
+ * @brief Pulse width of a full velocity note, the power knob over the allowed range
+ */
+static uint16_t power_to_pulse_width(const knob_t *power)
+{
+    return (uint32_t)CONFIG_INTERRUPTER_TON_MAX * power->value / power->max_physical;
+}
+
 static void knobs_on_change_cb(knobs_mask_t updated, const knob_t *knobs[])
 {
     static float prf = 0;
     static uint16_t pd = 0;
+    static uint16_t bon = 0;
+    static uint16_t bof = 0;
+
+    if (updated & (1 << KNOB_PWR))
+    {
+        synth_set_pulse_width(power_to_pulse_width(knobs[KNOB_PWR]));
+    }
 
     if (updated & (1 << KNOB_PRF))
     {
@@ -91,9 +189,17 @@ static void knobs_on_change_cb(knobs_mask_t updated, const knob_t *knobs[])
     {
         pd = knobs[KNOB_PD]->value;
     }
+    if (updated & (1 << KNOB_BON))
+    {
+        bon = knobs[KNOB_BON]->value;
+    }
+    if (updated & (1 << KNOB_BOF))
+    {
+        bof = knobs[KNOB_BOF]->value;
+    }
 
-    ESP_LOGI(TAG, "prf=%d, pd=%d", (int)prf, (int)pd);
-    pwm_manual_update(prf, pd);
+    ESP_LOGI(TAG, "prf=%d, pd=%d, bon=%d, bof=%d", (int)prf, (int)pd, (int)bon, (int)bof);
+    pwm_manual_update(prf, pd, bon, bof);
 }
 
 static IRAM_ATTR void audio_jack_out_cb(uint16_t value)
@@ -122,23 +228,24 @@ static IRAM_ATTR void audio_jack_out_cb(uint16_t value)
     if (val < 0) val = 0;
     if (val > AUDIO_JACK_OUT_MAX) val = AUDIO_JACK_OUT_MAX;
 
-    // Convert to PWM duty (uint8_t) and apply power knob
-    uint32_t dt = (uint32_t)val * PWM_MOD_DUTY_MAX / AUDIO_JACK_OUT_MAX;
-    dt = dt * knobs[KNOB_PWR]->value / knobs[KNOB_PWR]->max_physical;
-
-    // Update PWM
-    pwm_modulation_update((uint8_t)(dt / 2));
+    // Convert to PWM duty, apply power knob and update PWM
+    pwm_modulation_update(
+        pwm_modulation_duty(val, AUDIO_JACK_OUT_MAX, knobs[KNOB_PWR]->value, knobs[KNOB_PWR]->max_physical));
 }
 
+#if CONFIG_INTERRUPTER_SYNTH_OUTPUT_PULSES
+// A pulse the full queue refuses is counted by the PWM and logged when it stops
+static void synth_on_pulse_cb(const pulse_t *pulse) { (void)pwm_pulse_push(pulse); }
+#else
 static IRAM_ATTR void synth_on_sampling_cb(uint16_t value)
 {
     const knob_t *knobs[KNOB_COUNT];
     knobs_get_values(knobs);
 
-    uint32_t dt = (uint32_t)value * PWM_MOD_DUTY_MAX / SYNTH_OUT_MAX;
-    dt = dt * knobs[KNOB_PWR]->value / knobs[KNOB_PWR]->max_physical;
-    pwm_modulation_update((uint8_t)(dt / 2));
+    pwm_modulation_update(
+        pwm_modulation_duty(value, SYNTH_OUT_MAX, knobs[KNOB_PWR]->value, knobs[KNOB_PWR]->max_physical));
 }
+#endif
 
 // -----------------------------------------------------------------------------
 // Function Definitions
@@ -200,7 +307,18 @@ void app_main(void)
         usb_midi_set_on_receive_cb(midi_on_receive_cb);
 
         RETURN_ON_ERROR(synth_init());
+#if CONFIG_INTERRUPTER_SYNTH_OUTPUT_PULSES
+        const knob_t *knobs[KNOB_COUNT];
+        knobs_get_values(knobs);
+        synth_set_pulse_width(power_to_pulse_width(knobs[KNOB_PWR]));
+        synth_set_on_pulse_cb(synth_on_pulse_cb);
+        synth_set_output(SYNTH_OUTPUT_PULSES);
+#else
         synth_set_on_sampling_cb(synth_on_sampling_cb);
+#endif
+
+        // Optional, the player mode is only offered with songs in flash
+        if (smf_player_init() != ESP_OK) ESP_LOGW(TAG, "MIDI file player disabled");
     }
 
     event_t e;
@@ -222,6 +340,24 @@ void app_main(void)
                 menu_set_state(MENU_STATE_IDLE);
                 pwm_disable();
                 break;
+            case CONTROLS_EVENT_RE_BTN_LONG_PRESSED:
+                if (menu_is_editing()) break;
+                if (menu_get_mode() == MENU_MODE_PLAYER)
+                {
+                    player_on_encoder(&e);
+                }
+                else if (menu_get_mode() == MENU_MODE_MANUAL && smf_player_song_count() > 0)
+                {
+                    ESP_LOGI(TAG, "Player mode");
+                    menu_set_mode(MENU_MODE_PLAYER, true);
+                    pwm_set_mode(SYNTH_PWM_MODE);
+                    synth_enable();
+                    show_song(0);
+                }
+                break;
+            case CONTROLS_EVENT_RE_CHANGED:
+                if (menu_get_mode() == MENU_MODE_PLAYER && !menu_is_editing()) player_on_encoder(&e);
+                break;
             default:
                 break;
             }
@@ -256,7 +392,7 @@ void app_main(void)
                 if (menu_get_mode() != MENU_MODE_MANUAL) break;
                 ESP_LOGI(TAG, "MIDI mode");
                 menu_set_mode(MENU_MODE_MIDI, true);
-                pwm_set_mode(PWM_MODE_MODULATION);
+                pwm_set_mode(SYNTH_PWM_MODE);
                 synth_enable();
                 break;
             case USB_MIDI_EVENT_DISCONNECTED:
@@ -270,6 +406,11 @@ void app_main(void)
                 break;
             }
         }
+        else if (e.source == EVENT_SRC_SMF_PLAYER)
+        {
+            if (menu_get_mode() != MENU_MODE_PLAYER) continue;
+            show_song(e.type == SMF_PLAYER_EVENT_BAR ? e.value : 0);
+        }
     }
 
     ESP_LOGI(TAG, "Firmware exited");
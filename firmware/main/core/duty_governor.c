@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file duty_governor.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "duty_governor.h"
+#include "esp_attr.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define RING_LEN (DUTY_GOVERNOR_BUCKETS + 2)
+#define DUTY_ONE (256) // Modulation duty of a fully on sample
+
+// A charge lands in the bucket it starts in, a bucket at least as long as
+// a pulse or sample keeps the extra buckets enough to cover its tail
+_Static_assert(DUTY_GOVERNOR_SHORT_US / DUTY_GOVERNOR_BUCKETS >= CONFIG_INTERRUPTER_TON_MAX,
+    "Short window buckets must be longer than a pulse");
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const uint32_t window_us[DUTY_GOVERNOR_WINDOW_COUNT] = {DUTY_GOVERNOR_SHORT_US, DUTY_GOVERNOR_LONG_US};
+static const uint32_t budget_pct[DUTY_GOVERNOR_WINDOW_COUNT] = {DUTY_GOVERNOR_SHORT_PCT, DUTY_GOVERNOR_LONG_PCT};
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static IRAM_ATTR void advance_window(duty_window_t *w, uint32_t now)
+{
+    int32_t elapsed = (int32_t)(now - w->head_start);
+    if (elapsed < (int32_t)w->bucket_len) return;
+
+    if (elapsed >= (int32_t)(RING_LEN * w->bucket_len))
+    {
+        // Idle for longer than the window
+        memset(w->sums, 0, sizeof(w->sums));
+        w->total = 0;
+        w->head_start = now;
+        return;
+    }
+
+    do
+    {
+        w->head = (w->head + 1) % RING_LEN;
+        w->total -= w->sums[w->head];
+        w->sums[w->head] = 0;
+        w->head_start += w->bucket_len;
+        elapsed -= w->bucket_len;
+    } while (elapsed >= (int32_t)w->bucket_len);
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void duty_governor_init(duty_governor_t *gov, uint32_t now)
+{
+    memset(gov, 0, sizeof(*gov));
+
+    for (int i = 0; i < DUTY_GOVERNOR_WINDOW_COUNT; ++i)
+    {
+        duty_window_t *w = &gov->windows[i];
+        w->bucket_len = window_us[i] / DUTY_GOVERNOR_BUCKETS * DUTY_GOVERNOR_UNITS_PER_US;
+        w->budget = window_us[i] / 100 * budget_pct[i] * DUTY_GOVERNOR_UNITS_PER_US;
+        w->head_start = now;
+    }
+}
+
+/**
+ * @brief Move to another clock, the on-time already counted is kept
+ *
+ * The change is taken as instantaneous, so switching outputs does not clear
+ * the budget.
+ */
+void duty_governor_restart(duty_governor_t *gov, uint32_t now)
+{
+    for (int i = 0; i < DUTY_GOVERNOR_WINDOW_COUNT; ++i) gov->windows[i].head_start = now;
+}
+
+IRAM_ATTR void duty_governor_advance(duty_governor_t *gov, uint32_t now)
+{
+    for (int i = 0; i < DUTY_GOVERNOR_WINDOW_COUNT; ++i) advance_window(&gov->windows[i], now);
+}
+
+/**
+ * @brief On-time that can still be spent at the given time
+ */
+IRAM_ATTR uint32_t duty_governor_room(duty_governor_t *gov, uint32_t now)
+{
+    uint32_t room = UINT32_MAX;
+
+    for (int i = 0; i < DUTY_GOVERNOR_WINDOW_COUNT; ++i)
+    {
+        duty_window_t *w = &gov->windows[i];
+        advance_window(w, now);
+        uint32_t left = w->total < w->budget ? w->budget - w->total : 0;
+        if (left < room) room = left;
+    }
+
+    return room;
+}
+
+/**
+ * @brief Count on-time at the time of the last duty_governor_room()
+ */
+IRAM_ATTR void duty_governor_charge(duty_governor_t *gov, uint32_t on)
+{
+    for (int i = 0; i < DUTY_GOVERNOR_WINDOW_COUNT; ++i)
+    {
+        duty_window_t *w = &gov->windows[i];
+        w->sums[w->head] += on;
+        w->total += on;
+    }
+}
+
+/**
+ * @brief Width a pulse may have, 0 to leave it out
+ *
+ * A pulse is cut to the budget left, or left out if that is under the
+ * shortest width allowed.
+ */
+IRAM_ATTR uint16_t duty_governor_pulse(duty_governor_t *gov, uint32_t start_us, uint16_t width_us, uint16_t width_min_us)
+{
+    uint32_t room = duty_governor_room(gov, start_us * DUTY_GOVERNOR_UNITS_PER_US) / DUTY_GOVERNOR_UNITS_PER_US;
+    uint16_t width = width_us < room ? width_us : room;
+
+    if (width < width_min_us || width == 0)
+    {
+        gov->dropped++;
+        return 0;
+    }
+
+    if (width < width_us) gov->scaled++;
+    duty_governor_charge(gov, (uint32_t)width * DUTY_GOVERNOR_UNITS_PER_US);
+
+    return width;
+}
+
+/**
+ * @brief Modulation duty (out of 256) a sample starting at the given time may have
+ *
+ * On-times are rounded up so the budget holds for any sample length.
+ */
+IRAM_ATTR uint8_t duty_governor_duty(duty_governor_t *gov, uint32_t now, uint8_t duty, uint32_t sample_len)
+{
+    uint32_t on = (duty * sample_len + DUTY_ONE - 1) / DUTY_ONE;
+    uint32_t room = duty_governor_room(gov, now);
+
+    if (on > room)
+    {
+        duty = room * DUTY_ONE / sample_len;
+        on = (duty * sample_len + DUTY_ONE - 1) / DUTY_ONE;
+        if (on > room) on = room; // Floored duty fits, only the rounding is over
+        gov->scaled++;
+    }
+
+    duty_governor_charge(gov, on);
+
+    return duty;
+}
+
+/**
+ * @brief Widest pulse of a train within every budget
+ *
+ * For outputs timed by hardware alone: a window holds at most one pulse
+ * more than it spans periods, and at most one burst more than it spans
+ * burst cycles. Pass 0 burst pulses for a continuous train.
+ */
+uint32_t duty_governor_train_width(uint32_t period_us, uint32_t burst_pulses, uint32_t burst_cycle_us)
+{
+    uint32_t width = UINT32_MAX;
+    if (period_us == 0 || (burst_pulses && burst_cycle_us == 0)) return 0;
+
+    for (int i = 0; i < DUTY_GOVERNOR_WINDOW_COUNT; ++i)
+    {
+        uint32_t budget_us = window_us[i] / 100 * budget_pct[i];
+        uint64_t pulses = window_us[i] / period_us + 1;
+        if (burst_pulses)
+        {
+            uint64_t burst_bound = (uint64_t)(window_us[i] / burst_cycle_us + 1) * burst_pulses;
+            if (burst_bound < pulses) pulses = burst_bound;
+        }
+
+        uint32_t w = budget_us / pulses;
+        if (w < width) width = w;
+    }
+
+    return width;
+}
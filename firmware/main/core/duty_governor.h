@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file duty_governor.h
+ * @brief Rolling-window on-time budget of the coil
+ *
+ * On-time is summed over a short and a long sliding window, each kept as a
+ * ring of buckets so both the check and the accounting are O(1) per pulse
+ * or sample. A window sums one to two buckets more than its length, so a
+ * pulse straddling its start is still counted whole and the budget holds
+ * over every real window, at the price of some extra caution.
+ *
+ * Times and on-times are in DUTY_GOVERNOR_UNITS_PER_US units of a us, on
+ * the caller's clock, and may wrap. The clock must be advanced at least
+ * every minute or so.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef DUTY_GOVERNOR_H
+#define DUTY_GOVERNOR_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "sdkconfig.h"
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define DUTY_GOVERNOR_UNITS_PER_US (16)     // Fine enough for the on-time of a sample at any rate
+#define DUTY_GOVERNOR_BUCKETS (16)          // Per window
+#define DUTY_GOVERNOR_SHORT_US (10000)
+#define DUTY_GOVERNOR_LONG_US (1000000)
+#define DUTY_GOVERNOR_SHORT_PCT CONFIG_INTERRUPTER_DUTY_SHORT_PCT
+#define DUTY_GOVERNOR_LONG_PCT CONFIG_INTERRUPTER_DUTY_LONG_PCT
+
+// Length of a sample in governor units, rounded up so no on-time is missed
+#define DUTY_GOVERNOR_SAMPLE_LEN(rate_hz) ((1000000 * DUTY_GOVERNOR_UNITS_PER_US + (rate_hz) - 1) / (rate_hz))
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    DUTY_GOVERNOR_SHORT = 0,
+    DUTY_GOVERNOR_LONG,
+    DUTY_GOVERNOR_WINDOW_COUNT
+} duty_governor_window_t;
+
+typedef struct
+{
+    uint32_t bucket_len;
+    uint32_t budget;
+    uint32_t head_start;  // Time the current bucket began
+    uint32_t total;       // Sum of all buckets
+    uint8_t head;
+    uint32_t sums[DUTY_GOVERNOR_BUCKETS + 2];
+} duty_window_t;
+
+typedef struct
+{
+    duty_window_t windows[DUTY_GOVERNOR_WINDOW_COUNT];
+    uint32_t scaled;   // Pulses or samples cut down to the budget left
+    uint32_t dropped;  // Pulses left out, the budget left was too short
+} duty_governor_t;
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void duty_governor_init(duty_governor_t *gov, uint32_t now);
+void duty_governor_restart(duty_governor_t *gov, uint32_t now);
+void duty_governor_advance(duty_governor_t *gov, uint32_t now);
+uint32_t duty_governor_room(duty_governor_t *gov, uint32_t now);
+void duty_governor_charge(duty_governor_t *gov, uint32_t on);
+uint16_t duty_governor_pulse(duty_governor_t *gov, uint32_t start_us, uint16_t width_us, uint16_t width_min_us);
+uint8_t duty_governor_duty(duty_governor_t *gov, uint32_t now, uint8_t duty, uint32_t sample_len);
+uint32_t duty_governor_train_width(uint32_t period_us, uint32_t burst_pulses, uint32_t burst_cycle_us);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !DUTY_GOVERNOR_H */
@@ -41,6 +41,7 @@ typedef enum
     EVENT_SRC_CONTROLS,
     EVENT_SRC_USB_MIDI,
     EVENT_SRC_AUDIO_JACK,
+    EVENT_SRC_SMF_PLAYER,
     EVENT_SRC_COUNT
 } event_source_t;
 
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file pulse_pattern.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "pulse_pattern.h"
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define HALF_MAX PULSE_PATTERN_DURATION_MAX
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief Low symbols needed after a pulse symbol, for a low time of the given length
+ */
+static inline uint32_t fill_count(uint32_t low)
+{
+    return low <= HALF_MAX ? 0 : (low - HALF_MAX + 2 * HALF_MAX - 1) / (2 * HALF_MAX);
+}
+
+/**
+ * @brief Low time after the last pulse of a burst, up to the next burst
+ */
+static inline uint32_t burst_tail(const pulse_pattern_t *pattern)
+{
+    return pattern->burst_cycle - (pattern->burst_pulses - 1) * pattern->period - pattern->width;
+}
+
+/**
+ * @brief A pulse and the low time after it, spread evenly over the low halves
+ */
+static size_t encode_pulse(pulse_symbol_t *symbols, uint32_t width, uint32_t low)
+{
+    uint32_t fills = fill_count(low);
+    uint32_t halves = 1 + 2 * fills;
+    uint32_t base = low / halves;
+    uint32_t extra = low % halves;
+
+    for (uint32_t i = 0; i < halves; ++i)
+    {
+        uint16_t duration = base + (i < extra);
+
+        if (i == 0)
+            symbols[0] = (pulse_symbol_t){.duration0 = width, .level0 = 1, .duration1 = duration};
+        else if (i % 2)
+            symbols[(i + 1) / 2] = (pulse_symbol_t){.duration0 = duration, .level0 = 0};
+        else
+            symbols[i / 2].duration1 = duration;
+    }
+
+    return 1 + fills;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief Pattern of the manual output settings
+ *
+ * The period is rounded to whole ticks and the width kept a tick under it. A
+ * burst holds every pulse starting within its on time, at least one, and
+ * never starts less than a period after the last pulse of the one before.
+ * A burst off time of 0 gives a continuous train.
+ */
+esp_err_t pulse_pattern_make(
+    pulse_pattern_t *pattern, float freq_hz, uint32_t width_us, uint32_t burst_on_ms, uint32_t burst_off_ms)
+{
+    if (freq_hz < PULSE_PATTERN_FREQ_MIN_HZ || width_us == 0) return ESP_ERR_INVALID_ARG;
+
+    uint32_t period = (uint32_t)(1.e6 / freq_hz + 0.5);
+    if (period < 2) return ESP_ERR_INVALID_ARG;
+
+    uint32_t width = width_us < period ? width_us : period - 1;
+    if (width > HALF_MAX) width = HALF_MAX;
+
+    *pattern = (pulse_pattern_t){.period = period, .width = width, .burst_pulses = 0, .burst_cycle = period};
+    if (burst_off_ms == 0) return ESP_OK;
+
+    uint32_t on = burst_on_ms * 1000;
+    uint32_t pulses = (on + period - 1) / period;
+    if (pulses == 0) pulses = 1;
+
+    uint32_t cycle = on + burst_off_ms * 1000;
+    if (cycle < pulses * period) cycle = pulses * period;
+
+    pattern->burst_pulses = pulses;
+    pattern->burst_cycle = cycle;
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Symbols of one cycle of the pattern
+ */
+size_t pulse_pattern_symbol_count(const pulse_pattern_t *pattern)
+{
+    uint32_t per_pulse = 1 + fill_count(pattern->period - pattern->width);
+    if (pattern->burst_pulses == 0) return per_pulse;
+
+    return (size_t)(pattern->burst_pulses - 1) * per_pulse + 1 + fill_count(burst_tail(pattern));
+}
+
+/**
+ * @brief Cut bursts to the pulses that fit in the given symbols
+ *
+ * Bursts keep their cycle and end early. False if even one pulse per cycle
+ * does not fit.
+ */
+bool pulse_pattern_fit(pulse_pattern_t *pattern, size_t max_symbols)
+{
+    if (pulse_pattern_symbol_count(pattern) <= max_symbols) return true;
+    if (pattern->burst_pulses == 0) return false;
+
+    // Close from below, the last pulse needs more symbols as the tail grows
+    uint32_t per_pulse = 1 + fill_count(pattern->period - pattern->width);
+    uint32_t pulses = max_symbols / per_pulse;
+    if (pulses > pattern->burst_pulses) pulses = pattern->burst_pulses;
+    if (pulses == 0) pulses = 1;
+
+    pattern->burst_pulses = pulses;
+    while (pattern->burst_pulses > 1 && pulse_pattern_symbol_count(pattern) > max_symbols) pattern->burst_pulses--;
+
+    return pulse_pattern_symbol_count(pattern) <= max_symbols;
+}
+
+/**
+ * @brief Symbols of one cycle, to be replayed in a loop
+ */
+esp_err_t pulse_pattern_encode(const pulse_pattern_t *pattern, pulse_symbol_t *symbols, size_t max_symbols, size_t *len)
+{
+    if (pattern->width == 0 || pattern->width >= pattern->period || pattern->width > HALF_MAX)
+        return ESP_ERR_INVALID_ARG;
+    if (pulse_pattern_symbol_count(pattern) > max_symbols) return ESP_ERR_INVALID_SIZE;
+
+    size_t n = 0;
+    if (pattern->burst_pulses == 0)
+    {
+        n = encode_pulse(symbols, pattern->width, pattern->period - pattern->width);
+    }
+    else
+    {
+        for (uint32_t i = 0; i + 1 < pattern->burst_pulses; ++i)
+            n += encode_pulse(&symbols[n], pattern->width, pattern->period - pattern->width);
+        n += encode_pulse(&symbols[n], pattern->width, burst_tail(pattern));
+    }
+
+    *len = n;
+
+    return ESP_OK;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file pulse_pattern.h
+ * @brief Manual output timing, encoded as symbols a looping RMT replays
+ *
+ * A pattern is a pulse train at the given repetition frequency, optionally
+ * gated into bursts: pulses start every period while the burst is on, then
+ * nothing until the next burst. One burst cycle is encoded as symbols, each
+ * a first half at either level and a low second half, like an RMT item, so
+ * the output repeats it with no CPU at all. Low times longer than a half
+ * symbol are split over as many low symbols as needed.
+ *
+ * Times are in ticks of 1 us.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef PULSE_PATTERN_H
+#define PULSE_PATTERN_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define PULSE_PATTERN_DURATION_MAX (32767) // Per half symbol, 15 bits
+#define PULSE_PATTERN_FREQ_MIN_HZ (0.1f)
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t duration0;
+    uint8_t level0;
+    uint16_t duration1; // Always low
+} pulse_symbol_t;
+
+typedef struct
+{
+    uint32_t period;        // Between pulse starts
+    uint32_t width;
+    uint32_t burst_pulses;  // Per burst, 0 for a continuous train
+    uint32_t burst_cycle;   // Between burst starts
+} pulse_pattern_t;
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+esp_err_t pulse_pattern_make(
+    pulse_pattern_t *pattern, float freq_hz, uint32_t width_us, uint32_t burst_on_ms, uint32_t burst_off_ms);
+size_t pulse_pattern_symbol_count(const pulse_pattern_t *pattern);
+bool pulse_pattern_fit(pulse_pattern_t *pattern, size_t max_symbols);
+esp_err_t pulse_pattern_encode(const pulse_pattern_t *pattern, pulse_symbol_t *symbols, size_t max_symbols, size_t *len);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !PULSE_PATTERN_H */
@@ -0,0 +1,405 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file smf.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "smf.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define CHUNK_HEADER_LEN 8
+#define HEADER_LEN 6
+#define DELTA_CHUNK 0xFFFF // Ticks converted at once, keeps the product in 64 bits
+
+#define META_TRACK_NAME 0x03
+#define META_END_OF_TRACK 0x2F
+#define META_TEMPO 0x51
+#define META_TIME_SIGNATURE 0x58
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    EVENT_CHANNEL = 0,
+    EVENT_META,
+    EVENT_SYSEX,
+    EVENT_ERROR
+} event_kind_t;
+
+typedef struct
+{
+    uint8_t type;
+    uint32_t len;
+    const uint8_t *data;
+} meta_t;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static inline uint32_t read_be32(const uint8_t *p) { return (uint32_t)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3]; }
+
+static inline uint16_t read_be16(const uint8_t *p) { return p[0] << 8 | p[1]; }
+
+static bool read_varlen(smf_track_t *track, uint32_t *value)
+{
+    uint32_t v = 0;
+
+    for (int i = 0; i < 4 && track->pos < track->end; ++i)
+    {
+        uint8_t b = *track->pos++;
+        v = v << 7 | (b & 0x7F);
+        if (!(b & 0x80))
+        {
+            *value = v;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Decode the event at the track cursor and move past it
+ */
+static event_kind_t read_event(smf_track_t *track, smf_event_t *event, meta_t *meta)
+{
+    if (track->pos >= track->end) return EVENT_ERROR;
+
+    uint8_t status = *track->pos;
+    if (status & 0x80)
+        track->pos++;
+    else if (track->running_status)
+        status = track->running_status;
+    else
+        return EVENT_ERROR;
+
+    if (status < 0xF0)
+    {
+        size_t len = (status & 0xE0) == 0xC0 ? 1 : 2; // Program change and channel pressure
+        if ((size_t)(track->end - track->pos) < len) return EVENT_ERROR;
+
+        track->running_status = status;
+        event->status = status;
+        event->data1 = track->pos[0] & 0x7F;
+        event->data2 = len == 2 ? track->pos[1] & 0x7F : 0;
+        track->pos += len;
+        return EVENT_CHANNEL;
+    }
+
+    // System messages cancel the running status
+    track->running_status = 0;
+
+    uint32_t len = 0;
+    if (status == 0xFF)
+    {
+        if (track->pos >= track->end) return EVENT_ERROR;
+        meta->type = *track->pos++;
+    }
+    else if (status != 0xF0 && status != 0xF7)
+    {
+        return EVENT_ERROR;
+    }
+
+    if (!read_varlen(track, &len) || len > (uint32_t)(track->end - track->pos)) return EVENT_ERROR;
+
+    meta->len = len;
+    meta->data = track->pos;
+    track->pos += len;
+
+    return status == 0xFF ? EVENT_META : EVENT_SYSEX;
+}
+
+static inline bool heap_less(const smf_t *smf, uint8_t a, uint8_t b)
+{
+    // Ties go to the lower track so type 1 files merge in a stable order
+    uint32_t ta = smf->tracks[a].tick;
+    uint32_t tb = smf->tracks[b].tick;
+    return ta < tb || (ta == tb && a < b);
+}
+
+static void heap_sift_down(smf_t *smf, uint8_t i)
+{
+    uint8_t *heap = smf->heap;
+
+    while (1)
+    {
+        uint8_t smallest = i;
+        uint8_t l = 2 * i + 1;
+        uint8_t r = l + 1;
+
+        if (l < smf->heap_len && heap_less(smf, heap[l], heap[smallest])) smallest = l;
+        if (r < smf->heap_len && heap_less(smf, heap[r], heap[smallest])) smallest = r;
+        if (smallest == i) return;
+
+        uint8_t tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+static void heap_pop(smf_t *smf)
+{
+    smf->heap[0] = smf->heap[--smf->heap_len];
+    heap_sift_down(smf, 0);
+}
+
+/**
+ * @brief Move the tempo map forward to the given tick
+ *
+ * Samples are kept as a whole count plus a remainder in units of
+ * 1 / (division * 1e6) so tempo changes never round the song position.
+ */
+static void advance_to(smf_t *smf, uint32_t tick)
+{
+    uint32_t delta = tick - smf->tick;
+    uint64_t den = (uint64_t)smf->division * 1000000;
+
+    while (delta)
+    {
+        uint32_t chunk = delta < DELTA_CHUNK ? delta : DELTA_CHUNK;
+        smf->remainder += (uint64_t)chunk * smf->tempo_us * smf->sampling_rate_hz;
+        smf->samples += smf->remainder / den;
+        smf->remainder %= den;
+        delta -= chunk;
+    }
+
+    smf->tick = tick;
+}
+
+static void apply_meta(smf_t *smf, const meta_t *meta)
+{
+    if (meta->type == META_TEMPO && meta->len == 3 && !smf->smpte)
+    {
+        uint32_t tempo = meta->data[0] << 16 | meta->data[1] << 8 | meta->data[2];
+        if (tempo) smf->tempo_us = tempo;
+    }
+    else if (meta->type == META_TIME_SIGNATURE && meta->len >= 2)
+    {
+        // A change in the middle of a bar starts a new one
+        uint32_t bar_ticks = smf->beats_per_bar * smf->ticks_per_beat;
+        smf->bar_count += (smf->tick - smf->bar_tick + bar_ticks - 1) / bar_ticks;
+        smf->bar_tick = smf->tick;
+
+        uint8_t denominator = meta->data[1] > 6 ? 6 : meta->data[1];
+        smf->beats_per_bar = meta->data[0] ? meta->data[0] : 4;
+        smf->ticks_per_beat = (uint32_t)smf->division * 4 >> denominator;
+        if (smf->ticks_per_beat == 0) smf->ticks_per_beat = 1;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief Length of the MIDI file at the start of a buffer
+ *
+ * Walks the header and track chunks without reading the events, so files
+ * stored back to back can be found. Returns 0 if no complete file is there.
+ */
+size_t smf_file_size(const uint8_t *data, size_t size)
+{
+    if (size < CHUNK_HEADER_LEN + HEADER_LEN || memcmp(data, "MThd", 4) != 0) return 0;
+
+    uint32_t header_len = read_be32(data + 4);
+    if (header_len < HEADER_LEN || header_len > size - CHUNK_HEADER_LEN) return 0;
+
+    uint16_t tracks = read_be16(data + 10);
+    size_t pos = CHUNK_HEADER_LEN + header_len;
+
+    // Unknown chunk types are allowed and do not count as tracks
+    while (tracks)
+    {
+        if (size - pos < CHUNK_HEADER_LEN) return 0;
+
+        uint32_t len = read_be32(data + pos + 4);
+        if (len > size - pos - CHUNK_HEADER_LEN) return 0;
+
+        if (memcmp(data + pos, "MTrk", 4) == 0) tracks--;
+        pos += CHUNK_HEADER_LEN + len;
+    }
+
+    return pos;
+}
+
+esp_err_t smf_open(smf_t *smf, const uint8_t *data, size_t size, uint32_t sampling_rate_hz)
+{
+    size = smf_file_size(data, size);
+    if (size == 0 || sampling_rate_hz == 0) return ESP_ERR_INVALID_ARG;
+
+    uint16_t format = read_be16(data + 8);
+    uint16_t division = read_be16(data + 12);
+    if (format > 1) return ESP_ERR_NOT_SUPPORTED; // Independent sequences
+
+    memset(smf, 0, sizeof(*smf));
+    smf->data = data;
+    smf->sampling_rate_hz = sampling_rate_hz;
+
+    if (division & 0x8000)
+    {
+        // SMPTE: frames per second (negative) times ticks per frame, at a
+        // fixed tempo of one "quarter note" per second
+        int8_t fps = (int8_t)(division >> 8);
+        smf->division = (uint16_t)(-fps * (division & 0xFF));
+        smf->smpte = true;
+    }
+    else
+    {
+        smf->division = division;
+    }
+    if (smf->division == 0) return ESP_ERR_INVALID_ARG;
+
+    size_t pos = CHUNK_HEADER_LEN + read_be32(data + 4);
+    while (pos < size && smf->track_count < SMF_MAX_TRACKS)
+    {
+        uint32_t len = read_be32(data + pos + 4);
+        if (memcmp(data + pos, "MTrk", 4) == 0)
+        {
+            smf_track_t *track = &smf->tracks[smf->track_count++];
+            track->pos = data + pos + CHUNK_HEADER_LEN;
+            track->end = track->pos + len;
+        }
+        pos += CHUNK_HEADER_LEN + len;
+    }
+
+    smf_rewind(smf);
+
+    return ESP_OK;
+}
+
+void smf_rewind(smf_t *smf)
+{
+    const uint8_t *pos = smf->data + CHUNK_HEADER_LEN + read_be32(smf->data + 4);
+
+    smf->heap_len = 0;
+    for (uint8_t t = 0; t < smf->track_count; ++t)
+    {
+        // Chunks are contiguous, each track starts 8 bytes after the previous end
+        while (memcmp(pos, "MTrk", 4) != 0) pos += CHUNK_HEADER_LEN + read_be32(pos + 4);
+
+        smf_track_t *track = &smf->tracks[t];
+        track->pos = pos + CHUNK_HEADER_LEN;
+        track->running_status = 0;
+        pos = track->end;
+
+        uint32_t delta;
+        if (!read_varlen(track, &delta)) continue;
+        track->tick = delta;
+        smf->heap[smf->heap_len++] = t;
+    }
+
+    for (int i = smf->heap_len / 2 - 1; i >= 0; --i) heap_sift_down(smf, i);
+
+    smf->tick = 0;
+    smf->tempo_us = smf->smpte ? 1000000 : SMF_DEFAULT_TEMPO_US;
+    smf->samples = 0;
+    smf->remainder = 0;
+
+    smf->beats_per_bar = 4;
+    smf->ticks_per_beat = smf->division;
+    smf->bar_tick = 0;
+    smf->bar_count = 0;
+}
+
+/**
+ * @brief Read the next channel message of the merged tracks
+ *
+ * @return false at the end of the song
+ */
+bool smf_next(smf_t *smf, smf_event_t *event)
+{
+    while (smf->heap_len)
+    {
+        smf_track_t *track = &smf->tracks[smf->heap[0]];
+        advance_to(smf, track->tick);
+
+        meta_t meta;
+        event_kind_t kind = read_event(track, event, &meta);
+        if (kind == EVENT_META) apply_meta(smf, &meta);
+
+        uint32_t delta;
+        bool ended = kind == EVENT_ERROR || (kind == EVENT_META && meta.type == META_END_OF_TRACK);
+        if (ended || !read_varlen(track, &delta))
+        {
+            heap_pop(smf);
+        }
+        else
+        {
+            track->tick += delta;
+            heap_sift_down(smf, 0);
+        }
+
+        if (kind == EVENT_CHANNEL)
+        {
+            event->time = smf->samples;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Bar and beat of the last event read, both counted from 1
+ */
+void smf_position(const smf_t *smf, uint32_t *bar, uint8_t *beat)
+{
+    uint32_t elapsed = smf->tick - smf->bar_tick;
+    uint32_t bar_ticks = smf->beats_per_bar * smf->ticks_per_beat;
+
+    *bar = smf->bar_count + elapsed / bar_ticks + 1;
+    *beat = (elapsed % bar_ticks) / smf->ticks_per_beat + 1;
+}
+
+/**
+ * @brief Copy the name of the first track, empty if the file has none
+ *
+ * Only the events at the very start of the track are looked at, where
+ * sequencers write the name.
+ */
+void smf_name(const uint8_t *data, size_t size, char *name, size_t len)
+{
+    name[0] = '\0';
+
+    size = smf_file_size(data, size);
+    if (size == 0 || len == 0) return;
+
+    size_t pos = CHUNK_HEADER_LEN + read_be32(data + 4);
+    while (pos < size && memcmp(data + pos, "MTrk", 4) != 0) pos += CHUNK_HEADER_LEN + read_be32(data + pos + 4);
+    if (pos >= size) return;
+
+    smf_track_t track = {.pos = data + pos + CHUNK_HEADER_LEN};
+    track.end = track.pos + read_be32(data + pos + 4);
+
+    uint32_t delta;
+    while (read_varlen(&track, &delta) && delta == 0)
+    {
+        smf_event_t event;
+        meta_t meta;
+        event_kind_t kind = read_event(&track, &event, &meta);
+        if (kind == EVENT_ERROR) return;
+        if (kind != EVENT_META || meta.type != META_TRACK_NAME) continue;
+
+        size_t n = meta.len < len - 1 ? meta.len : len - 1;
+        for (size_t i = 0; i < n; ++i)
+            name[i] = meta.data[i] >= 0x20 && meta.data[i] < 0x7F ? (char)meta.data[i] : '?';
+        name[n] = '\0';
+        return;
+    }
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file smf.h
+ * @brief Incremental Standard MIDI File (type 0 and 1) reader
+ *
+ * The file is read in place, nothing is copied or decoded ahead: each track
+ * keeps a cursor on its next event and a small binary heap orders the tracks
+ * by the tick of that event, so merging costs O(log tracks) per event. Tempo
+ * and time signature meta events are applied as they are crossed and event
+ * times come out in samples, exact to the sample with no accumulated drift.
+ *
+ * Only channel messages are returned, system exclusive and other meta events
+ * are skipped.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef SMF_H
+#define SMF_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define SMF_MAX_TRACKS 32
+#define SMF_NAME_LEN 24  // Including the terminator
+#define SMF_DEFAULT_TEMPO_US 500000  // 120 BPM
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t time;  // Samples from the start of the song
+    uint8_t status; // Channel message status byte, running status resolved
+    uint8_t data1;
+    uint8_t data2;  // 0 for messages with a single data byte
+} smf_event_t;
+
+typedef struct
+{
+    const uint8_t *pos;
+    const uint8_t *end;
+    uint32_t tick;          // Absolute tick of the event at pos
+    uint8_t running_status;
+} smf_track_t;
+
+typedef struct
+{
+    const uint8_t *data;
+    uint32_t sampling_rate_hz;
+    uint16_t division;      // Ticks per quarter note, or per second for SMPTE files
+    bool smpte;
+
+    smf_track_t tracks[SMF_MAX_TRACKS];
+    uint8_t heap[SMF_MAX_TRACKS];  // Live tracks, min-heap on (tick, track)
+    uint8_t heap_len;
+    uint8_t track_count;
+
+    // Tempo map, advanced as events are read
+    uint32_t tick;
+    uint32_t tempo_us;      // Microseconds per quarter note
+    uint32_t samples;
+    uint64_t remainder;     // Fraction of a sample, in 1 / (division * 1e6)
+
+    // Time signature, for the bar and beat position
+    uint8_t beats_per_bar;
+    uint32_t ticks_per_beat;
+    uint32_t bar_tick;      // Tick where bar_count was last known
+    uint32_t bar_count;
+} smf_t;
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+size_t smf_file_size(const uint8_t *data, size_t size);
+esp_err_t smf_open(smf_t *smf, const uint8_t *data, size_t size, uint32_t sampling_rate_hz);
+void smf_rewind(smf_t *smf);
+bool smf_next(smf_t *smf, smf_event_t *event);
+void smf_position(const smf_t *smf, uint32_t *bar, uint8_t *beat);
+void smf_name(const uint8_t *data, size_t size, char *name, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !SMF_H */
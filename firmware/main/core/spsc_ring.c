@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file spsc_ring.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "spsc_ring.h"
+#include "esp_attr.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+esp_err_t spsc_ring_init(spsc_ring_t *ring, void *storage, size_t item_size, uint32_t capacity)
+{
+    if (ring == NULL || storage == NULL || item_size == 0) return ESP_ERR_INVALID_ARG;
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) return ESP_ERR_INVALID_SIZE;
+
+    ring->storage = storage;
+    ring->item_size = item_size;
+    ring->mask = capacity - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+
+    return ESP_OK;
+}
+
+IRAM_ATTR bool spsc_ring_push(spsc_ring_t *ring, const void *item)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (head - tail > ring->mask) return false; // Full
+
+    memcpy(ring->storage + (head & ring->mask) * ring->item_size, item, ring->item_size);
+    // Publish the item only once it is fully written
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    return true;
+}
+
+IRAM_ATTR bool spsc_ring_pop(spsc_ring_t *ring, void *item)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    if (head == tail) return false; // Empty
+
+    memcpy(item, ring->storage + (tail & ring->mask) * ring->item_size, ring->item_size);
+    // Hand the slot back only once it has been read
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+
+    return true;
+}
+
+uint32_t spsc_ring_count(spsc_ring_t *ring)
+{
+    return atomic_load_explicit(&ring->head, memory_order_acquire) -
+           atomic_load_explicit(&ring->tail, memory_order_acquire);
+}
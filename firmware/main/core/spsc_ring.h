@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file spsc_ring.h
+ * @brief Lock-free single-producer/single-consumer ring
+ *
+ * Fixed-size items copied in and out of caller-provided storage. Exactly one
+ * context may push and one other context may pop; no locks or critical
+ * sections are taken so either side may run in an ISR or on the other core.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_err.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+// clang-format off
+typedef struct
+{
+    uint8_t *storage;
+    size_t item_size;
+    uint32_t mask;          // Capacity - 1, capacity is a power of two
+    _Atomic uint32_t head;  // Written by the producer only
+    _Atomic uint32_t tail;  // Written by the consumer only
+} spsc_ring_t;
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+esp_err_t spsc_ring_init(spsc_ring_t *ring, void *storage, size_t item_size, uint32_t capacity);
+bool spsc_ring_push(spsc_ring_t *ring, const void *item);
+bool spsc_ring_pop(spsc_ring_t *ring, void *item);
+uint32_t spsc_ring_count(spsc_ring_t *ring);
+
+// clang-format on
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !SPSC_RING_H */
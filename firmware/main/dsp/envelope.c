@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file envelope.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "envelope.h"
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define FOREVER UINT32_MAX
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static inline uint32_t ms_to_samples(uint16_t ms, uint32_t sampling_rate_hz)
+{
+    return ((uint32_t)ms * sampling_rate_hz) / 1000;
+}
+
+/**
+ * @brief Start a segment from the current level to target over count samples
+ *
+ * @return false if the segment is empty and the next stage must be entered
+ */
+static bool enter_segment(envelope_t *env, envelope_stage_t stage, int32_t target, uint32_t count)
+{
+    env->stage = stage;
+    if (count == 0)
+    {
+        env->level = target;
+        return false;
+    }
+
+    env->inc = (target - env->level) / (int32_t)count;
+    env->remaining = count;
+    return true;
+}
+
+static void enter_hold(envelope_t *env, envelope_stage_t stage, int32_t level)
+{
+    env->stage = stage;
+    env->level = level;
+    env->inc = 0;
+    env->remaining = FOREVER;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void envelope_start(envelope_t *env, const envelope_config_t *cfg, uint32_t sampling_rate_hz)
+{
+    env->sustain = (int32_t)cfg->sustain_level << (ENVELOPE_LEVEL_BITS - ENVELOPE_OUT_BITS);
+    env->attack_samples = ms_to_samples(cfg->attack_ms, sampling_rate_hz);
+    env->decay_samples = ms_to_samples(cfg->decay_ms, sampling_rate_hz);
+    env->release_samples = ms_to_samples(cfg->release_ms, sampling_rate_hz);
+
+    // A retriggered voice rises from where it is instead of clicking to zero
+    if (env->stage == ENVELOPE_STAGE_IDLE) env->level = 0;
+
+    if (!enter_segment(env, ENVELOPE_STAGE_ATTACK, ENVELOPE_LEVEL_ONE, env->attack_samples)) envelope_advance(env);
+}
+
+void envelope_release(envelope_t *env)
+{
+    if (env->stage == ENVELOPE_STAGE_IDLE || env->stage == ENVELOPE_STAGE_RELEASE) return;
+
+    if (!enter_segment(env, ENVELOPE_STAGE_RELEASE, 0, env->release_samples)) enter_hold(env, ENVELOPE_STAGE_IDLE, 0);
+}
+
+void envelope_advance(envelope_t *env)
+{
+    switch (env->stage)
+    {
+    case ENVELOPE_STAGE_ATTACK:
+        env->level = ENVELOPE_LEVEL_ONE;
+        if (enter_segment(env, ENVELOPE_STAGE_DECAY, env->sustain, env->decay_samples)) break;
+        // fall through
+    case ENVELOPE_STAGE_DECAY:
+    case ENVELOPE_STAGE_SUSTAIN:
+        enter_hold(env, ENVELOPE_STAGE_SUSTAIN, env->sustain);
+        break;
+    default:
+        enter_hold(env, ENVELOPE_STAGE_IDLE, 0);
+        break;
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file envelope.h
+ * @brief Fixed-point linear ADSR envelope
+ *
+ * Each stage is a straight segment whose increment and length in samples are
+ * computed when the stage is entered (note-on, note-off), so a sample costs one
+ * add and one counter test. Levels are Q30, envelope_step() returns Q15.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef ENVELOPE_H
+#define ENVELOPE_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define ENVELOPE_LEVEL_BITS 30
+#define ENVELOPE_LEVEL_ONE (1L << ENVELOPE_LEVEL_BITS)
+#define ENVELOPE_OUT_BITS 15
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    ENVELOPE_STAGE_IDLE = 0,
+    ENVELOPE_STAGE_ATTACK,
+    ENVELOPE_STAGE_DECAY,
+    ENVELOPE_STAGE_SUSTAIN,
+    ENVELOPE_STAGE_RELEASE
+} envelope_stage_t;
+
+typedef struct
+{
+    uint16_t attack_ms;
+    uint16_t decay_ms;
+    uint16_t sustain_level; // Q15
+    uint16_t release_ms;
+} envelope_config_t;
+
+typedef struct
+{
+    int32_t level;
+    int32_t inc;
+    uint32_t remaining; // Samples left in the current stage
+    uint8_t stage;
+
+    // Precomputed at note-on
+    int32_t sustain;
+    uint32_t attack_samples;
+    uint32_t decay_samples;
+    uint32_t release_samples;
+} envelope_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void envelope_start(envelope_t *env, const envelope_config_t *cfg, uint32_t sampling_rate_hz);
+void envelope_release(envelope_t *env);
+void envelope_advance(envelope_t *env);
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief Advance the envelope by one sample and return its gain in Q15
+ */
+static inline int32_t envelope_step(envelope_t *env)
+{
+    env->level += env->inc;
+    if (--env->remaining == 0) envelope_advance(env);
+
+    return env->level >> (ENVELOPE_LEVEL_BITS - ENVELOPE_OUT_BITS);
+}
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !ENVELOPE_H */
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file fm.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "fm.h"
+#include <stddef.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define RATIO(r) ((uint16_t)((r) * (1 << FM_RATIO_BITS) + 0.5))
+// Modulation index in radians to peak deviation
+#define INDEX(i) ((uint16_t)((i) / 6.2831853 * (1 << FM_DEPTH_BITS) + 0.5))
+#define PCT(p) ((p) * 32767 / 100)
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const fm_patch_t patches[FM_PATCH_COUNT] = {
+    [FM_PATCH_EPIANO] = {.name = "E.Piano", .ratio = RATIO(1.0), .depth = INDEX(3.0),
+        .index_env = {.attack_ms = 0, .decay_ms = 400, .sustain_level = PCT(15), .release_ms = 200}},
+    // Non-integer ratio puts the sidebands off the harmonic series
+    [FM_PATCH_BELL] = {.name = "Bell", .ratio = RATIO(3.5), .depth = INDEX(5.0),
+        .index_env = {.attack_ms = 0, .decay_ms = 1200, .sustain_level = 0, .release_ms = 600}},
+    [FM_PATCH_BRASS] = {.name = "Brass", .ratio = RATIO(1.0), .depth = INDEX(4.0),
+        .index_env = {.attack_ms = 60, .decay_ms = 200, .sustain_level = PCT(60), .release_ms = 100}},
+    [FM_PATCH_BASS] = {.name = "Bass", .ratio = RATIO(0.5), .depth = INDEX(2.5),
+        .index_env = {.attack_ms = 0, .decay_ms = 150, .sustain_level = PCT(30), .release_ms = 80}},
+};
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+const fm_patch_t *fm_patch_get(fm_patch_id_t id) { return id < FM_PATCH_COUNT ? &patches[id] : NULL; }
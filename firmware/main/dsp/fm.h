@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file fm.h
+ * @brief Two-operator FM patches
+ *
+ * A sine modulator running at a fixed ratio of the carrier frequency shifts
+ * the phase of a sine carrier. The modulation index follows its own envelope,
+ * which is what makes the timbre evolve (bright attack, mellow sustain).
+ *
+ * The index is kept as a peak phase deviation in 1/4096 of a turn so the
+ * per-sample offset is one multiply and one shift on the 32-bit phase.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef FM_H
+#define FM_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/envelope.h"
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define FM_RATIO_BITS 8
+#define FM_DEPTH_BITS 12  // Peak deviation in 1/4096 of a turn
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    FM_PATCH_EPIANO = 0,
+    FM_PATCH_BELL,
+    FM_PATCH_BRASS,
+    FM_PATCH_BASS,
+    FM_PATCH_COUNT
+} fm_patch_id_t;
+
+typedef struct
+{
+    const char *name;
+    uint16_t ratio;               // Modulator to carrier frequency, Q8
+    uint16_t depth;               // Peak phase deviation, see FM_DEPTH_BITS
+    envelope_config_t index_env;  // Sustain is a fraction of the peak index
+} fm_patch_t;
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+static inline uint32_t fm_mod_inc(uint32_t carrier_inc, uint16_t ratio)
+{
+    return (uint32_t)(((uint64_t)carrier_inc * ratio) >> FM_RATIO_BITS);
+}
+
+/**
+ * @brief Carrier phase offset for a Q15 modulator sample and a deviation
+ *
+ * The deviation is the patch depth already scaled by the Q15 index envelope.
+ */
+static inline uint32_t fm_phase_offset(int32_t mod, int32_t deviation)
+{
+    return (uint32_t)(mod * deviation) << (32 - FM_DEPTH_BITS - 15);
+}
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+const fm_patch_t *fm_patch_get(fm_patch_id_t id);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !FM_H */
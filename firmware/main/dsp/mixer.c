@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file mixer.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "mixer.h"
+#include "esp_attr.h"
+#include <math.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define CURVE_SIZE (1 << MIXER_CURVE_BITS)
+#define FULL_SCALE 32767
+#define OUT_HALF 32767 // Offset to the unsigned synth output
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static int16_t curve[CURVE_SIZE + 1] = {0};
+static int32_t in_max = 0; // Sums are clamped to +-in_max before lookup
+static uint8_t step_bits = 0; // Sum units per curve step, as a shift
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void mixer_init(uint8_t max_voices, uint16_t voice_gain_pct)
+{
+    // Smallest power of two step that lets the table span every voice at full scale
+    step_bits = 0;
+    while (((int64_t)CURVE_SIZE << step_bits) < 2LL * max_voices * (FULL_SCALE + 1)) step_bits++;
+    in_max = ((int32_t)CURVE_SIZE << (step_bits - 1)) - 1;
+
+    const float knee = MIXER_KNEE_PCT / 100.0f;
+    for (int i = 0; i <= CURVE_SIZE; ++i)
+    {
+        // Input of this entry, scaled by the voice gain, in full scale units
+        float x = (float)((i - CURVE_SIZE / 2) << step_bits) / (FULL_SCALE + 1) * voice_gain_pct / 100.0f;
+        float ax = fabsf(x);
+        float y = ax < knee ? ax : knee + (1.0f - knee) * tanhf((ax - knee) / (1.0f - knee));
+
+        curve[i] = (int16_t)lrintf(copysignf(y, x) * FULL_SCALE);
+    }
+}
+
+IRAM_ATTR void mixer_process(const int32_t *sum, uint16_t *out, size_t len)
+{
+    const int32_t frac_mask = (1 << step_bits) - 1;
+
+    for (size_t n = 0; n < len; ++n)
+    {
+        int32_t x = sum[n];
+        if (x > in_max)
+            x = in_max;
+        else if (x < -in_max)
+            x = -in_max;
+
+        // Interpolate between the two entries around the sum
+        x += in_max + 1;
+        int32_t index = x >> step_bits;
+        int32_t y0 = curve[index];
+        int32_t y1 = curve[index + 1];
+        int32_t y = y0 + (((y1 - y0) * (x & frac_mask)) >> step_bits);
+
+        out[n] = (uint16_t)(y + OUT_HALF);
+    }
+}
+
+IRAM_ATTR void mixer_accumulate_ref(int32_t *acc, const int16_t *in, uint32_t gain, size_t len)
+{
+    for (size_t n = 0; n < len; ++n) acc[n] += (in[n] * (int32_t)gain) >> MIXER_GAIN_BITS;
+}
+
+/**
+ * @brief Add a voice to the accumulator, acc += (in * gain) >> MIXER_GAIN_BITS
+ *
+ * The one per-voice step every voice type shares. It runs the reference for
+ * now: an ESP32-S3 vector version stays out until it is assembled and timed
+ * on the board, and it will have to match mixer_accumulate_ref() bit for bit.
+ */
+IRAM_ATTR void mixer_accumulate(int32_t *acc, const int16_t *in, uint32_t gain, size_t len)
+{
+    mixer_accumulate_ref(acc, in, gain, len);
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file mixer.h
+ * @brief Headroom mixer with a soft-clip curve
+ *
+ * Voices are summed at full scale into an int32 accumulator. A fixed voice
+ * gain and a soft-clip curve are baked into one table indexed by the sum, so
+ * chords get louder as they build up and saturate smoothly instead of
+ * clipping, with no division per sample.
+ *
+ * Each voice is added to the accumulator with its gain by
+ * mixer_accumulate(), on MIXER_ALIGN aligned buffers so that a vector
+ * version can take it over. mixer_accumulate_ref() is the portable version
+ * such a version must match bit for bit. Until one has been checked on the
+ * board, mixer_accumulate() runs it.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef MIXER_H
+#define MIXER_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define MIXER_CURVE_BITS 10
+#define MIXER_KNEE_PCT 60   // Output stays linear below this fraction of full scale
+#define MIXER_GAIN_BITS 15  // Voice gains are Q15, up to MIXER_GAIN_ONE
+#define MIXER_GAIN_ONE (1 << MIXER_GAIN_BITS)
+#define MIXER_ALIGN 16      // Byte alignment of the mixer_accumulate() buffers
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void mixer_init(uint8_t max_voices, uint16_t voice_gain_pct);
+void mixer_process(const int32_t *sum, uint16_t *out, size_t len);
+void mixer_accumulate(int32_t *acc, const int16_t *in, uint32_t gain, size_t len);
+void mixer_accumulate_ref(int32_t *acc, const int16_t *in, uint32_t gain, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !MIXER_H */
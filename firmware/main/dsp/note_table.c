@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file note_table.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "note_table.h"
+#include "dsp/synth_engine.h"
+#include "sdkconfig.h"
+#include <math.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define A4_CODE 69
+#define A4_HZ CONFIG_INTERRUPTER_SYNTH_A4_HZ
+
+#define FINE_ONE_BITS 30 // Q2.30 ratios, 2^(63/768) * 2^30 fits easily
+#define PHASE_INC_MAX 0x7FFFFFFFUL // Nyquist, notes above it are clamped
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const char *names[12] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+
+static uint32_t phase_inc_table[NOTE_TABLE_SIZE] = {0};
+static float freq_table[NOTE_TABLE_SIZE] = {0};
+static uint8_t name_table[NOTE_TABLE_SIZE] = {0};
+static int8_t octave_table[NOTE_TABLE_SIZE] = {0};
+static uint32_t fine_table[NOTE_TABLE_FINE_STEPS] = {0};
+
+static bool initialized = false;
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void note_table_init(void)
+{
+    if (initialized) return;
+
+    for (int i = 0; i < NOTE_TABLE_SIZE; ++i)
+    {
+        double freq_hz = A4_HZ * pow(2.0, (i - A4_CODE) / 12.0);
+        double inc = freq_hz / SYNTH_SAMPLING_RATE_HZ * (double)(1ULL << NOTE_TABLE_PHASE_BITS) + 0.5;
+
+        freq_table[i] = (float)freq_hz;
+        phase_inc_table[i] = inc > PHASE_INC_MAX ? PHASE_INC_MAX : (uint32_t)inc;
+        name_table[i] = i % 12;
+        octave_table[i] = -2 + i / 12;
+    }
+
+    for (int i = 0; i < NOTE_TABLE_FINE_STEPS; ++i)
+    {
+        fine_table[i] = (uint32_t)(pow(2.0, i / (12.0 * NOTE_TABLE_FINE_STEPS)) * (1UL << FINE_ONE_BITS) + 0.5);
+    }
+
+    initialized = true;
+}
+
+uint32_t note_table_phase_inc(uint8_t code) { return phase_inc_table[code & (NOTE_TABLE_SIZE - 1)]; }
+
+uint32_t note_table_phase_inc_fine(uint8_t code, int32_t fine)
+{
+    // fine is in 1/NOTE_TABLE_FINE_STEPS semitone, split it into note and fraction
+    int32_t pos = ((int32_t)code << NOTE_TABLE_FINE_BITS) + fine;
+    if (pos < 0) pos = 0;
+    if (pos > ((NOTE_TABLE_SIZE - 1) << NOTE_TABLE_FINE_BITS)) pos = (NOTE_TABLE_SIZE - 1) << NOTE_TABLE_FINE_BITS;
+
+    uint64_t inc = (uint64_t)phase_inc_table[pos >> NOTE_TABLE_FINE_BITS] * fine_table[pos & (NOTE_TABLE_FINE_STEPS - 1)];
+    inc >>= FINE_ONE_BITS;
+
+    return inc > PHASE_INC_MAX ? PHASE_INC_MAX : (uint32_t)inc;
+}
+
+float note_table_freq_hz(uint8_t code) { return freq_table[code & (NOTE_TABLE_SIZE - 1)]; }
+
+const char *note_table_name(uint8_t code) { return names[name_table[code & (NOTE_TABLE_SIZE - 1)]]; }
+
+int8_t note_table_octave(uint8_t code) { return octave_table[code & (NOTE_TABLE_SIZE - 1)]; }
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file note_table.h
+ * @brief MIDI note tuning tables
+ *
+ * Phase increments, frequencies and names of the 128 MIDI notes, filled once
+ * from CONFIG_INTERRUPTER_SYNTH_A4_HZ and the synth sampling rate so that the
+ * note-on path does no float math. A fine sub-table splits each semitone in
+ * NOTE_TABLE_FINE_STEPS for pitch bend.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef NOTE_TABLE_H
+#define NOTE_TABLE_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define NOTE_TABLE_SIZE (128)
+#define NOTE_TABLE_PHASE_BITS 32                            // DDS accumulator precision
+#define NOTE_TABLE_FINE_BITS 6
+#define NOTE_TABLE_FINE_STEPS (1 << NOTE_TABLE_FINE_BITS)   // Fine steps per semitone
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void note_table_init(void);
+
+uint32_t note_table_phase_inc(uint8_t code);
+uint32_t note_table_phase_inc_fine(uint8_t code, int32_t fine);
+float note_table_freq_hz(uint8_t code);
+const char *note_table_name(uint8_t code);
+int8_t note_table_octave(uint8_t code);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !NOTE_TABLE_H */
@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file percussion.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "percussion.h"
+#include "dsp/wavetable.h"
+#include <math.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define NOTE_COUNT 128
+#define NO_SOUND 0xFF
+
+#define AMP_BITS 30
+#define SWEEP_PART 3 // Clicks reach their end pitch after a third of their length
+#define DECAY_FLOOR 0.001 // -60 dB at the end of an exponential decay
+#define LFSR_SEED 0x1234567
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t note;
+    uint8_t kind;
+    uint16_t start_hz; // Tone, 0 for none
+    uint16_t end_hz;   // Clicks sweep down to it
+    uint16_t length_ms;
+    uint8_t noise_pct; // Noise share of a hit
+    uint8_t level_pct;
+    uint8_t group;     // Sounds of the same non-zero group cut each other
+    bool bright;       // Differentiated noise, for metal
+} sound_t;
+
+typedef struct
+{
+    uint32_t start_inc;
+    uint32_t end_inc;
+    uint32_t sweep;   // Q30 per-sample pitch ratio
+    int32_t decay;    // Q30 per-sample amplitude ratio
+    uint32_t samples; // Length of a hit
+} sound_coefs_t;
+
+typedef struct
+{
+    const sound_t *sound; // NULL when idle
+    const sound_coefs_t *coefs;
+    uint32_t phase;
+    uint32_t inc;
+    int32_t amp;  // Q30
+    int32_t step; // Linear decay of hits
+    uint32_t remaining;
+    uint32_t age;
+    int32_t prev_noise;
+} drum_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const sound_t sounds[] = {
+    {35, PERCUSSION_CLICK, 120, 45, 300, 0, 100, 0, false},  // Acoustic bass drum
+    {36, PERCUSSION_CLICK, 150, 50, 250, 0, 100, 0, false},  // Bass drum 1
+    {37, PERCUSSION_HIT, 800, 0, 25, 50, 70, 0, false},      // Side stick
+    {38, PERCUSSION_HIT, 190, 0, 150, 70, 90, 0, false},     // Acoustic snare
+    {39, PERCUSSION_NOISE, 0, 0, 80, 0, 80, 0, true},        // Hand clap
+    {40, PERCUSSION_HIT, 220, 0, 120, 80, 90, 0, false},     // Electric snare
+    {41, PERCUSSION_CLICK, 90, 60, 350, 0, 90, 0, false},    // Low floor tom
+    {42, PERCUSSION_NOISE, 0, 0, 40, 0, 60, 1, true},        // Closed hi-hat
+    {43, PERCUSSION_CLICK, 110, 70, 330, 0, 90, 0, false},   // High floor tom
+    {44, PERCUSSION_NOISE, 0, 0, 60, 0, 50, 1, true},        // Pedal hi-hat
+    {45, PERCUSSION_CLICK, 130, 85, 300, 0, 90, 0, false},   // Low tom
+    {46, PERCUSSION_NOISE, 0, 0, 350, 0, 60, 1, true},       // Open hi-hat
+    {47, PERCUSSION_CLICK, 150, 100, 280, 0, 90, 0, false},  // Low-mid tom
+    {48, PERCUSSION_CLICK, 175, 115, 260, 0, 90, 0, false},  // Hi-mid tom
+    {49, PERCUSSION_NOISE, 0, 0, 1200, 0, 70, 0, true},      // Crash cymbal 1
+    {50, PERCUSSION_CLICK, 200, 130, 240, 0, 90, 0, false},  // High tom
+    {51, PERCUSSION_NOISE, 0, 0, 700, 0, 50, 0, true},       // Ride cymbal 1
+    {52, PERCUSSION_NOISE, 0, 0, 900, 0, 70, 0, false},      // Chinese cymbal
+    {53, PERCUSSION_HIT, 620, 0, 300, 10, 60, 0, false},     // Ride bell
+    {54, PERCUSSION_NOISE, 0, 0, 120, 0, 60, 0, true},       // Tambourine
+    {55, PERCUSSION_NOISE, 0, 0, 500, 0, 60, 0, true},       // Splash cymbal
+    {56, PERCUSSION_HIT, 560, 0, 150, 0, 70, 0, false},      // Cowbell
+    {57, PERCUSSION_NOISE, 0, 0, 1000, 0, 70, 0, true},      // Crash cymbal 2
+    {59, PERCUSSION_NOISE, 0, 0, 600, 0, 50, 0, true},       // Ride cymbal 2
+};
+
+#define SOUND_COUNT (sizeof(sounds) / sizeof(sounds[0]))
+
+static sound_coefs_t coefs[SOUND_COUNT];
+static uint8_t note_map[NOTE_COUNT];
+
+static drum_t drums[PERCUSSION_VOICES] = {0};
+static uint32_t age_counter = 0;
+static uint32_t lfsr = LFSR_SEED;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static inline int32_t noise(void)
+{
+    lfsr ^= lfsr << 13;
+    lfsr ^= lfsr >> 17;
+    lfsr ^= lfsr << 5;
+
+    return (int16_t)(lfsr >> 16);
+}
+
+static inline int32_t scale(int32_t sample, int32_t amp) { return ((int64_t)sample * amp) >> AMP_BITS; }
+
+static void render_noise(drum_t *d, int32_t *acc, size_t len)
+{
+    int32_t amp = d->amp;
+
+    for (size_t n = 0; n < len; ++n)
+    {
+        int32_t s = noise();
+        if (d->sound->bright)
+        {
+            // First difference tilts the spectrum up, closer to metal
+            int32_t diff = (s - d->prev_noise) >> 1;
+            d->prev_noise = s;
+            s = diff;
+        }
+
+        acc[n] += scale(s, amp);
+        amp = scale(amp, d->coefs->decay);
+    }
+
+    d->amp = amp;
+}
+
+static void render_click(drum_t *d, int32_t *acc, size_t len)
+{
+    const int16_t *sine = wavetable_sine();
+    uint32_t phase = d->phase;
+    uint32_t inc = d->inc;
+    int32_t amp = d->amp;
+
+    for (size_t n = 0; n < len; ++n)
+    {
+        phase += inc;
+        acc[n] += scale(wavetable_read(sine, phase), amp);
+        amp = scale(amp, d->coefs->decay);
+
+        if (inc > d->coefs->end_inc) inc = ((uint64_t)inc * d->coefs->sweep) >> AMP_BITS;
+    }
+
+    d->phase = phase;
+    d->inc = inc;
+    d->amp = amp;
+}
+
+static void render_hit(drum_t *d, int32_t *acc, size_t len)
+{
+    const int16_t *sine = wavetable_sine();
+    int32_t noise_mix = d->sound->noise_pct * 32767 / 100;
+    int32_t tone_mix = 32767 - noise_mix;
+    size_t count = len < d->remaining ? len : d->remaining;
+
+    for (size_t n = 0; n < count; ++n)
+    {
+        d->phase += d->inc;
+        int32_t s = (wavetable_read(sine, d->phase) * tone_mix + noise() * noise_mix) >> 15;
+
+        acc[n] += scale(s, d->amp);
+        d->amp -= d->step;
+    }
+
+    d->remaining -= count;
+}
+
+static bool is_done(const drum_t *d)
+{
+    if (d->sound->kind == PERCUSSION_HIT) return d->remaining == 0;
+
+    return d->amp < (1 << (AMP_BITS - 15)) >> 1; // Below half an output LSB
+}
+
+static drum_t *pick_drum(const sound_t *sound)
+{
+    drum_t *victim = NULL;
+
+    for (int i = 0; i < PERCUSSION_VOICES; ++i)
+    {
+        drum_t *d = &drums[i];
+
+        // Retrigger the same drum and choke its group in place
+        if (d->sound && (d->sound == sound || (sound->group && d->sound->group == sound->group))) return d;
+
+        // Otherwise a free drum, else the oldest one
+        if (victim == NULL || (victim->sound && (d->sound == NULL || (int32_t)(d->age - victim->age) < 0))) victim = d;
+    }
+
+    return victim;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void percussion_init(uint32_t sampling_rate_hz)
+{
+    for (int i = 0; i < PERCUSSION_VOICES; ++i) drums[i] = (drum_t){0};
+    age_counter = 0;
+    lfsr = LFSR_SEED;
+
+    for (int i = 0; i < NOTE_COUNT; ++i) note_map[i] = NO_SOUND;
+
+    for (size_t i = 0; i < SOUND_COUNT; ++i)
+    {
+        const sound_t *s = &sounds[i];
+        sound_coefs_t *c = &coefs[i];
+        double samples = (double)s->length_ms * sampling_rate_hz / 1000;
+
+        note_map[s->note] = i;
+        c->start_inc = (uint32_t)(s->start_hz * 4294967296.0 / sampling_rate_hz);
+        c->end_inc = (uint32_t)(s->end_hz * 4294967296.0 / sampling_rate_hz);
+        c->samples = (uint32_t)samples;
+        c->decay = (int32_t)lrint(exp(log(DECAY_FLOOR) / samples) * (1 << AMP_BITS));
+        c->sweep = s->end_hz ? (uint32_t)lrint(pow((double)s->end_hz / s->start_hz, SWEEP_PART / samples) * (1 << AMP_BITS))
+                             : (1UL << AMP_BITS);
+    }
+}
+
+esp_err_t percussion_trigger(uint8_t note, uint16_t gain)
+{
+    if (note >= NOTE_COUNT || note_map[note] == NO_SOUND) return ESP_ERR_NOT_SUPPORTED;
+
+    const sound_t *sound = &sounds[note_map[note]];
+    drum_t *d = pick_drum(sound);
+
+    d->sound = sound;
+    d->coefs = &coefs[note_map[note]];
+    d->phase = 0;
+    d->inc = d->coefs->start_inc;
+    // Q15 velocity gain and level to Q30
+    d->amp = (int32_t)((uint32_t)gain * sound->level_pct / 100) << (AMP_BITS - 15);
+    d->remaining = d->coefs->samples;
+    d->step = d->remaining ? d->amp / (int32_t)d->remaining : 0;
+    d->age = ++age_counter;
+    d->prev_noise = 0;
+
+    return ESP_OK;
+}
+
+void percussion_render(int32_t *acc, size_t len)
+{
+    for (int i = 0; i < PERCUSSION_VOICES; ++i)
+    {
+        drum_t *d = &drums[i];
+        if (d->sound == NULL) continue;
+
+        switch (d->sound->kind)
+        {
+        case PERCUSSION_NOISE:
+            render_noise(d, acc, len);
+            break;
+        case PERCUSSION_CLICK:
+            render_click(d, acc, len);
+            break;
+        default:
+            render_hit(d, acc, len);
+            break;
+        }
+
+        if (is_done(d)) d->sound = NULL;
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file percussion.h
+ * @brief General MIDI drum kit for the percussion channel
+ *
+ * Every mapped drum note is one of three cheap generators:
+ * - NOISE: xorshift LFSR noise burst with an exponential decay (hats, cymbals)
+ * - CLICK: sine whose pitch sweeps down while it decays (kicks, toms)
+ * - HIT: tone and noise mix under a fixed-length linear decay (snares, bells)
+ *
+ * Drums play from their own small pool and are one-shot: note-offs are
+ * ignored, only the hi-hats cut each other like on a real kit.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef PERCUSSION_H
+#define PERCUSSION_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define PERCUSSION_VOICES 6
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    PERCUSSION_NOISE = 0,
+    PERCUSSION_CLICK,
+    PERCUSSION_HIT
+} percussion_kind_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void percussion_init(uint32_t sampling_rate_hz);
+esp_err_t percussion_trigger(uint8_t note, uint16_t gain);
+void percussion_render(int32_t *acc, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !PERCUSSION_H */
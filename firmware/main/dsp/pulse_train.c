@@ -0,0 +1,356 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file pulse_train.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "pulse_train.h"
+#include "dsp/note_table.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#if PULSE_TRAIN_TON_MIN > PULSE_TRAIN_TON_MAX
+#error "CONFIG_INTERRUPTER_TON_MIN must be <= CONFIG_INTERRUPTER_TON_MAX"
+#endif
+
+#define PERIOD_FRAC_BITS 8 // Periods in 1/256 us keep the pitch exact over time
+#define BEND_BITS 13
+#define BEND_CENTER (1 << BEND_BITS)
+#define BEND_RANGE_DEFAULT 2 // Semitones
+#define BEND_RANGE_MAX 24
+#define RPN_NULL 0x7F
+#define RPN_BEND_RANGE 0x00
+#define VELOCITY_MAX 127
+
+// Period in 1/256 us of a phase increment at the sampling rate
+#define PERIOD_NUM ((uint64_t)1000000 << (NOTE_TABLE_PHASE_BITS + PERIOD_FRAC_BITS))
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t next;    // Start of the next pulse
+    uint32_t period;  // In 1 / (1 << PERIOD_FRAC_BITS) us
+    uint32_t order;   // Note-on count when started, the lowest is stolen
+    uint8_t frac;     // Fraction of a us carried to the next pulse
+    uint8_t channel;
+    uint8_t code;
+    uint8_t velocity;
+    bool released;    // Key up, held by the sustain pedal
+} note_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static note_t notes[PULSE_TRAIN_MAX_NOTES];
+static uint32_t active_mask = 0;
+static uint32_t note_ons = 0;
+
+static int16_t bend[SYNTH_CHANNEL_COUNT] = {0};
+static uint8_t bend_range[SYNTH_CHANNEL_COUNT] = {0}; // Semitones
+static uint8_t rpn_msb[SYNTH_CHANNEL_COUNT] = {0};
+static uint8_t rpn_lsb[SYNTH_CHANNEL_COUNT] = {0};
+static bool sustain[SYNTH_CHANNEL_COUNT] = {0};
+static uint16_t width = 0;
+
+// Last pulse out of the merger, held until no later pulse can merge with it
+static bool pending_valid = false;
+static uint32_t pending_start = 0;
+static uint32_t pending_end = 0;
+
+static pulse_train_stats_t stats = {0};
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief Period of a note on a channel, with its bend
+ *
+ * From the phase increment the engine plays the note at, bend included in
+ * fine steps as it does: no float and no exponent math.
+ */
+static uint32_t note_period(uint8_t code, uint8_t channel)
+{
+    int32_t steps = bend_range[channel] << NOTE_TABLE_FINE_BITS;
+    int32_t fine = ((int32_t)bend[channel] * steps + BEND_CENTER / 2) >> BEND_BITS;
+    uint64_t inc = fine ? note_table_phase_inc_fine(code, fine) : note_table_phase_inc(code);
+    uint64_t den = inc * SYNTH_SAMPLING_RATE_HZ;
+
+    return (uint32_t)((PERIOD_NUM + den / 2) / den);
+}
+
+static void note_on(uint8_t code, uint8_t channel, uint8_t velocity, uint32_t time)
+{
+    int slot = -1;
+
+    for (uint32_t m = active_mask; m; m &= m - 1)
+    {
+        int n = __builtin_ctz(m);
+        if (notes[n].channel == channel && notes[n].code == code) slot = n; // Retrigger
+    }
+
+    if (slot < 0)
+    {
+        uint32_t free_mask = ~active_mask & ((1UL << PULSE_TRAIN_MAX_NOTES) - 1);
+        if (free_mask)
+        {
+            slot = __builtin_ctz(free_mask);
+        }
+        else
+        {
+            slot = 0;
+            for (int n = 1; n < PULSE_TRAIN_MAX_NOTES; ++n)
+                if ((int32_t)(notes[n].order - notes[slot].order) < 0) slot = n;
+            stats.steals++;
+        }
+    }
+
+    notes[slot] = (note_t){.next = time,
+        .period = note_period(code, channel),
+        .order = note_ons++,
+        .channel = channel,
+        .code = code,
+        .velocity = velocity};
+    active_mask |= 1UL << slot;
+}
+
+static void note_off(uint8_t code, uint8_t channel)
+{
+    for (uint32_t m = active_mask; m; m &= m - 1)
+    {
+        int n = __builtin_ctz(m);
+        if (notes[n].channel != channel || notes[n].code != code) continue;
+
+        if (sustain[channel])
+            notes[n].released = true;
+        else
+            active_mask &= ~(1UL << n);
+    }
+}
+
+static void set_sustain(uint8_t channel, bool on)
+{
+    sustain[channel] = on;
+    if (on) return;
+
+    for (uint32_t m = active_mask; m; m &= m - 1)
+    {
+        int n = __builtin_ctz(m);
+        if (notes[n].channel == channel && notes[n].released) active_mask &= ~(1UL << n);
+    }
+}
+
+/**
+ * @brief New pitch for the sounding notes of a channel, from their next pulse
+ */
+static void set_bend(uint8_t channel, int16_t value)
+{
+    bend[channel] = value;
+
+    for (uint32_t m = active_mask; m; m &= m - 1)
+    {
+        int n = __builtin_ctz(m);
+        if (notes[n].channel == channel) notes[n].period = note_period(notes[n].code, channel);
+    }
+}
+
+/**
+ * @brief Data entry of the selected RPN, only the bend sensitivity is followed
+ */
+static void data_entry(uint8_t channel, uint8_t value)
+{
+    if (rpn_msb[channel] != 0 || rpn_lsb[channel] != RPN_BEND_RANGE) return;
+
+    bend_range[channel] = value > BEND_RANGE_MAX ? BEND_RANGE_MAX : value;
+    set_bend(channel, bend[channel]);
+}
+
+static void all_notes_off(uint8_t channel)
+{
+    for (uint32_t m = active_mask; m; m &= m - 1)
+    {
+        int n = __builtin_ctz(m);
+        if (notes[n].channel == channel) active_mask &= ~(1UL << n);
+    }
+}
+
+static inline void take_pending(pulse_t *pulse)
+{
+    pulse->start = pending_start;
+    pulse->width = (uint16_t)(pending_end - pending_start);
+    pending_valid = false;
+    stats.pulses++;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void pulse_train_init(void)
+{
+    note_table_init();
+
+    active_mask = 0;
+    pending_valid = false;
+    memset(bend, 0, sizeof(bend));
+    memset(bend_range, BEND_RANGE_DEFAULT, sizeof(bend_range));
+    memset(rpn_msb, RPN_NULL, sizeof(rpn_msb));
+    memset(rpn_lsb, RPN_NULL, sizeof(rpn_lsb));
+    memset(sustain, 0, sizeof(sustain));
+    memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * @brief Pulse width of a full velocity note, later pulses follow at once
+ */
+void pulse_train_set_width(uint16_t width_us) { width = width_us > PULSE_TRAIN_TON_MAX ? PULSE_TRAIN_TON_MAX : width_us; }
+
+/**
+ * @brief Apply a synth event at the given time
+ *
+ * Takes the same events as synth_engine_apply(). Every pulse before the
+ * time must have been taken with pulse_train_next() first. Programs do not
+ * change a pulse train and drum notes are ignored.
+ */
+esp_err_t pulse_train_apply(const synth_cmd_t *cmd, uint32_t time)
+{
+    if (cmd->type != SYNTH_CMD_REALTIME && cmd->channel >= SYNTH_CHANNEL_COUNT) return ESP_ERR_INVALID_ARG;
+
+    switch (cmd->type)
+    {
+    case SYNTH_CMD_NOTE_ON:
+        if (cmd->channel == SYNTH_PERCUSSION_CHANNEL) return ESP_OK;
+        if (cmd->data2 == 0)
+            note_off(cmd->data1, cmd->channel);
+        else
+            note_on(cmd->data1 & (NOTE_TABLE_SIZE - 1), cmd->channel, cmd->data2 & VELOCITY_MAX, time);
+        return ESP_OK;
+    case SYNTH_CMD_NOTE_OFF:
+        note_off(cmd->data1, cmd->channel);
+        return ESP_OK;
+    case SYNTH_CMD_PROGRAM_CHANGE:
+        return ESP_OK;
+    case SYNTH_CMD_CONTROL_CHANGE:
+        switch (cmd->data1)
+        {
+        case SYNTH_CC_SUSTAIN:
+            set_sustain(cmd->channel, cmd->data2 >= 64);
+            return ESP_OK;
+        case SYNTH_CC_RESET_CONTROLLERS:
+            set_sustain(cmd->channel, false);
+            set_bend(cmd->channel, 0);
+            rpn_msb[cmd->channel] = rpn_lsb[cmd->channel] = RPN_NULL;
+            return ESP_OK;
+        case SYNTH_CC_RPN_MSB:
+            rpn_msb[cmd->channel] = cmd->data2;
+            return ESP_OK;
+        case SYNTH_CC_RPN_LSB:
+            rpn_lsb[cmd->channel] = cmd->data2;
+            return ESP_OK;
+        case SYNTH_CC_DATA_ENTRY:
+            data_entry(cmd->channel, cmd->data2);
+            return ESP_OK;
+        case SYNTH_CC_ALL_NOTES_OFF:
+            all_notes_off(cmd->channel);
+            return ESP_OK;
+        default:
+            return ESP_OK;
+        }
+    case SYNTH_CMD_PITCH_BEND:
+        set_bend(cmd->channel, ((cmd->data2 << 7) | cmd->data1) - BEND_CENTER);
+        return ESP_OK;
+    case SYNTH_CMD_REALTIME:
+        return ESP_ERR_NOT_SUPPORTED;
+    default:
+        return ESP_ERR_INVALID_ARG;
+    }
+}
+
+/**
+ * @brief Next pulse of the merged stream starting before the given time
+ *
+ * Call until it returns false, with times that do not go backwards. A pulse
+ * is only returned once no later pulse can merge with it, so the last one
+ * before the time may come out of a later call.
+ */
+bool pulse_train_next(uint32_t until, pulse_t *pulse)
+{
+    while (1)
+    {
+        int first = -1;
+        for (uint32_t m = active_mask; m; m &= m - 1)
+        {
+            int n = __builtin_ctz(m);
+            if (first < 0 || (int32_t)(notes[n].next - notes[first].next) < 0) first = n;
+        }
+        if (first < 0 || (int32_t)(notes[first].next - until) >= 0) break;
+
+        note_t *note = &notes[first];
+        uint32_t start = note->next;
+        uint32_t w = (uint32_t)width * note->velocity / VELOCITY_MAX;
+
+        uint32_t step = note->period + note->frac;
+        note->next += step >> PERIOD_FRAC_BITS;
+        note->frac = step & ((1 << PERIOD_FRAC_BITS) - 1);
+
+        if (w < PULSE_TRAIN_TON_MIN) continue; // Too short for the driver, silent
+
+        if (pending_valid)
+        {
+            int32_t gap = (int32_t)(start - pending_end);
+            if (gap <= 0)
+            {
+                // Overlap, the union of both up to the longest pulse allowed
+                uint32_t end = start + w;
+                uint32_t limit = pending_start + PULSE_TRAIN_TON_MAX;
+                if ((int32_t)(end - limit) > 0) end = limit;
+                if ((int32_t)(end - pending_end) > 0) pending_end = end;
+                stats.merged++;
+                continue;
+            }
+            if (gap < PULSE_TRAIN_TOFF_MIN)
+            {
+                stats.dropped++;
+                continue;
+            }
+
+            take_pending(pulse);
+            pending_start = start;
+            pending_end = start + w;
+            pending_valid = true;
+            return true;
+        }
+
+        pending_start = start;
+        pending_end = start + w;
+        pending_valid = true;
+    }
+
+    // Nothing can start before the time, so nothing can merge with a pulse
+    // whose off time ends by then
+    if (pending_valid && (int32_t)(until - (pending_end + PULSE_TRAIN_TOFF_MIN)) >= 0)
+    {
+        take_pending(pulse);
+        return true;
+    }
+
+    return false;
+}
+
+uint8_t pulse_train_active_notes(void) { return __builtin_popcount(active_mask); }
+
+void pulse_train_get_stats(pulse_train_stats_t *stats_out) { *stats_out = stats; }
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file pulse_train.h
+ * @brief One coil pulse per note period, merged into a single safe stream
+ *
+ * Each sounding note fires a pulse at its own frequency, wide in proportion
+ * to its velocity. The trains of all notes are merged in time order: a pulse
+ * overlapping the one before is folded into it, a pulse starting within the
+ * minimum off time after it is dropped. Every pulse out of the merger is
+ * between CONFIG_INTERRUPTER_TON_MIN and CONFIG_INTERRUPTER_TON_MAX long and
+ * at least CONFIG_INTERRUPTER_TOFF_MIN after the previous one.
+ *
+ * Times are in microseconds on the caller's clock and may wrap.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef PULSE_TRAIN_H
+#define PULSE_TRAIN_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/synth_engine.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define PULSE_TRAIN_MAX_NOTES (8)
+#define PULSE_TRAIN_TON_MIN CONFIG_INTERRUPTER_TON_MIN
+#define PULSE_TRAIN_TON_MAX CONFIG_INTERRUPTER_TON_MAX
+#define PULSE_TRAIN_TOFF_MIN CONFIG_INTERRUPTER_TOFF_MIN
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t start;  // us
+    uint16_t width;  // us
+} pulse_t;
+
+typedef struct
+{
+    uint32_t pulses;   // Out of the merger
+    uint32_t merged;   // Folded into an overlapping pulse
+    uint32_t dropped;  // Too close after the previous pulse
+    uint32_t steals;   // Note-ons that took over a sounding note
+} pulse_train_stats_t;
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void pulse_train_init(void);
+void pulse_train_set_width(uint16_t width_us);
+esp_err_t pulse_train_apply(const synth_cmd_t *cmd, uint32_t time);
+bool pulse_train_next(uint32_t until, pulse_t *pulse);
+uint8_t pulse_train_active_notes(void);
+void pulse_train_get_stats(pulse_train_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !PULSE_TRAIN_H */
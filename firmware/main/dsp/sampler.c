@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file sampler.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "sampler.h"
+#include "dsp/note_table.h"
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define STEP_ONE (1UL << SAMPLER_STEP_BITS)
+#define ADPCM_INDEX_MAX 88
+
+_Static_assert(sizeof(sampler_bank_header_t) == 8, "Bank layout is shared with the packing tool");
+_Static_assert(sizeof(sampler_entry_t) == 20, "Bank layout is shared with the packing tool");
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const int8_t adpcm_index_table[16] = {-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8};
+
+static const int16_t adpcm_step_table[ADPCM_INDEX_MAX + 1] = {7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25,
+    28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279,
+    307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+static const uint8_t *bank_base = NULL;
+static const sampler_entry_t *entries = NULL;
+static uint16_t entry_count = 0;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static inline int16_t adpcm_decode(sampler_voice_t *sv)
+{
+    uint8_t byte = sv->data[sv->next >> 1];
+    uint8_t nibble = (sv->next & 1) ? byte >> 4 : byte & 0x0F;
+    int32_t step = adpcm_step_table[sv->index];
+
+    int32_t diff = step >> 3;
+    if (nibble & 1) diff += step >> 2;
+    if (nibble & 2) diff += step >> 1;
+    if (nibble & 4) diff += step;
+
+    int32_t predictor = sv->predictor + ((nibble & 8) ? -diff : diff);
+    if (predictor > INT16_MAX) predictor = INT16_MAX;
+    if (predictor < INT16_MIN) predictor = INT16_MIN;
+    sv->predictor = predictor;
+
+    int32_t index = sv->index + adpcm_index_table[nibble];
+    sv->index = index < 0 ? 0 : (index > ADPCM_INDEX_MAX ? ADPCM_INDEX_MAX : index);
+    sv->next++;
+
+    return (int16_t)predictor;
+}
+
+static inline int16_t read_sample(sampler_voice_t *sv, uint32_t i)
+{
+    if (i >= sv->entry->length) return 0;
+    if (sv->entry->format == SAMPLER_FORMAT_PCM16) return ((const int16_t *)sv->data)[i];
+
+    // ADPCM only moves forward, i is always the next sample to decode
+    return adpcm_decode(sv);
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief Size used by a bank, from its header to the end of its last sample
+ *
+ * @return 0 if the bank is not valid
+ */
+size_t sampler_bank_size(const void *bank, size_t size)
+{
+    const sampler_bank_header_t *header = bank;
+
+    if (size < sizeof(*header) || header->magic != SAMPLER_MAGIC || header->version != SAMPLER_VERSION) return 0;
+    if (sizeof(*header) + (size_t)header->count * sizeof(sampler_entry_t) > size) return 0;
+
+    const sampler_entry_t *table = (const sampler_entry_t *)(header + 1);
+    size_t used = sizeof(*header) + header->count * sizeof(sampler_entry_t);
+
+    for (int i = 0; i < header->count; ++i)
+    {
+        const sampler_entry_t *e = &table[i];
+        // In 64 bits, a length from the bank must not wrap into a small size
+        uint64_t bytes = e->format == SAMPLER_FORMAT_PCM16 ? (uint64_t)e->length * 2 : ((uint64_t)e->length + 1) / 2;
+
+        if (e->format > SAMPLER_FORMAT_IMA_ADPCM || e->rate_hz == 0 || e->root_note > 127) return 0;
+        if (e->format == SAMPLER_FORMAT_PCM16 && (e->offset & 1)) return 0;
+        if (e->offset > size || bytes > size - e->offset || e->adpcm_index > ADPCM_INDEX_MAX) return 0;
+        if (e->offset + bytes > used) used = e->offset + bytes;
+    }
+
+    return used;
+}
+
+esp_err_t sampler_init(const void *bank, size_t size)
+{
+    if (bank == NULL || sampler_bank_size(bank, size) == 0) return ESP_ERR_INVALID_ARG;
+
+    bank_base = bank;
+    entries = (const sampler_entry_t *)(bank_base + sizeof(sampler_bank_header_t));
+    entry_count = ((const sampler_bank_header_t *)bank)->count;
+
+    return ESP_OK;
+}
+
+const sampler_entry_t *sampler_find(uint8_t note)
+{
+    for (int i = 0; i < entry_count; ++i)
+    {
+        if (note >= entries[i].low_note && note <= entries[i].high_note) return &entries[i];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Read step for a voice whose oscillator would run at phase_inc
+ *
+ * Taking the note (and bend) as a phase increment keeps samples in tune
+ * with the oscillators: the step is the ratio to the root note increment.
+ */
+uint32_t sampler_step(const sampler_entry_t *entry, uint32_t phase_inc, uint32_t sampling_rate_hz)
+{
+    uint64_t num = (uint64_t)phase_inc * entry->rate_hz << SAMPLER_STEP_BITS;
+    uint64_t den = (uint64_t)note_table_phase_inc(entry->root_note) * sampling_rate_hz;
+
+    return den ? (uint32_t)(num / den) : STEP_ONE;
+}
+
+void sampler_start(sampler_voice_t *sv, const sampler_entry_t *entry)
+{
+    sv->entry = entry;
+    sv->data = bank_base + entry->offset;
+    sv->pos = 0;
+    sv->frac = 0;
+    sv->predictor = entry->adpcm_predictor;
+    sv->index = entry->adpcm_index;
+    sv->next = 0;
+    sv->s0 = read_sample(sv, 0);
+    sv->s1 = read_sample(sv, 1);
+}
+
+/**
+ * @brief Resample the next len samples
+ *
+ * @return false once the recording is over, the rest of out is silence
+ */
+bool sampler_render(sampler_voice_t *sv, int16_t *out, size_t len)
+{
+    uint32_t length = sv->entry->length;
+
+    for (size_t n = 0; n < len; ++n)
+    {
+        if (sv->pos >= length)
+        {
+            for (; n < len; ++n) out[n] = 0;
+            return false;
+        }
+
+        out[n] = sv->s0 + (((sv->s1 - sv->s0) * (int32_t)(sv->frac >> 1)) >> (SAMPLER_STEP_BITS - 1));
+
+        sv->frac += sv->step;
+        while (sv->frac >= STEP_ONE)
+        {
+            sv->frac -= STEP_ONE;
+            sv->pos++;
+            sv->s0 = sv->s1;
+            sv->s1 = read_sample(sv, sv->pos + 1);
+        }
+    }
+
+    return sv->pos < length;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file sampler.h
+ * @brief Recorded sample playback from an in-memory bank
+ *
+ * The bank is read in place (zero-copy) so it can live in memory-mapped
+ * flash. It starts with a header and a table of entries, each one a mono
+ * PCM16 or IMA-ADPCM recording with a root note and a key range. Voices
+ * resample by a Q16 step with linear interpolation, ADPCM is decoded on the
+ * fly as the read position moves forward.
+ *
+ * Bank images are built with firmware/tools/pack_samples.py.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define SAMPLER_MAGIC 0x4C504D53  // "SMPL", little endian
+#define SAMPLER_VERSION 1
+#define SAMPLER_STEP_BITS 16
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    SAMPLER_FORMAT_PCM16 = 0,
+    SAMPLER_FORMAT_IMA_ADPCM,  // Headerless nibble stream, low nibble first
+} sampler_format_t;
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;  // Entries following the header
+} sampler_bank_header_t;
+
+typedef struct
+{
+    uint32_t offset;  // Data start from the bank start
+    uint32_t length;  // Samples
+    uint16_t rate_hz;
+    uint8_t format;
+    uint8_t root_note;  // Played at rate_hz
+    uint8_t low_note;
+    uint8_t high_note;
+    uint8_t adpcm_index;  // Decoder state at the first sample
+    uint8_t reserved;
+    int16_t adpcm_predictor;
+    uint16_t reserved2;
+} sampler_entry_t;
+
+typedef struct
+{
+    const sampler_entry_t *entry;
+    const uint8_t *data;
+    uint32_t pos;   // Index of s0
+    uint32_t frac;  // Position between s0 and s1, Q16
+    uint32_t step;  // Q16 samples per output sample
+    int16_t s0;
+    int16_t s1;
+    // IMA-ADPCM decoder, next is the index of the next sample to decode
+    int32_t predictor;
+    int8_t index;
+    uint32_t next;
+} sampler_voice_t;
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+esp_err_t sampler_init(const void *bank, size_t size);
+size_t sampler_bank_size(const void *bank, size_t size);
+const sampler_entry_t *sampler_find(uint8_t note);
+uint32_t sampler_step(const sampler_entry_t *entry, uint32_t phase_inc, uint32_t sampling_rate_hz);
+void sampler_start(sampler_voice_t *sv, const sampler_entry_t *entry);
+bool sampler_render(sampler_voice_t *sv, int16_t *out, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !SAMPLER_H */
@@ -0,0 +1,462 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file sequencer.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "sequencer.h"
+#include "sdkconfig.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define STEPS_PER_BEAT CONFIG_INTERRUPTER_SYNTH_SEQ_STEPS_PER_BEAT
+#define CLOCKS_PER_STEP (SEQUENCER_CLOCKS_PER_BEAT / STEPS_PER_BEAT)
+_Static_assert(SEQUENCER_CLOCKS_PER_BEAT % STEPS_PER_BEAT == 0, "Steps per beat must divide 24");
+
+#define TEMPO_MIN_BPM 20
+#define TEMPO_MAX_BPM 300
+#define CLOCK_TIMEOUT_MS 500 // Back to the internal tempo after this long without clock
+#define DEFAULT_ROOT 60      // C4, for the pattern before any key
+#define DEFAULT_VELOCITY 100
+
+#if CONFIG_INTERRUPTER_SYNTH_SEQ_ARP_UP
+#define MODE_DEFAULT SEQUENCER_ARP_UP
+#elif CONFIG_INTERRUPTER_SYNTH_SEQ_ARP_DOWN
+#define MODE_DEFAULT SEQUENCER_ARP_DOWN
+#elif CONFIG_INTERRUPTER_SYNTH_SEQ_ARP_UP_DOWN
+#define MODE_DEFAULT SEQUENCER_ARP_UP_DOWN
+#elif CONFIG_INTERRUPTER_SYNTH_SEQ_ARP_PLAYED
+#define MODE_DEFAULT SEQUENCER_ARP_PLAYED
+#elif CONFIG_INTERRUPTER_SYNTH_SEQ_STEP
+#define MODE_DEFAULT SEQUENCER_STEP
+#else
+#define MODE_DEFAULT SEQUENCER_OFF
+#endif
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const int8_t default_pattern[] = {
+    0, 12, SEQUENCER_REST, 7, 0, SEQUENCER_REST, 10, 12, 0, 12, SEQUENCER_REST, 7, 3, SEQUENCER_REST, 5, 7};
+
+static sequencer_mode_t mode = SEQUENCER_OFF;
+static uint32_t sampling_rate_hz = 0;
+static uint8_t gate_pct = CONFIG_INTERRUPTER_SYNTH_SEQ_GATE_PCT;
+
+// Keys down, in the order they were pressed
+static uint8_t held_code[SEQUENCER_MAX_HELD];
+static uint8_t held_velocity[SEQUENCER_MAX_HELD];
+static uint8_t held_count = 0;
+static uint8_t channel = 0;
+static uint8_t root = DEFAULT_ROOT;
+static uint8_t velocity = DEFAULT_VELOCITY;
+
+static int8_t pattern[SEQUENCER_MAX_STEPS];
+static uint8_t pattern_len = 0;
+static uint32_t position = 0; // Steps played since the start
+
+// Internal clock: a step is step_num / step_den samples, the remainder keeps
+// the grid exact over time
+static uint32_t step_num = 0;
+static uint32_t step_den = 0;
+static uint32_t step_rem = 0;
+static uint32_t next_step = 0;
+
+// External MIDI clock
+static bool external = false;
+static bool transport = true;  // Cleared by stop, clock alone keeps it running
+static uint8_t clock_count = 0;
+static uint32_t last_clock = 0;  // Last tick, or start before the first one
+static bool ticking = false;      // last_clock is a tick
+static uint32_t clock_period = 0; // Smoothed, in samples
+static bool step_due = false;
+
+// Note-off of the last step
+static bool off_pending = false;
+static uint32_t off_time = 0;
+static uint8_t off_code = 0;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static inline bool is_before(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+
+/**
+ * @brief Whether steps have anything to play
+ */
+static inline bool has_source(void)
+{
+    return mode != SEQUENCER_OFF && (held_count > 0 || (mode == SEQUENCER_STEP && external));
+}
+
+static uint32_t gate_samples(void)
+{
+    uint32_t step = external && ticking && clock_period ? clock_period * CLOCKS_PER_STEP : step_num / step_den;
+    uint32_t gate = (uint32_t)((uint64_t)step * gate_pct / 100);
+
+    return gate ? gate : 1;
+}
+
+static void hold(uint8_t code, uint8_t vel)
+{
+    for (int i = 0; i < held_count; ++i)
+        if (held_code[i] == code) return;
+
+    // Full: the oldest key makes room
+    if (held_count == SEQUENCER_MAX_HELD)
+    {
+        memmove(held_code, held_code + 1, SEQUENCER_MAX_HELD - 1);
+        memmove(held_velocity, held_velocity + 1, SEQUENCER_MAX_HELD - 1);
+        held_count--;
+    }
+
+    held_code[held_count] = code;
+    held_velocity[held_count++] = vel;
+}
+
+/**
+ * @brief Let go of a held key
+ *
+ * @return false if the key was not held here, it may be sounding in the engine
+ */
+static bool release(uint8_t code)
+{
+    for (int i = 0; i < held_count; ++i)
+    {
+        if (held_code[i] != code) continue;
+
+        memmove(held_code + i, held_code + i + 1, held_count - i - 1);
+        memmove(held_velocity + i, held_velocity + i + 1, held_count - i - 1);
+        held_count--;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Note of the step at the current position, false for a rest
+ */
+static bool step_note(uint8_t *code, uint8_t *vel)
+{
+    uint32_t pos = position++;
+
+    if (mode == SEQUENCER_STEP)
+    {
+        int8_t offset = pattern[pos % pattern_len];
+        if (offset == SEQUENCER_REST) return false;
+
+        int note = root + offset;
+        if (note < 0 || note > 127) return false;
+        *code = note;
+        *vel = velocity;
+        return true;
+    }
+
+    // Index in the held keys, sorted for the directional modes
+    uint8_t n = held_count;
+    uint8_t i = pos % n;
+    if (mode == SEQUENCER_ARP_UP_DOWN && n > 1)
+    {
+        uint32_t period = 2 * n - 2; // Ends are not repeated
+        i = pos % period;
+        if (i >= n) i = period - i;
+    }
+
+    if (mode == SEQUENCER_ARP_PLAYED)
+    {
+        *code = held_code[i];
+        *vel = held_velocity[i];
+        return true;
+    }
+
+    // Rank i from the bottom (or the top going down) without sorting the keys
+    if (mode == SEQUENCER_ARP_DOWN) i = n - 1 - i;
+    for (int k = 0; k < n; ++k)
+    {
+        uint8_t below = 0;
+        for (int j = 0; j < n; ++j) below += held_code[j] < held_code[k];
+        if (below != i) continue;
+
+        *code = held_code[k];
+        *vel = held_velocity[k];
+        return true;
+    }
+
+    return false;
+}
+
+static void restart(void)
+{
+    position = 0;
+    clock_count = 0;
+}
+
+/**
+ * @brief Back to the internal tempo once the clock has been silent too long
+ *
+ * Held keys go on from the given sample, on a new grid.
+ */
+static void check_clock(uint32_t time)
+{
+    if (!external || !is_before(last_clock + sampling_rate_hz / 1000 * CLOCK_TIMEOUT_MS, time)) return;
+
+    external = ticking = false;
+    step_due = false;
+    restart();
+    next_step = time;
+    step_rem = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void sequencer_init(uint32_t rate_hz)
+{
+    sampling_rate_hz = rate_hz;
+    mode = MODE_DEFAULT;
+    held_count = 0;
+    external = false;
+    transport = true;
+    step_due = off_pending = false;
+
+    sequencer_set_tempo(CONFIG_INTERRUPTER_SYNTH_SEQ_BPM);
+    sequencer_set_pattern(default_pattern, sizeof(default_pattern));
+    restart();
+}
+
+esp_err_t sequencer_set_mode(sequencer_mode_t m)
+{
+    if (m >= SEQUENCER_MODE_COUNT) return ESP_ERR_INVALID_ARG;
+
+    // Keys held before the change were not sounding, they start over
+    if (m != mode) held_count = 0;
+    mode = m;
+
+    return ESP_OK;
+}
+
+esp_err_t sequencer_set_tempo(uint16_t bpm)
+{
+    if (bpm < TEMPO_MIN_BPM || bpm > TEMPO_MAX_BPM) return ESP_ERR_INVALID_ARG;
+
+    step_num = sampling_rate_hz * 60;
+    step_den = (uint32_t)bpm * STEPS_PER_BEAT;
+    step_rem = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t sequencer_set_gate(uint8_t pct)
+{
+    if (pct == 0 || pct > 100) return ESP_ERR_INVALID_ARG;
+
+    gate_pct = pct;
+
+    return ESP_OK;
+}
+
+esp_err_t sequencer_set_pattern(const int8_t *steps, uint8_t len)
+{
+    if (len == 0 || len > SEQUENCER_MAX_STEPS) return ESP_ERR_INVALID_ARG;
+
+    memcpy(pattern, steps, len);
+    pattern_len = len;
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Offer a live event to the sequencer at its play clock sample
+ *
+ * @return true if the event was taken, false if it goes on to the engine
+ */
+bool sequencer_input(const synth_cmd_t *cmd, uint32_t time)
+{
+    if (cmd->type == SYNTH_CMD_REALTIME)
+    {
+        switch (cmd->data1)
+        {
+        case SEQUENCER_RT_CLOCK:
+            if (ticking)
+            {
+                // Light smoothing, USB delivers the ticks with some jitter
+                int32_t delta = (int32_t)(time - last_clock - clock_period);
+                clock_period = clock_period ? clock_period + delta / 4 : time - last_clock;
+            }
+            external = ticking = true;
+            last_clock = time;
+
+            if (transport && clock_count == 0)
+            {
+                step_due = true;
+                next_step = time;
+            }
+            if (transport) clock_count = (clock_count + 1) % CLOCKS_PER_STEP;
+            break;
+        case SEQUENCER_RT_START:
+            restart();
+            // fall through
+        case SEQUENCER_RT_CONTINUE:
+            // Clock follows, the next step waits for it
+            transport = true;
+            step_due = false;
+            if (external) break;
+            external = true;
+            ticking = false;
+            clock_period = 0;
+            last_clock = time;
+            break;
+        case SEQUENCER_RT_STOP:
+            transport = false;
+            step_due = false;
+            if (off_pending) off_time = time;
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
+
+    if (cmd->type == SYNTH_CMD_CONTROL_CHANGE && cmd->data1 == SEQUENCER_CC_MODE)
+    {
+        sequencer_set_mode(cmd->data2 * SEQUENCER_MODE_COUNT / 128);
+        return true;
+    }
+    if (cmd->type == SYNTH_CMD_CONTROL_CHANGE && cmd->data1 == SEQUENCER_CC_TEMPO)
+    {
+        sequencer_set_tempo(40 + 2 * cmd->data2);
+        return true;
+    }
+    if (cmd->type == SYNTH_CMD_CONTROL_CHANGE
+        && (cmd->data1 == SYNTH_CC_ALL_NOTES_OFF || cmd->data1 == SYNTH_CC_RESET_CONTROLLERS))
+    {
+        // Keys are let go here too, the engine still gets the message
+        held_count = 0;
+        return false;
+    }
+
+    // Drums are played as they come, a roll is not arpeggiated
+    if (cmd->channel == SYNTH_PERCUSSION_CHANNEL) return false;
+    if (mode == SEQUENCER_OFF) return false;
+
+    if (cmd->type == SYNTH_CMD_NOTE_ON && cmd->data2 > 0)
+    {
+        check_clock(time);
+
+        // First key on the internal clock starts the grid at once
+        if (!external && held_count == 0)
+        {
+            restart();
+            next_step = time;
+            step_rem = 0;
+        }
+
+        hold(cmd->data1, cmd->data2);
+        channel = cmd->channel;
+        root = cmd->data1;
+        velocity = cmd->data2;
+        return true;
+    }
+    if (cmd->type == SYNTH_CMD_NOTE_ON || cmd->type == SYNTH_CMD_NOTE_OFF)
+    {
+        // A key pressed before the mode changed sounds in the engine, its
+        // release goes there
+        return release(cmd->data1);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Follow the play clock, from each render tick
+ *
+ * Without it, a clock that stops while keys are held would only be noticed
+ * at the next key.
+ */
+void sequencer_poll(uint32_t time)
+{
+    // Stopped, the keys wait for the clock or the next key
+    if (transport) check_clock(time);
+}
+
+/**
+ * @brief Play clock sample of the next event the sequencer will output
+ */
+bool sequencer_next(uint32_t *time)
+{
+    bool step = has_source() && (external ? step_due : true);
+    if (external && !has_source()) step_due = false;
+
+    if (off_pending && (!step || !is_before(next_step, off_time)))
+        *time = off_time;
+    else if (step)
+        *time = next_step;
+    else
+        return false;
+
+    return true;
+}
+
+/**
+ * @brief Take the next event due at or before the given sample
+ *
+ * @return false when nothing is due
+ */
+bool sequencer_pop(uint32_t time, synth_cmd_t *cmd)
+{
+    uint32_t due;
+
+    while (sequencer_next(&due) && !is_before(time, due))
+    {
+        // A step cuts the previous note short if the gate reaches it
+        if (off_pending && (due == off_time || due == next_step))
+        {
+            *cmd = (synth_cmd_t){.type = SYNTH_CMD_NOTE_OFF, .channel = channel, .data1 = off_code};
+            off_pending = false;
+            return true;
+        }
+
+        // Step
+        uint32_t at = next_step;
+        if (external)
+        {
+            step_due = false;
+        }
+        else
+        {
+            next_step += step_num / step_den;
+            step_rem += step_num % step_den;
+            if (step_rem >= step_den)
+            {
+                step_rem -= step_den;
+                next_step++;
+            }
+        }
+
+        uint8_t code, vel;
+        if (!step_note(&code, &vel)) continue;
+
+        *cmd = (synth_cmd_t){.type = SYNTH_CMD_NOTE_ON, .channel = channel, .data1 = code, .data2 = vel};
+        off_pending = true;
+        off_time = at + gate_samples();
+        off_code = code;
+        return true;
+    }
+
+    return false;
+}
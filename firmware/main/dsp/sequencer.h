@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file sequencer.h
+ * @brief Arpeggiator and step sequencer on the synth sample clock
+ *
+ * Sits between the live MIDI events and the engine, in the render context.
+ * Keys are held here instead of sounding; steps play the held chord one note
+ * at a time, or the stored pattern transposed to the last key. Every time is
+ * a play clock sample, so steps land on their exact sample whatever the tick
+ * rate of the tasks feeding it.
+ *
+ * Steps follow MIDI clock (24 per beat) as long as it is received, with
+ * start, continue and stop. Without it they run at the internal tempo from
+ * the first key pressed, or from half a second after the last tick when the
+ * clock goes silent with no stop.
+ *
+ * Notes of the drum channel are never taken, they go on to the engine.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef SEQUENCER_H
+#define SEQUENCER_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/synth_engine.h"
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define SEQUENCER_MAX_HELD 16
+#define SEQUENCER_MAX_STEPS 32
+#define SEQUENCER_REST INT8_MIN   // Pattern step that plays nothing
+#define SEQUENCER_CLOCKS_PER_BEAT 24
+
+// MIDI controllers (undefined in the General MIDI set) taken by the sequencer
+#define SEQUENCER_CC_MODE (3)     // Value split evenly over the modes
+#define SEQUENCER_CC_TEMPO (9)    // 40 + 2 * value BPM
+
+// MIDI real time messages, carried in data1 of SYNTH_CMD_REALTIME
+#define SEQUENCER_RT_CLOCK (0xF8)
+#define SEQUENCER_RT_START (0xFA)
+#define SEQUENCER_RT_CONTINUE (0xFB)
+#define SEQUENCER_RT_STOP (0xFC)
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    SEQUENCER_OFF = 0,
+    SEQUENCER_ARP_UP,
+    SEQUENCER_ARP_DOWN,
+    SEQUENCER_ARP_UP_DOWN,
+    SEQUENCER_ARP_PLAYED,    // In the order the keys went down
+    SEQUENCER_STEP,
+    SEQUENCER_MODE_COUNT
+} sequencer_mode_t;
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void sequencer_init(uint32_t sampling_rate_hz);
+esp_err_t sequencer_set_mode(sequencer_mode_t mode);
+esp_err_t sequencer_set_tempo(uint16_t bpm);
+esp_err_t sequencer_set_gate(uint8_t pct);
+esp_err_t sequencer_set_pattern(const int8_t *steps, uint8_t len);
+bool sequencer_input(const synth_cmd_t *cmd, uint32_t time);
+void sequencer_poll(uint32_t time);
+bool sequencer_next(uint32_t *time);
+bool sequencer_pop(uint32_t time, synth_cmd_t *cmd);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !SEQUENCER_H */
@@ -0,0 +1,680 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file synth_engine.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "synth_engine.h"
+#include "dsp/mixer.h"
+#include "dsp/note_table.h"
+#include "dsp/percussion.h"
+#include "dsp/sampler.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define BEND_BITS 13
+#define BEND_CENTER (1 << BEND_BITS)
+#define BEND_RANGE_DEFAULT 2 // Semitones
+#define RPN_NULL 0x7F
+#define RPN_BEND_RANGE 0x00
+#define VIBRATO_DEPTH_MAX (CONFIG_INTERRUPTER_SYNTH_VIBRATO_CENTS * NOTE_TABLE_FINE_STEPS / 100)
+
+#define NO_VOICE 0xFF
+#define VOICE_MASK_ALL (UINT32_MAX >> (32 - SYNTH_MAX_CHORD_SIZE))
+
+_Static_assert(SYNTH_MAX_CHORD_SIZE >= 1 && SYNTH_MAX_CHORD_SIZE <= 32, "Voices are tracked in a 32-bit mask");
+_Static_assert(VELOCITY_GAIN_BITS == MIXER_GAIN_BITS, "Voice gains go to the mixer as they are");
+
+#if CONFIG_INTERRUPTER_SYNTH_STEAL_QUIETEST
+#define STEAL_POLICY_DEFAULT SYNTH_STEAL_QUIETEST
+#elif CONFIG_INTERRUPTER_SYNTH_STEAL_LOWEST
+#define STEAL_POLICY_DEFAULT SYNTH_STEAL_LOWEST
+#elif CONFIG_INTERRUPTER_SYNTH_STEAL_RETRIGGER
+#define STEAL_POLICY_DEFAULT SYNTH_STEAL_RETRIGGER
+#else
+#define STEAL_POLICY_DEFAULT SYNTH_STEAL_OLDEST
+#endif
+
+#define ENVELOPE_DEFAULT                                                                                               \
+    {                                                                                                                  \
+        .attack_ms = CONFIG_INTERRUPTER_SYNTH_ATTACK_MS, .decay_ms = CONFIG_INTERRUPTER_SYNTH_DECAY_MS,                \
+        .sustain_level = CONFIG_INTERRUPTER_SYNTH_SUSTAIN_PCT * 32767 / 100,                                           \
+        .release_ms = CONFIG_INTERRUPTER_SYNTH_RELEASE_MS,                                                             \
+    }
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    wavetable_shape_t shape;
+    const fm_patch_t *fm; // Replaces the shape when set
+    bool sampler;         // Plays the sample bank instead of oscillators
+    envelope_config_t envelope;
+    bool sustain;
+    bool sostenuto;
+    int16_t bend;           // -8192..8191
+    uint8_t bend_range;     // Semitones
+    int16_t vibrato_depth;  // Fine steps at full LFO swing, from the mod wheel
+    uint8_t rpn_msb;
+    uint8_t rpn_lsb;
+} channel_data_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+/*
+ * Voices are stored as parallel arrays so the render loop only streams the
+ * state it needs, and the set of sounding voices is a bitmask: rendering and
+ * control updates cost per active voice, finding a free one is a single ctz.
+ *
+ * A voice is active as long as its envelope is not idle: the key flags only
+ * decide when the release starts, the release tail keeps the slot until the
+ * envelope reaches zero.
+ */
+static uint32_t voice_phase[SYNTH_MAX_CHORD_SIZE];
+static uint32_t voice_inc[SYNTH_MAX_CHORD_SIZE];
+static int32_t voice_gain[SYNTH_MAX_CHORD_SIZE]; // Q15, from velocity
+static const int16_t *voice_table[SYNTH_MAX_CHORD_SIZE];
+static envelope_t voice_env[SYNTH_MAX_CHORD_SIZE];
+static uint8_t voice_code[SYNTH_MAX_CHORD_SIZE];
+static uint8_t voice_channel[SYNTH_MAX_CHORD_SIZE];
+static uint32_t voice_age[SYNTH_MAX_CHORD_SIZE]; // Note-on order, for stealing
+
+// FM voices only
+static const fm_patch_t *voice_fm[SYNTH_MAX_CHORD_SIZE];
+static uint32_t voice_mod_phase[SYNTH_MAX_CHORD_SIZE];
+static uint32_t voice_mod_inc[SYNTH_MAX_CHORD_SIZE];
+static envelope_t voice_index_env[SYNTH_MAX_CHORD_SIZE];
+
+// Sample voices only
+static uint32_t sampler_mask = 0;
+static sampler_voice_t voice_sampler[SYNTH_MAX_CHORD_SIZE];
+
+static uint32_t active_mask = 0;
+static uint32_t key_down_mask = 0;
+static uint32_t sostenuto_mask = 0; // Key was down when the sostenuto pedal was pressed
+
+static channel_data_t channels[SYNTH_CHANNEL_COUNT] = {0};
+static velocity_curve_t velocity_curve = VELOCITY_CURVE_LINEAR;
+
+// Last voice started for each channel/note, validated against the voice itself
+static uint8_t voice_index[SYNTH_CHANNEL_COUNT][NOTE_TABLE_SIZE];
+static synth_steal_policy_t steal_policy = STEAL_POLICY_DEFAULT;
+static uint32_t age_counter = 0;
+static synth_engine_stats_t stats = {0};
+
+static uint32_t lfo_phase = 0;
+static uint32_t lfo_inc = 0;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void release_if_unheld(int v)
+{
+    const channel_data_t *ch = &channels[voice_channel[v]];
+    uint32_t bit = 1UL << v;
+
+    if (!(active_mask & bit) || (key_down_mask & bit)) return;
+    if (ch->sustain || (ch->sostenuto && (sostenuto_mask & bit))) return;
+
+    // A zero release goes idle right away
+    envelope_release(&voice_env[v]);
+    if (voice_fm[v]) envelope_release(&voice_index_env[v]);
+    if (voice_env[v].stage == ENVELOPE_STAGE_IDLE) active_mask &= ~bit;
+}
+
+static inline int lookup_voice(uint8_t code, uint8_t channel)
+{
+    uint8_t v = voice_index[channel][code];
+    if (v == NO_VOICE || !(active_mask & (1UL << v))) return -1;
+    if (voice_code[v] != code || voice_channel[v] != channel) return -1;
+
+    return v;
+}
+
+static uint32_t steal_score(int v)
+{
+    switch (steal_policy)
+    {
+    case SYNTH_STEAL_QUIETEST:
+        return (uint32_t)(voice_env[v].level >> ENVELOPE_OUT_BITS) * voice_gain[v] >> VELOCITY_GAIN_BITS;
+    case SYNTH_STEAL_LOWEST:
+        return voice_code[v];
+    default:
+        return ~(age_counter - voice_age[v]); // Notes struck since, inverted: oldest lowest, wrap safe
+    }
+}
+
+static int pick_voice(void)
+{
+    uint32_t free_mask = ~active_mask & VOICE_MASK_ALL;
+    if (free_mask) return __builtin_ctz(free_mask);
+
+    uint32_t releasing = 0;
+    for (uint32_t m = active_mask; m; m &= m - 1)
+    {
+        int v = __builtin_ctz(m);
+        if (voice_env[v].stage == ENVELOPE_STAGE_RELEASE) releasing |= 1UL << v;
+    }
+
+    // Full: take the best candidate among release tails first, then among all
+    int victim = -1;
+    uint32_t best = UINT32_MAX;
+
+    for (uint32_t m = releasing ? releasing : active_mask; m; m &= m - 1)
+    {
+        int v = __builtin_ctz(m);
+        uint32_t score = steal_score(v);
+        if (victim < 0 || score < best)
+        {
+            victim = v;
+            best = score;
+        }
+    }
+
+    if (victim >= 0) stats.steals++;
+
+    return victim;
+}
+
+static esp_err_t control_change(channel_data_t *ch, uint8_t controller, uint8_t value)
+{
+    switch (controller)
+    {
+    case SYNTH_CC_MODULATION:
+        ch->vibrato_depth = value * VIBRATO_DEPTH_MAX / 127;
+        return ESP_OK;
+    case SYNTH_CC_RPN_MSB:
+        ch->rpn_msb = value;
+        return ESP_OK;
+    case SYNTH_CC_RPN_LSB:
+        ch->rpn_lsb = value;
+        return ESP_OK;
+    case SYNTH_CC_DATA_ENTRY:
+        // Only the pitch bend sensitivity RPN is implemented, cents are ignored
+        if (ch->rpn_msb != 0 || ch->rpn_lsb != RPN_BEND_RANGE) return ESP_ERR_NOT_SUPPORTED;
+        ch->bend_range = value > 24 ? 24 : value;
+        return ESP_OK;
+    default:
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+}
+
+/**
+ * @brief Recompute the increments of the sounding voices at control rate
+ *
+ * Bend and vibrato are summed in fine steps and applied through the fine
+ * tuning table: no float and no exponent math.
+ */
+static void update_pitch(int32_t lfo)
+{
+    for (uint32_t m = active_mask; m; m &= m - 1)
+    {
+        int v = __builtin_ctz(m);
+        const channel_data_t *ch = &channels[voice_channel[v]];
+        int32_t fine = ((int32_t)ch->bend * (ch->bend_range << NOTE_TABLE_FINE_BITS) + BEND_CENTER / 2) >> BEND_BITS;
+        fine += (lfo * ch->vibrato_depth) >> 15;
+
+        voice_inc[v] = fine ? note_table_phase_inc_fine(voice_code[v], fine) : note_table_phase_inc(voice_code[v]);
+        if (voice_fm[v]) voice_mod_inc[v] = fm_mod_inc(voice_inc[v], voice_fm[v]->ratio);
+        if (sampler_mask & (1UL << v))
+            voice_sampler[v].step = sampler_step(voice_sampler[v].entry, voice_inc[v], SYNTH_SAMPLING_RATE_HZ);
+    }
+}
+
+/**
+ * @return false once the recording is over
+ */
+static inline bool render_sample_voice(int16_t *restrict buf, size_t len, int v)
+{
+    envelope_t *env = &voice_env[v];
+    bool playing = sampler_render(&voice_sampler[v], buf, len);
+
+    for (size_t n = 0; n < len; ++n) buf[n] = (buf[n] * envelope_step(env)) >> ENVELOPE_OUT_BITS;
+
+    return playing;
+}
+
+static inline void render_wavetable_voice(int16_t *restrict buf, size_t len, int v)
+{
+    envelope_t *env = &voice_env[v];
+    const int16_t *table = voice_table[v];
+    uint32_t phase = voice_phase[v];
+    uint32_t inc = voice_inc[v];
+
+    for (size_t n = 0; n < len; ++n)
+    {
+        phase += inc;
+        int32_t sample = wavetable_read(table, phase);
+
+        buf[n] = (sample * envelope_step(env)) >> ENVELOPE_OUT_BITS;
+    }
+
+    voice_phase[v] = phase;
+}
+
+static inline void render_fm_voice(int16_t *restrict buf, size_t len, int v)
+{
+    const int16_t *sine = wavetable_sine();
+    envelope_t *env = &voice_env[v];
+    envelope_t *index_env = &voice_index_env[v];
+    uint32_t phase = voice_phase[v];
+    uint32_t inc = voice_inc[v];
+    uint32_t mod_phase = voice_mod_phase[v];
+    uint32_t mod_inc = voice_mod_inc[v];
+    int32_t depth = voice_fm[v]->depth;
+
+    for (size_t n = 0; n < len; ++n)
+    {
+        phase += inc;
+        mod_phase += mod_inc;
+        int32_t deviation = (depth * envelope_step(index_env)) >> ENVELOPE_OUT_BITS;
+        int32_t sample = wavetable_read(sine, phase + fm_phase_offset(wavetable_read(sine, mod_phase), deviation));
+
+        buf[n] = (sample * envelope_step(env)) >> ENVELOPE_OUT_BITS;
+    }
+
+    voice_phase[v] = phase;
+    voice_mod_phase[v] = mod_phase;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void synth_engine_init(void)
+{
+    note_table_init();
+    wavetable_init();
+    velocity_init();
+    mixer_init(SYNTH_MAX_CHORD_SIZE, CONFIG_INTERRUPTER_SYNTH_VOICE_GAIN_PCT);
+    percussion_init(SYNTH_SAMPLING_RATE_HZ);
+
+    // Every voice silent and in phase, a second init plays like the first
+    active_mask = key_down_mask = sostenuto_mask = sampler_mask = 0;
+    memset(voice_phase, 0, sizeof(voice_phase));
+    memset(voice_mod_phase, 0, sizeof(voice_mod_phase));
+    memset(voice_env, 0, sizeof(voice_env));
+    memset(voice_index_env, 0, sizeof(voice_index_env));
+    memset(voice_index, NO_VOICE, sizeof(voice_index));
+    velocity_curve = VELOCITY_CURVE_LINEAR;
+    steal_policy = STEAL_POLICY_DEFAULT;
+    age_counter = 0;
+    stats = (synth_engine_stats_t){0};
+    lfo_phase = 0;
+
+    for (int i = 0; i < SYNTH_CHANNEL_COUNT; ++i)
+    {
+        channels[i] = (channel_data_t){.envelope = ENVELOPE_DEFAULT,
+            .bend_range = BEND_RANGE_DEFAULT,
+            .rpn_msb = RPN_NULL,
+            .rpn_lsb = RPN_NULL};
+    }
+
+    lfo_inc = (uint32_t)(CONFIG_INTERRUPTER_SYNTH_VIBRATO_RATE_DHZ / 10.0 / SYNTH_SAMPLING_RATE_HZ * 4294967296.0);
+}
+
+esp_err_t synth_engine_apply(const synth_cmd_t *cmd)
+{
+    switch (cmd->type)
+    {
+    case SYNTH_CMD_NOTE_ON:
+        return synth_engine_note_on(cmd->data1, cmd->channel, cmd->data2);
+    case SYNTH_CMD_NOTE_OFF:
+        return synth_engine_note_off(cmd->data1, cmd->channel);
+    case SYNTH_CMD_PROGRAM_CHANGE:
+        return synth_engine_set_program(cmd->channel, cmd->data1);
+    case SYNTH_CMD_CONTROL_CHANGE:
+        // Pedals are on from value 64
+        switch (cmd->data1)
+        {
+        case SYNTH_CC_SUSTAIN:
+            return synth_engine_set_sustain(cmd->channel, cmd->data2 >= 64);
+        case SYNTH_CC_SOSTENUTO:
+            return synth_engine_set_sostenuto(cmd->channel, cmd->data2 >= 64);
+        case SYNTH_CC_RESET_CONTROLLERS:
+            if (cmd->channel >= SYNTH_CHANNEL_COUNT) return ESP_ERR_INVALID_ARG;
+            channels[cmd->channel].bend = 0;
+            channels[cmd->channel].vibrato_depth = 0;
+            channels[cmd->channel].rpn_msb = channels[cmd->channel].rpn_lsb = RPN_NULL;
+            synth_engine_set_sostenuto(cmd->channel, false);
+            return synth_engine_set_sustain(cmd->channel, false);
+        case SYNTH_CC_ALL_NOTES_OFF:
+            return synth_engine_all_notes_off(cmd->channel);
+        default:
+            if (cmd->channel >= SYNTH_CHANNEL_COUNT) return ESP_ERR_INVALID_ARG;
+            return control_change(&channels[cmd->channel], cmd->data1, cmd->data2);
+        }
+    case SYNTH_CMD_PITCH_BEND:
+        return synth_engine_pitch_bend(cmd->channel, ((cmd->data2 << 7) | cmd->data1) - BEND_CENTER);
+    case SYNTH_CMD_REALTIME:
+        return ESP_ERR_NOT_SUPPORTED; // Timing is the sequencer's business
+    case SYNTH_CMD_SETTING:
+        switch (cmd->data1)
+        {
+        case SYNTH_SETTING_VELOCITY_CURVE:
+            return synth_engine_set_velocity_curve(cmd->data2);
+        case SYNTH_SETTING_STEAL_POLICY:
+            return synth_engine_set_steal_policy(cmd->data2);
+        default:
+            return ESP_ERR_INVALID_ARG;
+        }
+    default:
+        return ESP_ERR_INVALID_ARG;
+    }
+}
+
+esp_err_t synth_engine_note_on(uint8_t code, uint8_t channel, uint8_t velocity)
+{
+    if (channel >= SYNTH_CHANNEL_COUNT || code >= NOTE_TABLE_SIZE) return ESP_ERR_INVALID_ARG;
+    if (channel == SYNTH_PERCUSSION_CHANNEL) return percussion_trigger(code, velocity_gain(velocity_curve, velocity));
+
+    const sampler_entry_t *sample = NULL;
+    if (channels[channel].sampler)
+    {
+        sample = sampler_find(code);
+        if (sample == NULL) return ESP_ERR_NOT_FOUND;
+    }
+
+    int v = lookup_voice(code, channel);
+    if (v >= 0 && steal_policy != SYNTH_STEAL_RETRIGGER)
+    {
+        // Same key struck twice: let the previous one go instead of sticking
+        if (key_down_mask & (1UL << v))
+        {
+            key_down_mask &= ~(1UL << v);
+            release_if_unheld(v);
+        }
+        v = -1;
+    }
+
+    if (v >= 0)
+    {
+        stats.retriggers++;
+    }
+    else
+    {
+        v = pick_voice();
+        if (v < 0) return ESP_ERR_NO_MEM;
+
+        if ((active_mask & (1UL << v)) && voice_index[voice_channel[v]][voice_code[v]] == v)
+            voice_index[voice_channel[v]][voice_code[v]] = NO_VOICE;
+        voice_index[channel][code] = v;
+    }
+
+    uint32_t bit = 1UL << v;
+    voice_code[v] = code;
+    voice_channel[v] = channel;
+    voice_age[v] = ++age_counter;
+    voice_inc[v] = note_table_phase_inc(code);
+    voice_gain[v] = velocity_gain(velocity_curve, velocity);
+    voice_table[v] = wavetable_get(channels[channel].shape, code);
+    voice_fm[v] = channels[channel].fm;
+    if (voice_fm[v])
+    {
+        voice_mod_inc[v] = fm_mod_inc(voice_inc[v], voice_fm[v]->ratio);
+        // Operators of a silent voice restart in phase and from no index so
+        // every strike sounds the same, a sounding one keeps running to avoid
+        // a click. The index outlives the voice when its release is longer.
+        if (!(active_mask & bit))
+        {
+            voice_phase[v] = voice_mod_phase[v] = 0;
+            voice_index_env[v] = (envelope_t){.stage = ENVELOPE_STAGE_IDLE};
+        }
+        envelope_start(&voice_index_env[v], &voice_fm[v]->index_env, SYNTH_SAMPLING_RATE_HZ);
+    }
+    if (sample)
+    {
+        sampler_start(&voice_sampler[v], sample);
+        voice_sampler[v].step = sampler_step(sample, voice_inc[v], SYNTH_SAMPLING_RATE_HZ);
+        sampler_mask |= bit;
+    }
+    else
+    {
+        sampler_mask &= ~bit;
+    }
+    // A stolen or retriggered voice ramps from its current level
+    envelope_start(&voice_env[v], &channels[channel].envelope, SYNTH_SAMPLING_RATE_HZ);
+    active_mask |= bit;
+    key_down_mask |= bit;
+    sostenuto_mask &= ~bit;
+
+    stats.notes++;
+
+    return ESP_OK;
+}
+
+esp_err_t synth_engine_note_off(uint8_t code, uint8_t channel)
+{
+    if (channel >= SYNTH_CHANNEL_COUNT || code >= NOTE_TABLE_SIZE) return ESP_ERR_INVALID_ARG;
+    if (channel == SYNTH_PERCUSSION_CHANNEL) return ESP_OK; // Drums are one-shot
+
+    int v = lookup_voice(code, channel);
+    if (v < 0 || !(key_down_mask & (1UL << v))) return ESP_ERR_INVALID_STATE;
+
+    key_down_mask &= ~(1UL << v);
+    release_if_unheld(v);
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Release every key of a channel, pedals still hold their notes
+ */
+esp_err_t synth_engine_all_notes_off(uint8_t channel)
+{
+    if (channel >= SYNTH_CHANNEL_COUNT) return ESP_ERR_INVALID_ARG;
+
+    for (uint32_t m = key_down_mask; m; m &= m - 1)
+    {
+        int v = __builtin_ctz(m);
+        if (voice_channel[v] != channel) continue;
+
+        key_down_mask &= ~(1UL << v);
+        release_if_unheld(v);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t synth_engine_set_shape(uint8_t channel, wavetable_shape_t shape)
+{
+    if (channel >= SYNTH_CHANNEL_COUNT || shape >= WAVETABLE_SHAPE_COUNT) return ESP_ERR_INVALID_ARG;
+
+    // Sounding notes keep their table, the shape applies from the next note-on
+    channels[channel].shape = shape;
+    channels[channel].fm = NULL;
+    channels[channel].sampler = false;
+
+    return ESP_OK;
+}
+
+esp_err_t synth_engine_set_fm_patch(uint8_t channel, fm_patch_id_t patch)
+{
+    if (channel >= SYNTH_CHANNEL_COUNT || patch >= FM_PATCH_COUNT) return ESP_ERR_INVALID_ARG;
+
+    channels[channel].fm = fm_patch_get(patch);
+    channels[channel].sampler = false;
+
+    return ESP_OK;
+}
+
+esp_err_t synth_engine_set_program(uint8_t channel, uint8_t program)
+{
+    // Programs cycle through the waveforms, the FM patches, then the samples
+    program %= WAVETABLE_SHAPE_COUNT + FM_PATCH_COUNT + 1;
+    if (program < WAVETABLE_SHAPE_COUNT) return synth_engine_set_shape(channel, program);
+    if (program < WAVETABLE_SHAPE_COUNT + FM_PATCH_COUNT)
+        return synth_engine_set_fm_patch(channel, program - WAVETABLE_SHAPE_COUNT);
+
+    return synth_engine_set_sampler(channel);
+}
+
+esp_err_t synth_engine_set_sampler(uint8_t channel)
+{
+    if (channel >= SYNTH_CHANNEL_COUNT) return ESP_ERR_INVALID_ARG;
+
+    // Notes without a sample in the bank are refused at note-on
+    channels[channel].sampler = true;
+
+    return ESP_OK;
+}
+
+esp_err_t synth_engine_set_envelope(uint8_t channel, const envelope_config_t *cfg)
+{
+    if (channel >= SYNTH_CHANNEL_COUNT || cfg == NULL) return ESP_ERR_INVALID_ARG;
+
+    channels[channel].envelope = *cfg;
+
+    return ESP_OK;
+}
+
+esp_err_t synth_engine_set_sustain(uint8_t channel, bool on)
+{
+    if (channel >= SYNTH_CHANNEL_COUNT) return ESP_ERR_INVALID_ARG;
+
+    channels[channel].sustain = on;
+    if (on) return ESP_OK;
+
+    for (uint32_t m = active_mask; m; m &= m - 1)
+    {
+        int v = __builtin_ctz(m);
+        if (voice_channel[v] == channel) release_if_unheld(v);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t synth_engine_set_sostenuto(uint8_t channel, bool on)
+{
+    if (channel >= SYNTH_CHANNEL_COUNT) return ESP_ERR_INVALID_ARG;
+
+    channels[channel].sostenuto = on;
+
+    for (uint32_t m = active_mask; m; m &= m - 1)
+    {
+        int v = __builtin_ctz(m);
+        if (voice_channel[v] != channel) continue;
+
+        // Only the keys held at the moment the pedal goes down are latched
+        uint32_t bit = 1UL << v;
+        if (on)
+            sostenuto_mask = (sostenuto_mask & ~bit) | (key_down_mask & bit);
+        else
+            release_if_unheld(v);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t synth_engine_pitch_bend(uint8_t channel, int16_t bend)
+{
+    if (channel >= SYNTH_CHANNEL_COUNT || bend < -BEND_CENTER || bend >= BEND_CENTER) return ESP_ERR_INVALID_ARG;
+
+    // Picked up by the sounding voices at the next control update
+    channels[channel].bend = bend;
+
+    return ESP_OK;
+}
+
+esp_err_t synth_engine_set_velocity_curve(velocity_curve_t curve)
+{
+    if (curve >= VELOCITY_CURVE_COUNT) return ESP_ERR_INVALID_ARG;
+
+    velocity_curve = curve;
+
+    return ESP_OK;
+}
+
+esp_err_t synth_engine_set_steal_policy(synth_steal_policy_t policy)
+{
+    if (policy >= SYNTH_STEAL_COUNT) return ESP_ERR_INVALID_ARG;
+
+    steal_policy = policy;
+
+    return ESP_OK;
+}
+
+void synth_engine_get_stats(synth_engine_stats_t *out) { *out = stats; }
+
+uint8_t synth_engine_active_voices(void) { return __builtin_popcount(active_mask); }
+
+void synth_engine_begin_chunk(size_t len)
+{
+    update_pitch(wavetable_read(wavetable_sine(), lfo_phase));
+    lfo_phase += lfo_inc * len;
+}
+
+uint32_t synth_engine_voice_mask(void) { return active_mask; }
+
+uint32_t synth_engine_render_voices(int32_t *restrict acc, size_t len, uint32_t voices)
+{
+    // Aligned for the vector mixer, acc is wherever the caller split its block
+    int32_t mix[SYNTH_CONTROL_PERIOD] __attribute__((aligned(MIXER_ALIGN)));
+    int16_t buf[SYNTH_CONTROL_PERIOD] __attribute__((aligned(MIXER_ALIGN)));
+    uint32_t ended = 0;
+
+    for (size_t n = 0; n < len; ++n) mix[n] = 0;
+
+    // Voice by voice so its state stays in registers; a voice whose
+    // release ends mid-chunk just renders zeros until the next chunk
+    for (uint32_t m = voices & active_mask; m; m &= m - 1)
+    {
+        int v = __builtin_ctz(m);
+
+        if (sampler_mask & (1UL << v))
+        {
+            // The voice ends with its recording, even while the key is held
+            if (!render_sample_voice(buf, len, v)) voice_env[v] = (envelope_t){.stage = ENVELOPE_STAGE_IDLE};
+        }
+        else if (voice_fm[v])
+        {
+            render_fm_voice(buf, len, v);
+        }
+        else
+        {
+            render_wavetable_voice(buf, len, v);
+        }
+
+        mixer_accumulate(mix, buf, voice_gain[v], len);
+
+        if (voice_env[v].stage == ENVELOPE_STAGE_IDLE) ended |= 1UL << v;
+    }
+
+    for (size_t n = 0; n < len; ++n) acc[n] = mix[n];
+
+    return ended;
+}
+
+void synth_engine_render_percussion(int32_t *acc, size_t len) { percussion_render(acc, len); }
+
+void synth_engine_retire(uint32_t ended) { active_mask &= ~ended; }
+
+void synth_engine_render(uint16_t *out, size_t len)
+{
+    static int32_t acc[SYNTH_CONTROL_PERIOD];
+
+    for (size_t start = 0; start < len; start += SYNTH_CONTROL_PERIOD)
+    {
+        size_t chunk = len - start < SYNTH_CONTROL_PERIOD ? len - start : SYNTH_CONTROL_PERIOD;
+
+        synth_engine_begin_chunk(chunk);
+        synth_engine_retire(synth_engine_render_voices(acc, chunk, UINT32_MAX));
+        synth_engine_render_percussion(acc, chunk);
+        mixer_process(acc, out + start, chunk);
+    }
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file synth_engine.h
+ * @brief Hardware independent synthesis core
+ *
+ * Holds the voices and renders blocks of samples. It has no dependency on
+ * timers or peripherals so it can be driven from a task on target or built
+ * for the host. The engine is not thread-safe: every call, including
+ * synth_engine_apply(), must come from the context that renders.
+ *
+ * synth_engine_render() does everything for a block. To spread the work over
+ * several cores a chunk can instead be rendered in steps: begin the chunk,
+ * render disjoint voice subsets and the percussion into partial sums
+ * (concurrently, nothing else may run meanwhile), retire the voices that
+ * ended, then sum and mix.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef SYNTH_ENGINE_H
+#define SYNTH_ENGINE_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/envelope.h"
+#include "dsp/fm.h"
+#include "dsp/velocity.h"
+#include "dsp/wavetable.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define SYNTH_MAX_CHORD_SIZE CONFIG_INTERRUPTER_SYNTH_VOICES // Up to 32, tracked in a bitmask
+#define SYNTH_SAMPLING_RATE_HZ CONFIG_INTERRUPTER_SYNTH_SAMPLE_RATE_HZ
+#define SYNTH_RESOLUTION_BITS 16
+#define SYNTH_OUT_MAX ((1U << SYNTH_RESOLUTION_BITS) - 1)
+#define SYNTH_OUT_SILENCE (SYNTH_OUT_MAX / 2)
+#define SYNTH_CHANNEL_COUNT (16)
+// Samples between pitch bend and vibrato updates, 4 ms or less at any rate
+#if SYNTH_SAMPLING_RATE_HZ > 16000
+#define SYNTH_CONTROL_PERIOD (128)
+#elif SYNTH_SAMPLING_RATE_HZ > 8000
+#define SYNTH_CONTROL_PERIOD (64)
+#else
+#define SYNTH_CONTROL_PERIOD (32)
+#endif
+
+#if CONFIG_INTERRUPTER_SYNTH_GM_PERCUSSION
+#define SYNTH_PERCUSSION_CHANNEL (9)  // MIDI channel 10
+#else
+#define SYNTH_PERCUSSION_CHANNEL (0xFF)
+#endif
+
+// MIDI controllers understood by synth_engine_apply()
+#define SYNTH_CC_MODULATION (1)
+#define SYNTH_CC_DATA_ENTRY (6)
+#define SYNTH_CC_SUSTAIN (64)
+#define SYNTH_CC_SOSTENUTO (66)
+#define SYNTH_CC_RPN_LSB (100)
+#define SYNTH_CC_RPN_MSB (101)
+#define SYNTH_CC_RESET_CONTROLLERS (121)
+#define SYNTH_CC_ALL_NOTES_OFF (123)
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief Which voice a note-on takes over when all voices are sounding
+ *
+ * Voices in their release tail are always considered before held ones.
+ * RETRIGGER also reuses the voice already playing the same note.
+ */
+typedef enum
+{
+    SYNTH_STEAL_OLDEST = 0,
+    SYNTH_STEAL_QUIETEST,
+    SYNTH_STEAL_LOWEST,
+    SYNTH_STEAL_RETRIGGER,
+    SYNTH_STEAL_COUNT
+} synth_steal_policy_t;
+
+typedef enum
+{
+    SYNTH_CMD_NOTE_ON = 0,
+    SYNTH_CMD_NOTE_OFF,
+    SYNTH_CMD_CONTROL_CHANGE,
+    SYNTH_CMD_PROGRAM_CHANGE,
+    SYNTH_CMD_PITCH_BEND,
+    SYNTH_CMD_REALTIME,
+    SYNTH_CMD_SETTING
+} synth_cmd_type_t;
+
+// Engine-wide settings, carried in data1 of SYNTH_CMD_SETTING
+typedef enum
+{
+    SYNTH_SETTING_VELOCITY_CURVE = 0,
+    SYNTH_SETTING_STEAL_POLICY
+} synth_setting_t;
+
+/**
+ * @brief Event queued by the MIDI side and applied by the render context
+ *
+ * data1/data2 follow the MIDI data bytes: note and velocity, controller and
+ * value, program, or pitch bend LSB and MSB. Real time messages (clock,
+ * start, stop) carry their status byte in data1, settings their
+ * synth_setting_t in data1 and the value in data2.
+ */
+typedef struct
+{
+    uint8_t type;
+    uint8_t channel;
+    uint8_t data1;
+    uint8_t data2;
+} synth_cmd_t;
+
+typedef struct
+{
+    uint32_t notes;
+    uint32_t steals;
+    uint32_t retriggers;
+} synth_engine_stats_t;
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void synth_engine_init(void);
+esp_err_t synth_engine_apply(const synth_cmd_t *cmd);
+esp_err_t synth_engine_note_on(uint8_t code, uint8_t channel, uint8_t velocity);
+esp_err_t synth_engine_note_off(uint8_t code, uint8_t channel);
+esp_err_t synth_engine_all_notes_off(uint8_t channel);
+esp_err_t synth_engine_set_shape(uint8_t channel, wavetable_shape_t shape);
+esp_err_t synth_engine_set_fm_patch(uint8_t channel, fm_patch_id_t patch);
+esp_err_t synth_engine_set_sampler(uint8_t channel);
+esp_err_t synth_engine_set_program(uint8_t channel, uint8_t program);
+esp_err_t synth_engine_set_envelope(uint8_t channel, const envelope_config_t *cfg);
+esp_err_t synth_engine_set_sustain(uint8_t channel, bool on);
+esp_err_t synth_engine_set_sostenuto(uint8_t channel, bool on);
+esp_err_t synth_engine_pitch_bend(uint8_t channel, int16_t bend);
+esp_err_t synth_engine_set_velocity_curve(velocity_curve_t curve);
+esp_err_t synth_engine_set_steal_policy(synth_steal_policy_t policy);
+void synth_engine_get_stats(synth_engine_stats_t *out);
+uint8_t synth_engine_active_voices(void);
+void synth_engine_render(uint16_t *out, size_t len);
+
+// Split rendering, len must not exceed SYNTH_CONTROL_PERIOD
+void synth_engine_begin_chunk(size_t len);
+uint32_t synth_engine_voice_mask(void);
+uint32_t synth_engine_render_voices(int32_t *restrict acc, size_t len, uint32_t voices);
+void synth_engine_render_percussion(int32_t *acc, size_t len);
+void synth_engine_retire(uint32_t ended);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !SYNTH_ENGINE_H */
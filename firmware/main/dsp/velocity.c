@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file velocity.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "velocity.h"
+#include <math.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define VELOCITY_COUNT 128
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static uint16_t gain_tables[VELOCITY_CURVE_COUNT][VELOCITY_COUNT] = {0};
+
+static bool initialized = false;
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void velocity_init(void)
+{
+    if (initialized) return;
+
+    for (int v = 0; v < VELOCITY_COUNT; ++v)
+    {
+        float x = v / 127.0f;
+
+        gain_tables[VELOCITY_CURVE_LINEAR][v] = (uint16_t)lrintf(x * VELOCITY_GAIN_ONE);
+        gain_tables[VELOCITY_CURVE_SOFT][v] = (uint16_t)lrintf(sqrtf(x) * VELOCITY_GAIN_ONE);
+        gain_tables[VELOCITY_CURVE_HARD][v] = (uint16_t)lrintf(x * x * VELOCITY_GAIN_ONE);
+        gain_tables[VELOCITY_CURVE_FIXED][v] = VELOCITY_GAIN_ONE;
+    }
+
+    initialized = true;
+}
+
+uint16_t velocity_gain(velocity_curve_t curve, uint8_t velocity)
+{
+    if (curve >= VELOCITY_CURVE_COUNT) curve = VELOCITY_CURVE_LINEAR;
+
+    return gain_tables[curve][velocity & (VELOCITY_COUNT - 1)];
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file velocity.h
+ * @brief Velocity to gain curves
+ *
+ * One Q15 gain table per curve, filled once at init so the note-on only does
+ * a lookup.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef VELOCITY_H
+#define VELOCITY_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define VELOCITY_GAIN_BITS 15
+#define VELOCITY_GAIN_ONE (1 << VELOCITY_GAIN_BITS)
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    VELOCITY_CURVE_LINEAR = 0,
+    VELOCITY_CURVE_SOFT,    // Square root, light playing already loud
+    VELOCITY_CURVE_HARD,    // Square, needs hard playing for full level
+    VELOCITY_CURVE_FIXED,   // Ignore velocity
+    VELOCITY_CURVE_COUNT
+} velocity_curve_t;
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void velocity_init(void);
+uint16_t velocity_gain(velocity_curve_t curve, uint8_t velocity);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !VELOCITY_H */
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file wavetable.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "wavetable.h"
+#include "dsp/note_table.h"
+#include "dsp/synth_engine.h"
+#include <math.h>
+#include <stdbool.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define BANK_COUNT (WAVETABLE_SHAPE_COUNT - 1) // Sine needs no band-limiting
+#define HARMONICS_MAX (WAVETABLE_SIZE / 2 - 1)
+#define MIP_LAST_CODE (WAVETABLE_MIP_FIRST_CODE + 12 * WAVETABLE_MIPS - 1)
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static int16_t sine_table[WAVETABLE_SIZE + 1] = {0};
+// About 86 KB of DRAM, built at boot rather than kept const in flash: the
+// harmonics each mip holds follow the Kconfig sampling rate and A4 tuning, and
+// the render reads them at every sample of every voice, where a flash table
+// would go through the cache shared with code and stall while flash is written.
+static int16_t banks[BANK_COUNT][WAVETABLE_MIPS][WAVETABLE_SIZE + 1] = {0};
+
+static bool initialized = false;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static float harmonic_gain(wavetable_shape_t shape, int h)
+{
+    switch (shape)
+    {
+    case WAVETABLE_SHAPE_SQUARE:
+        return (h & 1) ? 1.0f / h : 0.0f;
+    case WAVETABLE_SHAPE_SAW:
+        return 1.0f / h;
+    case WAVETABLE_SHAPE_PULSE:
+        return sinf(M_PI * h * WAVETABLE_PULSE_DUTY_PCT / 100.0f) / h;
+    default:
+        return 0.0f;
+    }
+}
+
+static void fill_band_limited(int16_t *table, wavetable_shape_t shape, int harmonics)
+{
+    static float acc[WAVETABLE_SIZE];
+    // Pulse is built from cosines so it stays centered on the table start
+    int offset = shape == WAVETABLE_SHAPE_PULSE ? WAVETABLE_SIZE / 4 : 0;
+
+    for (int i = 0; i < WAVETABLE_SIZE; ++i) acc[i] = 0.0f;
+
+    for (int h = 1; h <= harmonics; ++h)
+    {
+        float gain = harmonic_gain(shape, h);
+        if (gain == 0.0f) continue;
+
+        // Lanczos sigma factor tames the Gibbs ringing of the truncated series
+        float x = M_PI * h / (harmonics + 1);
+        gain *= sinf(x) / x;
+
+        // sin(h * 2pi * i / N) is read exactly from the sine table
+        for (int i = 0; i < WAVETABLE_SIZE; ++i)
+            acc[i] += gain * sine_table[(h * i + offset) & (WAVETABLE_SIZE - 1)];
+    }
+
+    float peak = 0.0f;
+    for (int i = 0; i < WAVETABLE_SIZE; ++i) peak = fmaxf(peak, fabsf(acc[i]));
+
+    float scale = peak > 0.0f ? WAVETABLE_MAX / peak : 0.0f;
+    for (int i = 0; i < WAVETABLE_SIZE; ++i) table[i] = (int16_t)lrintf(acc[i] * scale);
+    table[WAVETABLE_SIZE] = table[0];
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+void wavetable_init(void)
+{
+    if (initialized) return;
+
+    note_table_init();
+
+    for (int i = 0; i < WAVETABLE_SIZE; i++)
+    {
+        double s = sin(2.0 * M_PI * i / WAVETABLE_SIZE);
+        sine_table[i] = (int16_t)lrint(s * WAVETABLE_MAX);
+    }
+    sine_table[WAVETABLE_SIZE] = sine_table[0];
+
+    for (int m = 0; m < WAVETABLE_MIPS; ++m)
+    {
+        // Harmonics that stay below Nyquist for the highest note of the octave
+        float top_hz = note_table_freq_hz(WAVETABLE_MIP_FIRST_CODE + 12 * m + 11);
+        int harmonics = (int)(SYNTH_SAMPLING_RATE_HZ / 2 / top_hz);
+        if (harmonics > HARMONICS_MAX) harmonics = HARMONICS_MAX;
+        if (harmonics < 1) harmonics = 1;
+
+        for (int b = 0; b < BANK_COUNT; ++b) fill_band_limited(banks[b][m], WAVETABLE_SHAPE_SQUARE + b, harmonics);
+    }
+
+    initialized = true;
+}
+
+const int16_t *wavetable_sine(void) { return sine_table; }
+
+const int16_t *wavetable_get(wavetable_shape_t shape, uint8_t code)
+{
+    // Above the last mip only the fundamental fits below Nyquist
+    if (shape <= WAVETABLE_SHAPE_SINE || shape >= WAVETABLE_SHAPE_COUNT || code > MIP_LAST_CODE) return sine_table;
+
+    int mip = code < WAVETABLE_MIP_FIRST_CODE ? 0 : (code - WAVETABLE_MIP_FIRST_CODE) / 12;
+
+    return banks[shape - WAVETABLE_SHAPE_SQUARE][mip];
+}
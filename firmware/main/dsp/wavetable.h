@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file wavetable.h
+ * @brief Wavetable oscillator
+ *
+ * Tables hold WAVETABLE_SIZE samples plus one guard sample (a copy of the
+ * first one) so the interpolated read never has to wrap its second index.
+ *
+ * Non-sine shapes are band-limited: each of the WAVETABLE_MIPS octaves starting
+ * at WAVETABLE_MIP_FIRST_CODE gets its own table holding only the harmonics
+ * that stay below Nyquist for the highest note of that octave. The table is
+ * picked once at note-on so rendering stays a single interpolated read.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef WAVETABLE_H
+#define WAVETABLE_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define WAVETABLE_BITS 11
+#define WAVETABLE_SIZE (1 << WAVETABLE_BITS)
+#define WAVETABLE_FRAC_BITS 15  // Interpolation weight precision
+#define WAVETABLE_MAX INT16_MAX
+
+#define WAVETABLE_MIPS 7                  // Band-limited octaves per shape
+#define WAVETABLE_MIP_FIRST_CODE 24       // Lower notes share the first mip
+#define WAVETABLE_PULSE_DUTY_PCT 25
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    WAVETABLE_SHAPE_SINE = 0,
+    WAVETABLE_SHAPE_SQUARE,
+    WAVETABLE_SHAPE_SAW,
+    WAVETABLE_SHAPE_PULSE,
+    WAVETABLE_SHAPE_COUNT
+} wavetable_shape_t;
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief Read a table at a 32-bit phase with linear interpolation
+ *
+ * Top WAVETABLE_BITS of the phase select the sample, the next
+ * WAVETABLE_FRAC_BITS weight it against its neighbour.
+ */
+static inline int16_t wavetable_read(const int16_t *table, uint32_t phase)
+{
+    uint32_t index = phase >> (32 - WAVETABLE_BITS);
+    int32_t frac = (phase >> (32 - WAVETABLE_BITS - WAVETABLE_FRAC_BITS)) & ((1 << WAVETABLE_FRAC_BITS) - 1);
+    int32_t s0 = table[index];
+    int32_t s1 = table[index + 1];
+
+    return (int16_t)(s0 + (((s1 - s0) * frac) >> WAVETABLE_FRAC_BITS));
+}
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void wavetable_init(void);
+const int16_t *wavetable_sine(void);
+const int16_t *wavetable_get(wavetable_shape_t shape, uint8_t code);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !WAVETABLE_H */
@@ -28,6 +28,7 @@ extern "C"
 // Includes
 // -----------------------------------------------------------------------------
 #include "esp_err.h"
+#include "sdkconfig.h"
 
 // -----------------------------------------------------------------------------
 // Macros and Constants
@@ -35,7 +36,7 @@ extern "C"
 #define AUDIO_JACK_RESOLUTION_BITS 12
 #define AUDIO_JACK_OUT_MAX     ((1U << AUDIO_JACK_RESOLUTION_BITS) - 1)
 #define AUDIO_JACK_OUT_MID     (2110)
-#define AUDIO_JACK_SAMPLING_RATE_HZ (16000)
+#define AUDIO_JACK_SAMPLING_RATE_HZ CONFIG_INTERRUPTER_SYNTH_SAMPLE_RATE_HZ // Same rate as the synth
 
 // -----------------------------------------------------------------------------
 // Type Definitions
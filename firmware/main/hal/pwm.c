@@ -17,14 +17,19 @@
 // Includes
 // -----------------------------------------------------------------------------
 #include "pwm.h"
+#include "core/duty_governor.h"
+#include "core/pulse_pattern.h"
+#include "core/spsc_ring.h"
 #include "driver/ledc.h"
 #include "driver/rmt.h"
 #include "esp_attr.h"
 #include "esp_check.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "hal/ledc_hal.h"
 #include "rom/gpio.h"
 #include "soc/gpio_sig_map.h"
+#include "soc/soc_caps.h"
 #include <string.h>
 
 // -----------------------------------------------------------------------------
@@ -36,7 +41,12 @@
 
 #define RMT_CHANNEL RMT_CHANNEL_0
 #define RMT_CLK_DIV 80 // 80 MHz / 80 = 1 MHz → 1 tick = 1 us
-#define RMT_TICK_US (80 / RMT_CLK_DIV)
+
+#define PULSE_FILL_US 100         // Low items while no pulse is due, the threshold interrupt comes every 24 of them
+#define PULSE_LEAD_US 4000        // Output delay behind the first pulse, room for a late render block
+#define PULSE_STOP_TIMEOUT_MS 50
+
+_Static_assert(SOC_RMT_MEM_WORDS_PER_CHANNEL == 48, "PWM_PATTERN_SYMBOLS_MAX assumes 48 items a block");
 
 #define LEDC_TIMER LEDC_TIMER_0
 #define LEDC_MODE LEDC_LOW_SPEED_MODE
@@ -44,49 +54,221 @@
 #define LEDC_DUTY_RES PWM_MOD_DUTY_RES_BITS
 #define LEDC_FREQUENCY PWM_MOD_CARRIER_FREQ_HZ
 
+#define US_TO_GOV(us) ((uint32_t)(us) * DUTY_GOVERNOR_UNITS_PER_US)
+#define MOD_SAMPLE_LEN DUTY_GOVERNOR_SAMPLE_LEN(SYNTH_SAMPLING_RATE_HZ)
+
 // -----------------------------------------------------------------------------
 // Private Typedef
 // -----------------------------------------------------------------------------
+// Written by the RMT translator only, once the stream is started
 typedef struct
 {
-    uint32_t period_tick;
-    uint32_t pulse_width_tick;
-} pwm_data_t;
+    pulse_t pulse;       // Next pulse to write
+    bool has_pulse;
+    uint32_t gap;        // Low time left before it
+    bool synced;
+    uint32_t time;       // Pulse clock at the end of the items written so far
+    uint32_t low;        // Low time since the last pulse, up to CONFIG_INTERRUPTER_TOFF_MIN
+    volatile bool stopping;
+} pulse_stream_t;
 
 // -----------------------------------------------------------------------------
 // Static Variables
 // -----------------------------------------------------------------------------
-static QueueHandle_t low_pwm_task_queue = NULL;
-static TaskHandle_t low_pwm_task_handle = NULL;
-
 static pwm_mode_t mode = 0;
 static int sig_out_idx = SIG_GPIO_OUT_IDX;
 static bool enabled = false;
 
+static float manual_freq_hz = 0;
+static uint16_t manual_pulse_width_us = 0;
+static uint16_t manual_burst_on_ms = 0;
+static uint16_t manual_burst_off_ms = 0;
+
+// One cycle of the manual output, replayed by the RMT in loop mode
+static pulse_symbol_t pattern_symbols[PWM_PATTERN_SYMBOLS_MAX];
+static rmt_item32_t pattern_items[PWM_PATTERN_SYMBOLS_MAX];
+
+// Pulses from the synth render task to the RMT translator
+static spsc_ring_t pulse_ring;
+static pulse_t pulse_storage[PWM_PULSE_QUEUE_LEN];
+static pulse_stream_t stream;
+static const uint8_t stream_source = 0; // Never read, see pulses_to_rmt()
+
+// On-time budget of every mode, used by one of the RMT or sampling interrupt.
+// The lock covers the governor and mod_clock, reset from tasks while an
+// interrupt may be charging them.
+static duty_governor_t governor;
+static portMUX_TYPE governor_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t queue_dropped = 0; // Synth pulses lost to a full queue
+static uint32_t mod_clock = 0; // Start of the next modulation sample, in governor units
+
 // -----------------------------------------------------------------------------
 // Static Function Definitions
 // -----------------------------------------------------------------------------
-static void low_pwm_task(void *pvParams)
+/**
+ * @brief Next RMT item of the pulse stream
+ *
+ * A pulse is one item, low for the gap before it then high. Gaps longer than
+ * a fill item and idle time are written as low fill items, so the items in
+ * flight never get far ahead of the queue. Limits are enforced again here:
+ * a pulse that comes late slips rather than follow the previous one closer
+ * than CONFIG_INTERRUPTER_TOFF_MIN.
+ */
+static IRAM_ATTR rmt_item32_t next_pulse_item(void)
 {
-    pwm_data_t data;
+    rmt_item32_t item = {.level0 = 0, .duration0 = PULSE_FILL_US / 2, .level1 = 0, .duration1 = PULSE_FILL_US / 2};
 
-    while (1)
+    if (!stream.has_pulse && spsc_ring_pop(&pulse_ring, &stream.pulse) && stream.pulse.width > 0)
     {
-        // Try to receive new PWM data (non-blocking)
-        xQueueReceive(low_pwm_task_queue, &data, 0);
-
-        while (data.pulse_width_tick == 0 || data.period_tick == 0)
+        // The first pulse sets the stream clock, later ones keep their spacing
+        if (!stream.synced)
         {
-            xQueueReceive(low_pwm_task_queue, &data, portMAX_DELAY);
+            stream.time = stream.pulse.start - PULSE_LEAD_US;
+            duty_governor_restart(&governor, US_TO_GOV(stream.time));
         }
+        stream.synced = true;
+
+        int32_t gap = (int32_t)(stream.pulse.start - stream.time);
+        int32_t gap_min = CONFIG_INTERRUPTER_TOFF_MIN - stream.low;
+        if (gap_min < 1) gap_min = 1;
+        stream.gap = gap < gap_min ? gap_min : gap;
 
-        rmt_item32_t item = {
-            .level0 = 1, .level1 = 0, .duration0 = data.pulse_width_tick, .duration1 = data.pulse_width_tick};
+        if (stream.pulse.width > CONFIG_INTERRUPTER_TON_MAX) stream.pulse.width = CONFIG_INTERRUPTER_TON_MAX;
 
-        rmt_write_items(RMT_CHANNEL, &item, 1, false);
+        // Charged at the time it really goes out, a pulse over the budget is
+        // cut down or left out
+        stream.pulse.width = duty_governor_pulse(
+            &governor, stream.time + stream.gap, stream.pulse.width, CONFIG_INTERRUPTER_TON_MIN);
+        stream.has_pulse = stream.pulse.width > 0;
+    }
 
-        vTaskDelay(pdMS_TO_TICKS((data.period_tick * RMT_TICK_US) / 1000));
+    if (!stream.has_pulse || stream.gap > PULSE_FILL_US)
+    {
+        if (stream.has_pulse) stream.gap -= PULSE_FILL_US;
+        stream.time += PULSE_FILL_US;
+        if (stream.synced) duty_governor_advance(&governor, US_TO_GOV(stream.time));
+        if (stream.low < CONFIG_INTERRUPTER_TOFF_MIN) stream.low += PULSE_FILL_US;
+        return item;
     }
+
+    item.duration0 = stream.gap;
+    item.level1 = 1;
+    item.duration1 = stream.pulse.width;
+
+    stream.time += stream.gap + stream.pulse.width;
+    stream.low = 0;
+    stream.has_pulse = false;
+
+    return item;
+}
+
+/**
+ * @brief RMT translator of the pulse stream, from the driver interrupt
+ *
+ * The source is never consumed so the driver keeps asking for items, until
+ * pulses_stop() has it end the transmission.
+ */
+static IRAM_ATTR void pulses_to_rmt(const void *src, rmt_item32_t *dest, size_t src_size, size_t wanted_num,
+    size_t *translated_size, size_t *item_num)
+{
+    if (stream.stopping)
+    {
+        *translated_size = src_size;
+        *item_num = 0;
+        return;
+    }
+
+    taskENTER_CRITICAL_ISR(&governor_lock);
+    for (size_t i = 0; i < wanted_num; ++i) dest[i] = next_pulse_item();
+    taskEXIT_CRITICAL_ISR(&governor_lock);
+
+    *translated_size = 0;
+    *item_num = wanted_num;
+}
+
+/**
+ * @brief Start the manual train, timed by the RMT alone
+ *
+ * One period, or one burst cycle, is written to the channel memory and
+ * looped. Periods of any length take a few more items, a burst too long for
+ * the memory is cut short.
+ */
+static esp_err_t pattern_start(float freq_hz, uint16_t pulse_width_us, uint16_t burst_on_ms, uint16_t burst_off_ms)
+{
+    pulse_pattern_t pattern;
+    ESP_RETURN_ON_ERROR(pulse_pattern_make(&pattern, freq_hz, pulse_width_us, burst_on_ms, burst_off_ms), TAG,
+        "Invalid manual settings");
+
+    // Cut to the memory first, the budget then holds for the pulses left
+    uint32_t burst_pulses = pattern.burst_pulses;
+    ESP_RETURN_ON_FALSE(pulse_pattern_fit(&pattern, PWM_PATTERN_SYMBOLS_MAX), ESP_ERR_INVALID_SIZE, TAG,
+        "Pattern does not fit the RMT memory");
+
+    uint32_t width_max = duty_governor_train_width(pattern.period, pattern.burst_pulses, pattern.burst_cycle);
+    if (pattern.width > width_max)
+    {
+        ESP_LOGW(TAG, "Pulse width cut to %lu us by the duty budget", width_max);
+        pattern.width = width_max;
+    }
+    if (pattern.width == 0)
+    {
+        rmt_tx_stop(RMT_CHANNEL);
+        return ESP_OK;
+    }
+
+    // A narrower pulse can need more low symbols
+    pulse_pattern_fit(&pattern, PWM_PATTERN_SYMBOLS_MAX);
+    if (pattern.burst_pulses < burst_pulses)
+        ESP_LOGW(TAG, "Burst cut to %lu pulses to fit the RMT memory", pattern.burst_pulses);
+
+    size_t len = 0;
+    ESP_RETURN_ON_ERROR(pulse_pattern_encode(&pattern, pattern_symbols, PWM_PATTERN_SYMBOLS_MAX, &len), TAG, "");
+    for (size_t i = 0; i < len; ++i)
+    {
+        pattern_items[i] = (rmt_item32_t){.level0 = pattern_symbols[i].level0,
+            .duration0 = pattern_symbols[i].duration0,
+            .level1 = 0,
+            .duration1 = pattern_symbols[i].duration1};
+    }
+
+    rmt_tx_stop(RMT_CHANNEL);
+    rmt_set_mem_block_num(RMT_CHANNEL, PWM_PATTERN_MEM_BLOCKS);
+    rmt_set_tx_loop_mode(RMT_CHANNEL, true);
+    ESP_RETURN_ON_ERROR(rmt_write_items(RMT_CHANNEL, pattern_items, len, false), TAG, "Failed to write the pattern");
+
+    ESP_LOGI(TAG, "Manual update (prf=%.1f,pd=%lu,period=%lu,burst=%lu/%lu,items=%u)", freq_hz, pattern.width,
+        pattern.period, pattern.burst_pulses, pattern.burst_cycle, (unsigned)len);
+
+    return ESP_OK;
+}
+
+static esp_err_t pulses_start(void)
+{
+    // Leftovers from the last stream, the translator is not running
+    pulse_t stale;
+    while (spsc_ring_pop(&pulse_ring, &stale)) continue;
+
+    memset(&stream, 0, sizeof(stream));
+    stream.low = CONFIG_INTERRUPTER_TOFF_MIN;
+    taskENTER_CRITICAL(&governor_lock);
+    governor.scaled = governor.dropped = 0;
+    taskEXIT_CRITICAL(&governor_lock);
+    queue_dropped = 0;
+
+    // The translator refills half a block at a time, see PULSE_FILL_US
+    rmt_set_mem_block_num(RMT_CHANNEL, 1);
+    rmt_set_tx_loop_mode(RMT_CHANNEL, false);
+    return rmt_write_sample(RMT_CHANNEL, &stream_source, sizeof(stream_source), false);
+}
+
+static void pulses_stop(void)
+{
+    stream.stopping = true;
+
+    // The items in flight finish, the output ends low
+    if (rmt_wait_tx_done(RMT_CHANNEL, pdMS_TO_TICKS(PULSE_STOP_TIMEOUT_MS)) != ESP_OK) rmt_tx_stop(RMT_CHANNEL);
+    ESP_LOGI(TAG, "Pulses over the duty budget (scaled=%lu,dropped=%lu), lost to a full queue (%lu)", governor.scaled,
+        governor.dropped, queue_dropped);
 }
 
 // -----------------------------------------------------------------------------
@@ -94,7 +276,7 @@ static void low_pwm_task(void *pvParams)
 // -----------------------------------------------------------------------------
 esp_err_t pwm_init(void)
 {
-    low_pwm_task_queue = xQueueCreate(4, sizeof(pwm_data_t));
+    duty_governor_init(&governor, 0);
 
     ledc_channel_config_t ledc_channel = {.speed_mode = LEDC_MODE,
         .channel = LEDC_CHANNEL,
@@ -115,9 +297,8 @@ esp_err_t pwm_init(void)
         .tx_config.idle_level = 0};
     ESP_RETURN_ON_ERROR(rmt_config(&config), TAG, "Failed to configure RMT channel");
     ESP_RETURN_ON_ERROR(rmt_driver_install(config.channel, 0, 0), TAG, "Failed to install RMT driver");
-
-    ESP_RETURN_ON_FALSE(xTaskCreate(low_pwm_task, "low_pwm_task", 1024, NULL, 2, &low_pwm_task_handle) == pdPASS,
-        ESP_ERR_NO_MEM, TAG, "Failed to start low pwm task");
+    ESP_RETURN_ON_ERROR(rmt_translator_init(config.channel, pulses_to_rmt), TAG, "Failed to set RMT translator");
+    ESP_RETURN_ON_ERROR(spsc_ring_init(&pulse_ring, pulse_storage, sizeof(pulse_t), PWM_PULSE_QUEUE_LEN), TAG, "");
 
     // Prepare and then apply the LEDC PWM timer configuration
     ledc_timer_config_t ledc_timer = {.speed_mode = LEDC_MODE,
@@ -167,55 +348,39 @@ esp_err_t pwm_disable(void)
     return ESP_OK;
 }
 
-esp_err_t pwm_manual_update(float freq_hz, uint16_t pulse_width_us)
+/**
+ * @brief Set the manual train, gated into bursts unless the burst off time is 0
+ */
+esp_err_t pwm_manual_update(float freq_hz, uint16_t pulse_width_us, uint16_t burst_on_ms, uint16_t burst_off_ms)
 {
     if (mode != PWM_MODE_MANUAL) return ESP_ERR_INVALID_STATE;
-    if (freq_hz < 0.1 && freq_hz > 0) return ESP_ERR_INVALID_ARG;
+    if (freq_hz < PULSE_PATTERN_FREQ_MIN_HZ && freq_hz > 0) return ESP_ERR_INVALID_ARG;
+
+    // Restored when coming back from another mode
+    manual_freq_hz = freq_hz;
+    manual_pulse_width_us = pulse_width_us;
+    manual_burst_on_ms = burst_on_ms;
+    manual_burst_off_ms = burst_off_ms;
 
-    pwm_data_t data = {0};
     if (freq_hz == 0 || pulse_width_us == 0)
     {
-        // Careful here, race condition possible
-        xQueueSend(low_pwm_task_queue, &data, 0);
         rmt_tx_stop(RMT_CHANNEL);
         return ESP_OK;
     }
 
-    data.period_tick = (uint32_t)(1.e6 / (freq_hz * RMT_TICK_US));
-    data.pulse_width_tick = pulse_width_us / RMT_TICK_US;
-
-    if (data.pulse_width_tick > data.period_tick) data.pulse_width_tick = data.period_tick;
-
-    bool low_pwm = data.period_tick > 32767; // rmt_item32_t.duration0 overflow
-
-    if (low_pwm)
-    {
-        rmt_set_tx_loop_mode(RMT_CHANNEL, false);
-        xQueueSend(low_pwm_task_queue, &data, 0);
-    }
-    else
-    {
-        rmt_item32_t item = {.level0 = 1,
-            .level1 = 0,
-            .duration0 = data.pulse_width_tick,
-            .duration1 = data.period_tick - data.pulse_width_tick};
-
-        memset(&data, 0, sizeof(data));
-        xQueueSend(low_pwm_task_queue, &data, 0);
-
-        rmt_set_tx_loop_mode(RMT_CHANNEL, true);
-        rmt_write_items(RMT_CHANNEL, &item, 1, false);
-    }
-
-    ESP_LOGI(TAG, "Manual update (%s,prf=%.1f,pd=%d)", low_pwm ? "LF":"HF", freq_hz, (int)pulse_width_us);
-
-    return ESP_OK;
+    return pattern_start(freq_hz, pulse_width_us, burst_on_ms, burst_off_ms);
 }
 
 esp_err_t inline IRAM_ATTR pwm_modulation_update(uint8_t duty)
 {
     if (mode != PWM_MODE_MODULATION) return ESP_ERR_INVALID_STATE;
 
+    // One call per synth sample
+    taskENTER_CRITICAL_ISR(&governor_lock);
+    duty = duty_governor_duty(&governor, mod_clock, duty, MOD_SAMPLE_LEN);
+    mod_clock += MOD_SAMPLE_LEN;
+    taskEXIT_CRITICAL_ISR(&governor_lock);
+
     // 1. Set the integer part of the duty (same as ledc_hal_set_duty_int_part)
     LEDC.channel_group[LEDC_MODE].channel[LEDC_CHANNEL].duty.duty = duty << 4;
 
@@ -230,38 +395,69 @@ esp_err_t inline IRAM_ATTR pwm_modulation_update(uint8_t duty)
     return ESP_OK;
 }
 
-esp_err_t pwm_set_mode(pwm_mode_t m)
+/**
+ * @brief Queue a pulse of the synth, from a single task
+ *
+ * Start times are on the synth clock, the stream keeps their spacing. A
+ * full queue drops the pulse.
+ */
+esp_err_t pwm_pulse_push(const pulse_t *pulse)
 {
-    if (m == PWM_MODE_MODULATION)
-    {
-        if (mode == PWM_MODE_MODULATION) return ESP_ERR_INVALID_STATE;
+    if (mode != PWM_MODE_PULSES) return ESP_ERR_INVALID_STATE;
 
-        // Stop MANUAL
-        vTaskSuspend(low_pwm_task_handle);
-        rmt_tx_stop(RMT_CHANNEL);
+    if (spsc_ring_push(&pulse_ring, pulse)) return ESP_OK;
 
-        // Start MODULATION
-        sig_out_idx = LEDC_LS_SIG_OUT0_IDX;
+    queue_dropped++;
+    return ESP_ERR_NO_MEM;
+}
 
-        ESP_LOGI(TAG, "Set mode: MODULATION");
-    }
-    else if (m == PWM_MODE_MANUAL)
-    {
-        if (mode == PWM_MODE_MANUAL) return ESP_ERR_INVALID_STATE;
+esp_err_t pwm_set_mode(pwm_mode_t m)
+{
+    if (m == mode) return ESP_ERR_INVALID_STATE;
+    if (m < PWM_MODE_MANUAL || m > PWM_MODE_PULSES) return ESP_ERR_INVALID_ARG;
 
-        // Stop MODULATION
+    // Stop the current mode
+    switch (mode)
+    {
+    case PWM_MODE_MANUAL:
+        rmt_tx_stop(RMT_CHANNEL);
+        break;
+    case PWM_MODE_MODULATION:
         ledc_stop(LEDC_MODE, LEDC_CHANNEL, 0);
+        ESP_LOGI(TAG, "Samples over the duty budget (scaled=%lu)", governor.scaled);
+        break;
+    case PWM_MODE_PULSES:
+        pulses_stop();
+        break;
+    default:
+        break;
+    }
 
-        // Start MANUAL
-        sig_out_idx = RMT_SIG_OUT0_IDX;
-        vTaskResume(low_pwm_task_handle);
-        rmt_tx_start(RMT_CHANNEL, true);
+    mode = m;
 
+    switch (m)
+    {
+    case PWM_MODE_MANUAL:
+        sig_out_idx = RMT_SIG_OUT0_IDX;
+        pwm_manual_update(manual_freq_hz, manual_pulse_width_us, manual_burst_on_ms, manual_burst_off_ms);
         ESP_LOGI(TAG, "Set mode: MANUAL");
+        break;
+    case PWM_MODE_MODULATION:
+        sig_out_idx = LEDC_LS_SIG_OUT0_IDX;
+        taskENTER_CRITICAL(&governor_lock);
+        duty_governor_restart(&governor, mod_clock);
+        governor.scaled = 0;
+        taskEXIT_CRITICAL(&governor_lock);
+        ESP_LOGI(TAG, "Set mode: MODULATION");
+        break;
+    case PWM_MODE_PULSES:
+        sig_out_idx = RMT_SIG_OUT0_IDX;
+        ESP_RETURN_ON_ERROR(pulses_start(), TAG, "Failed to start the pulse stream");
+        ESP_LOGI(TAG, "Set mode: PULSES");
+        break;
     }
 
     if (enabled) gpio_matrix_out(PIN_OUTPUT, sig_out_idx, 0, 0);
-    mode = m;
 
     return ESP_OK;
 }
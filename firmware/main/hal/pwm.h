@@ -27,7 +27,9 @@ extern "C"
 // -----------------------------------------------------------------------------
 // Includes
 // -----------------------------------------------------------------------------
+#include "dsp/pulse_train.h"
 #include "esp_err.h"
+#include <stdint.h>
 
 // -----------------------------------------------------------------------------
 // Macros and Constants
@@ -37,26 +39,48 @@ extern "C"
 #define PWM_MOD_CARRIER_FREQ_HZ   (30000)    // 30 kHz PWM carrier frequency
 #define PWM_MOD_DUTY_MAX   ((1U << PWM_MOD_DUTY_RES_BITS) - 1)
 
+// PWM Pulses Configuration
+#define PWM_PULSE_QUEUE_LEN   (64)       // Pulses queued ahead of the RMT, power of two
+
+// PWM Manual Configuration
+#define PWM_PATTERN_MEM_BLOCKS   (4)     // RMT blocks of the manual output, the next channels are unused
+#define PWM_PATTERN_SYMBOLS_MAX   (PWM_PATTERN_MEM_BLOCKS * 48 - 1) // Less the end marker
+
 // -----------------------------------------------------------------------------
 // Type Definitions
 // -----------------------------------------------------------------------------
 typedef enum
 {
     PWM_MODE_MANUAL = 1,
-    PWM_MODE_MODULATION
+    PWM_MODE_MODULATION,
+    PWM_MODE_PULSES
 } pwm_mode_t;
 
 // -----------------------------------------------------------------------------
 // Inline Function Definitions
 // -----------------------------------------------------------------------------
+/**
+ * @brief Modulation duty for an output level scaled by the power knob
+ *
+ * Shared by the audio callbacks and the host renderer so both produce the
+ * same duty stream.
+ */
+static inline uint8_t pwm_modulation_duty(uint32_t level, uint32_t level_max, uint32_t power, uint32_t power_max)
+{
+    uint32_t dt = level * PWM_MOD_DUTY_MAX / level_max;
+    dt = dt * power / power_max;
+
+    return (uint8_t)(dt / 2);
+}
 
 // -----------------------------------------------------------------------------
 // Function Declarations
 // -----------------------------------------------------------------------------
 esp_err_t pwm_init(void);
 
-esp_err_t pwm_manual_update(float freq_hz, uint16_t pulse_width_us);
+esp_err_t pwm_manual_update(float freq_hz, uint16_t pulse_width_us, uint16_t burst_on_ms, uint16_t burst_off_ms);
 esp_err_t pwm_modulation_update(uint8_t dutycycle);
+esp_err_t pwm_pulse_push(const pulse_t *pulse);
 esp_err_t pwm_enable(void);
 esp_err_t pwm_disable(void);
 
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file sample_bank.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "sample_bank.h"
+#include "dsp/sampler.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define TAG "sample_bank"
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static esp_partition_mmap_handle_t mmap_handle;
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+esp_err_t sample_bank_init(void)
+{
+    const esp_partition_t *partition = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, SAMPLE_BANK_PARTITION_SUBTYPE, SAMPLE_BANK_PARTITION_LABEL);
+    ESP_RETURN_ON_FALSE(partition, ESP_ERR_NOT_FOUND, TAG, "No sample partition");
+
+    const void *bank = NULL;
+    ESP_RETURN_ON_ERROR(
+        esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &bank, &mmap_handle), TAG,
+        "Failed to map sample partition");
+
+    size_t size = sampler_bank_size(bank, partition->size);
+    if (size == 0)
+    {
+        esp_partition_munmap(mmap_handle);
+        ESP_LOGW(TAG, "No valid sample bank flashed");
+        return ESP_ERR_NOT_FOUND;
+    }
+
+#if CONFIG_SPIRAM
+    void *copy = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    if (copy)
+    {
+        memcpy(copy, bank, size);
+        esp_partition_munmap(mmap_handle);
+        bank = copy;
+    }
+#endif
+
+    ESP_RETURN_ON_ERROR(sampler_init(bank, size), TAG, "Invalid sample bank");
+
+    ESP_LOGI(TAG, "%u bytes of samples ready", (unsigned)size);
+
+    return ESP_OK;
+}
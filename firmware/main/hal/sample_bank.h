@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file sample_bank.h
+ * @brief Sample bank stored in the "samples" flash partition
+ *
+ * The partition is memory-mapped and handed to the sampler as is, reads go
+ * through the flash cache. With PSRAM enabled the bank is copied there once
+ * so playback does not compete with code fetches for the cache.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef SAMPLE_BANK_H
+#define SAMPLE_BANK_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_err.h"
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define SAMPLE_BANK_PARTITION_LABEL "samples"
+#define SAMPLE_BANK_PARTITION_SUBTYPE (0x40)
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+esp_err_t sample_bank_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !SAMPLE_BANK_H */
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file song_bank.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "song_bank.h"
+#include "core/smf.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define TAG "song_bank"
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static esp_partition_mmap_handle_t mmap_handle;
+static const uint8_t *songs[SONG_BANK_MAX_SONGS] = {0};
+static size_t sizes[SONG_BANK_MAX_SONGS] = {0};
+static uint8_t count = 0;
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+esp_err_t song_bank_init(void)
+{
+    const esp_partition_t *partition = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, SONG_BANK_PARTITION_SUBTYPE, SONG_BANK_PARTITION_LABEL);
+    ESP_RETURN_ON_FALSE(partition, ESP_ERR_NOT_FOUND, TAG, "No song partition");
+
+    const void *bank = NULL;
+    ESP_RETURN_ON_ERROR(
+        esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &bank, &mmap_handle), TAG,
+        "Failed to map song partition");
+
+    // Files follow each other, the first thing that is not one ends the list
+    size_t pos = 0;
+    while (count < SONG_BANK_MAX_SONGS)
+    {
+        size_t size = smf_file_size((const uint8_t *)bank + pos, partition->size - pos);
+        if (size == 0) break;
+
+        songs[count] = (const uint8_t *)bank + pos;
+        sizes[count++] = size;
+        pos += size;
+    }
+
+    if (count == 0)
+    {
+        esp_partition_munmap(mmap_handle);
+        ESP_LOGW(TAG, "No MIDI file flashed");
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    ESP_LOGI(TAG, "%d songs, %u bytes", (int)count, (unsigned)pos);
+
+    return ESP_OK;
+}
+
+uint8_t song_bank_count(void) { return count; }
+
+esp_err_t song_bank_get(uint8_t index, const uint8_t **data, size_t *size)
+{
+    if (index >= count) return ESP_ERR_INVALID_ARG;
+
+    *data = songs[index];
+    *size = sizes[index];
+
+    return ESP_OK;
+}
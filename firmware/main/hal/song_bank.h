@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file song_bank.h
+ * @brief MIDI files stored in the "songs" flash partition
+ *
+ * The partition holds standard MIDI files written back to back, unused space
+ * left erased. It is memory-mapped once and songs are read in place by the
+ * SMF reader, only the offset of each file is kept in RAM.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef SONG_BANK_H
+#define SONG_BANK_H
+
+// clang-format off
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define SONG_BANK_PARTITION_LABEL "songs"
+#define SONG_BANK_PARTITION_SUBTYPE (0x41)
+#define SONG_BANK_MAX_SONGS (32)
+
+// -----------------------------------------------------------------------------
+// Type Definitions
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+esp_err_t song_bank_init(void);
+uint8_t song_bank_count(void);
+esp_err_t song_bank_get(uint8_t index, const uint8_t **data, size_t *size);
+
+#ifdef __cplusplus
+}
+#endif
+// clang-format on
+
+#endif /* !SONG_BANK_H */
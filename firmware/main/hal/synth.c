@@ -17,48 +17,116 @@
 // Includes
 // -----------------------------------------------------------------------------
 #include "synth.h"
+#include "core/spsc_ring.h"
 #include "driver/gptimer.h"
+#include "dsp/mixer.h"
+#include "dsp/sequencer.h"
+#include "hal/sample_bank.h"
 #include "esp_attr.h"
 #include "esp_check.h"
-#include <math.h>
+#include "esp_cpu.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
 
 // -----------------------------------------------------------------------------
 // Macros and Constants
 // -----------------------------------------------------------------------------
 #define TAG "synth"
 
-#define SIN_TABLE_SIZE 256
-#define SIN_TABLE_MAX ((1 << (SYNTH_RESOLUTION_BITS - 1)) - 1)
-#define SIN_TABLE_MIN (-(1 << (SYNTH_RESOLUTION_BITS - 1)))
-#define PHASE_BITS 32 // DDS accumulator precision
-
-#define OUT_HALF (SYNTH_OUT_MAX / 2)
-
 #define GPTIMER_CLK_SRC GPTIMER_CLK_SRC_DEFAULT
-#define GPTIMER_FREQ_HZ (1000000)
-#define GPTIMER_ALARM_CNT (GPTIMER_FREQ_HZ / SYNTH_SAMPLING_RATE_HZ)
+#define GPTIMER_FREQ_HZ (40000000) // Half the APB clock, divides every rate but 24 kHz exactly
+#define GPTIMER_ALARM_CNT ((GPTIMER_FREQ_HZ + SYNTH_SAMPLING_RATE_HZ / 2) / SYNTH_SAMPLING_RATE_HZ)
+
+#define RENDER_TASK_PRIO (configMAX_PRIORITIES - 2)
+#define RENDER_TASK_STACK (3 * 1024) // Voice scratch buffers live on the stack
+#define RENDER_TASK_CORE (1)
+#define HELPER_TASK_CORE (0)
+#if CONFIG_INTERRUPTER_SYNTH_DUAL_CORE
+#define RENDER_CORES_STR "two cores"
+#else
+#define RENDER_CORES_STR "one core"
+#endif
+#define RENDER_LOAD_AVG_SHIFT (4) // Cycle counts are averaged over about 16 blocks
+
+// Blocks between the engine rendering a sample and the ring holding it
+#if CONFIG_INTERRUPTER_SYNTH_DUAL_CORE
+#define RENDER_DELAY_BLOCKS (1)
+#else
+#define RENDER_DELAY_BLOCKS (0)
+#endif
+
+// Events are played this many samples after they are queued. The ring is at
+// most SYNTH_BLOCK_COUNT blocks ahead of the output, so no block that would
+// contain the event has been rendered yet.
+#define CMD_LATENCY ((SYNTH_BLOCK_COUNT + RENDER_DELAY_BLOCKS) * SYNTH_BLOCK_SIZE)
 
 // -----------------------------------------------------------------------------
 // Private Typedefs
 // -----------------------------------------------------------------------------
 typedef struct
 {
-    uint8_t code : 7;
-    uint8_t active : 1;
-    uint32_t phase_acc;
-    uint32_t phase_inc;
-} note_data_t;
+    uint32_t time; // Play clock sample the event applies at
+    synth_cmd_t cmd;
+} timed_cmd_t;
+
+typedef enum
+{
+    CMD_SOURCE_LIVE = 0,   // synth_play_note() and friends
+    CMD_SOURCE_SCHEDULED,  // synth_schedule()
+    CMD_SOURCE_SETTINGS,   // synth_set_velocity_curve() and synth_set_steal_policy()
+    CMD_SOURCE_COUNT
+} cmd_source_t;
 
 // -----------------------------------------------------------------------------
 // Static Variables
 // -----------------------------------------------------------------------------
 static gptimer_handle_t gptimer = NULL;
-
-static int16_t sin_table[SIN_TABLE_SIZE] = {0};
-static note_data_t active_notes[SYNTH_MAX_CHORD_SIZE] = {0};
-static uint8_t active_notes_cnt = 0;
+static TaskHandle_t render_task_handle = NULL;
+
+// Ring of rendered blocks: the render task is the only writer of write_clock,
+// the play clock sample its next block starts at, the timer ISR the only
+// writer of play_clock, the number of samples played from the ring. Both
+// count samples so they wrap around 2^32 together, and the ring length
+// divides 2^32 so sample n stays in ring block n / SYNTH_BLOCK_SIZE across it.
+_Static_assert((SYNTH_BLOCK_SIZE & (SYNTH_BLOCK_SIZE - 1)) == 0, "Blocks must divide 2^32 samples");
+_Static_assert((SYNTH_BLOCK_COUNT & (SYNTH_BLOCK_COUNT - 1)) == 0, "The ring must divide 2^32 samples");
+_Static_assert(SYNTH_CLOCK_START % SYNTH_BLOCK_SIZE == 0, "The play clock starts on a block");
+static uint16_t ring[SYNTH_BLOCK_COUNT][SYNTH_BLOCK_SIZE] = {0};
+static volatile uint32_t write_clock = SYNTH_CLOCK_START;
+static volatile uint32_t play_clock = SYNTH_CLOCK_START;
+
+// Timestamped events, applied by the render task at their sample. Each
+// producer has its own ring, in time order; the first event of each ring
+// waits in next_cmd until it is due.
+static spsc_ring_t cmd_rings[CMD_SOURCE_COUNT];
+static timed_cmd_t live_storage[SYNTH_CMD_QUEUE_LEN];
+static timed_cmd_t scheduled_storage[SYNTH_SCHEDULE_QUEUE_LEN];
+static timed_cmd_t settings_storage[SYNTH_SETTINGS_QUEUE_LEN];
+static timed_cmd_t next_cmd[CMD_SOURCE_COUNT];
+static bool next_cmd_valid[CMD_SOURCE_COUNT] = {0};
 
 static synth_on_sampling_cb_t on_sampling_cb = NULL;
+static synth_on_pulse_cb_t on_pulse_cb = NULL;
+static volatile synth_output_t output = SYNTH_OUTPUT_AUDIO;
+static volatile uint16_t pulse_width = 0;
+
+#if CONFIG_INTERRUPTER_SYNTH_DUAL_CORE
+_Static_assert(SYNTH_BLOCK_SIZE <= SYNTH_CONTROL_PERIOD, "A block is rendered as a single engine chunk");
+
+// Partial sums of [block parity][render task, helper]: the helper fills one
+// parity while the render task mixes the other
+static int32_t partial[2][2][SYNTH_BLOCK_SIZE] = {0};
+static SemaphoreHandle_t helper_start = NULL;
+static SemaphoreHandle_t helper_done = NULL;
+static uint32_t helper_voices = 0;
+static int32_t *helper_acc = NULL;
+static size_t helper_len = 0;
+static uint32_t helper_ended = 0;
+#endif
+
+// Average render cycles per block, indexed by active voices at block start
+static uint32_t render_cycles[SYNTH_MAX_CHORD_SIZE + 1] = {0};
 
 // -----------------------------------------------------------------------------
 // Static Function Declarations
@@ -69,37 +137,245 @@ static synth_on_sampling_cb_t on_sampling_cb = NULL;
 // -----------------------------------------------------------------------------
 static IRAM_ATTR bool gptimer_on_alarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_data)
 {
-    int32_t mixed = 0;
+    BaseType_t high_task_woken = pdFALSE;
+    uint16_t out = SYNTH_OUT_SILENCE;
+
+    uint32_t clock = play_clock;
 
-    for (int i = 0; i < SYNTH_MAX_CHORD_SIZE; ++i)
+    // Underrun outputs silence rather than replaying a stale block, the play
+    // clock stops so queued events keep their place relative to the music
+    if (clock != write_clock)
     {
-        note_data_t *note = &active_notes[i];
-        if (note->active == 0) continue;
+        out = ring[clock / SYNTH_BLOCK_SIZE % SYNTH_BLOCK_COUNT][clock % SYNTH_BLOCK_SIZE];
 
-        // advance phase
-        note->phase_acc += note->phase_inc;
-        // take the upper bits as table index
-        uint16_t index = note->phase_acc >> (PHASE_BITS - 8); // 8 bits for 256-entry table
+        play_clock = ++clock;
+        if (clock % SYNTH_BLOCK_SIZE == 0) vTaskNotifyGiveFromISR(render_task_handle, &high_task_woken);
+    }
+
+    if (on_sampling_cb) on_sampling_cb(out);
 
-        mixed += sin_table[index];
+    return high_task_woken == pdTRUE;
+}
+
+/**
+ * @brief Earliest pending event of all sources, NULL if there is none
+ */
+static timed_cmd_t *peek_cmd(void)
+{
+    timed_cmd_t *first = NULL;
+
+    for (int s = 0; s < CMD_SOURCE_COUNT; ++s)
+    {
+        if (!next_cmd_valid[s]) next_cmd_valid[s] = spsc_ring_pop(&cmd_rings[s], &next_cmd[s]);
+        if (next_cmd_valid[s] && (!first || (int32_t)(next_cmd[s].time - first->time) < 0)) first = &next_cmd[s];
     }
 
-    uint16_t out = SYNTH_OUT_SILENCE;
-    if (active_notes_cnt > 0)
+    return first;
+}
+
+static inline uint32_t sample_to_us(uint32_t time) { return (uint64_t)time * 1000000 / SYNTH_SAMPLING_RATE_HZ; }
+
+/**
+ * @brief Hand an event to the engine or to the pulse trains, whichever plays
+ *
+ * Settings always go to the engine, they hold across output changes.
+ */
+static void apply_cmd(const synth_cmd_t *cmd, uint32_t time)
+{
+    if (output == SYNTH_OUTPUT_PULSES && cmd->type != SYNTH_CMD_SETTING)
+        pulse_train_apply(cmd, sample_to_us(time));
+    else
+        synth_engine_apply(cmd);
+}
+
+/**
+ * @brief Apply every event due at or before the given play clock sample
+ *
+ * Live events go through the sequencer first, which keeps the keys and clock
+ * it uses and outputs its own notes. At the same sample, queued events come
+ * before the sequencer output so a stop or a key release is seen in time.
+ */
+static void apply_due_cmds(uint32_t time)
+{
+    sequencer_poll(time);
+
+    while (1)
     {
-        mixed /= active_notes_cnt;
+        timed_cmd_t *cmd = peek_cmd();
+        uint32_t seq_time;
+        bool seq_due = sequencer_next(&seq_time) && (int32_t)(seq_time - time) <= 0;
 
-        if (mixed > SIN_TABLE_MAX)
-            mixed = SIN_TABLE_MAX;
-        else if (mixed < SIN_TABLE_MIN)
-            mixed = SIN_TABLE_MIN;
+        if (cmd && (int32_t)(cmd->time - time) <= 0 && (!seq_due || (int32_t)(cmd->time - seq_time) <= 0))
+        {
+            cmd_source_t source = cmd - next_cmd;
+            if (source != CMD_SOURCE_LIVE || !sequencer_input(&cmd->cmd, cmd->time)) apply_cmd(&cmd->cmd, time);
+            next_cmd_valid[source] = false;
+            continue;
+        }
 
-        out = (uint16_t)(mixed + OUT_HALF);
+        synth_cmd_t seq_cmd;
+        if (!seq_due || !sequencer_pop(time, &seq_cmd)) break;
+        apply_cmd(&seq_cmd, time);
     }
+}
 
-    if (on_sampling_cb) on_sampling_cb(out);
+/**
+ * @brief Offset in the block starting at the given sample of the next event
+ *
+ * Returns SYNTH_BLOCK_SIZE when no event falls inside the block.
+ */
+static size_t next_cmd_offset(uint32_t block_time)
+{
+    timed_cmd_t *cmd = peek_cmd();
+    uint32_t seq_time;
+    bool seq = sequencer_next(&seq_time);
+    if (!cmd && !seq) return SYNTH_BLOCK_SIZE;
+
+    uint32_t time = !seq || (cmd && (int32_t)(cmd->time - seq_time) < 0) ? cmd->time : seq_time;
+    int32_t offset = (int32_t)(time - block_time);
+    if (offset < 0) return 0; // Late, the render task fell behind
+    return offset < SYNTH_BLOCK_SIZE ? offset : SYNTH_BLOCK_SIZE;
+}
+
+#if CONFIG_INTERRUPTER_SYNTH_DUAL_CORE
+static void helper_task(void *pvParams)
+{
+    while (1)
+    {
+        xSemaphoreTake(helper_start, portMAX_DELAY);
+        helper_ended = synth_engine_render_voices(helper_acc, helper_len, helper_voices);
+        xSemaphoreGive(helper_done);
+    }
+}
+
+/*
+ * Voices are dealt alternately to the render task and to the helper on the
+ * other core. A block is only mixed once the next one has been started, so
+ * in steady state neither core waits for the other, at the cost of one more
+ * block of latency. Events inside a block split it, and the render task
+ * waits for the helper at each split.
+ */
+static void render_block(uint16_t *out, uint32_t block_time)
+{
+    static uint32_t parity = 0;
+    static uint32_t own_ended = 0;
+    size_t pos = 0;
+
+    // The helper must be done with the previous block before the engine changes
+    xSemaphoreTake(helper_done, portMAX_DELAY);
+
+    while (pos < SYNTH_BLOCK_SIZE)
+    {
+        synth_engine_retire(own_ended | helper_ended);
+        own_ended = helper_ended = 0;
+        apply_due_cmds(block_time + pos);
+        size_t end = next_cmd_offset(block_time);
+
+        uint32_t own = 0;
+        uint32_t other = 0;
+        bool turn = false;
+        for (uint32_t m = synth_engine_voice_mask(); m; m &= m - 1, turn = !turn)
+        {
+            if (turn)
+                other |= m & -m;
+            else
+                own |= m & -m;
+        }
+
+        synth_engine_begin_chunk(end - pos);
+        helper_voices = other;
+        helper_acc = &partial[parity][1][pos];
+        helper_len = end - pos;
+        xSemaphoreGive(helper_start);
+        own_ended = synth_engine_render_voices(&partial[parity][0][pos], end - pos, own);
+        synth_engine_render_percussion(&partial[parity][0][pos], end - pos);
+
+        pos = end;
+        if (pos < SYNTH_BLOCK_SIZE) xSemaphoreTake(helper_done, portMAX_DELAY);
+    }
+
+    // Both halves of the previous block are complete
+    parity ^= 1;
+    int32_t *sum = partial[parity][0];
+    for (int n = 0; n < SYNTH_BLOCK_SIZE; ++n) sum[n] += partial[parity][1][n];
+    mixer_process(sum, out, SYNTH_BLOCK_SIZE);
+}
+#else
+static void render_block(uint16_t *out, uint32_t block_time)
+{
+    size_t pos = 0;
+
+    // The block is split at each event so notes start on their exact sample
+    while (pos < SYNTH_BLOCK_SIZE)
+    {
+        apply_due_cmds(block_time + pos);
+        size_t end = next_cmd_offset(block_time);
 
-    return true;
+        synth_engine_render(out + pos, end - pos);
+        pos = end;
+    }
+}
+#endif
+
+/**
+ * @brief Pulses of the block starting at the given sample
+ *
+ * Events split the block as they do the audio, so a note starts its train
+ * on the microsecond of its sample. Nothing is written to the ring, the
+ * sampling timer only keeps the clock.
+ */
+static void render_pulses(uint32_t block_time)
+{
+    pulse_t pulse;
+    size_t pos = 0;
+
+    pulse_train_set_width(pulse_width);
+
+    while (pos < SYNTH_BLOCK_SIZE)
+    {
+        apply_due_cmds(block_time + pos);
+        size_t end = next_cmd_offset(block_time);
+
+        uint32_t until = sample_to_us(block_time + end);
+        while (pulse_train_next(until, &pulse))
+            if (on_pulse_cb) on_pulse_cb(&pulse);
+        pos = end;
+    }
+}
+
+static void render_task(void *pvParams)
+{
+    while (1)
+    {
+        // Keep the ring full, then sleep until the ISR frees a block
+        while (write_clock - play_clock < SYNTH_BLOCK_COUNT * SYNTH_BLOCK_SIZE)
+        {
+            uint32_t block_time = write_clock + RENDER_DELAY_BLOCKS * SYNTH_BLOCK_SIZE;
+            uint8_t voices = synth_engine_active_voices();
+            uint32_t start = esp_cpu_get_cycle_count();
+            if (output == SYNTH_OUTPUT_PULSES)
+                render_pulses(block_time);
+            else
+                render_block(ring[write_clock / SYNTH_BLOCK_SIZE % SYNTH_BLOCK_COUNT], block_time);
+            int32_t delta = (int32_t)(esp_cpu_get_cycle_count() - start - render_cycles[voices]);
+            render_cycles[voices] += delta >> RENDER_LOAD_AVG_SHIFT;
+            write_clock += SYNTH_BLOCK_SIZE;
+        }
+
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+static inline uint8_t note_to_code(synth_note_t note) { return (note.octave + 2) * 12 + note.note; }
+
+static esp_err_t push_cmd(cmd_source_t source, synth_cmd_type_t type, uint8_t channel, uint8_t data1, uint8_t data2)
+{
+    timed_cmd_t cmd = {.time = synth_now(),
+        .cmd = {.type = type, .channel = channel, .data1 = data1, .data2 = data2}};
+    if (spsc_ring_push(&cmd_rings[source], &cmd)) return ESP_OK;
+
+    ESP_LOGW(TAG, "Command queue full");
+    return ESP_ERR_NO_MEM;
 }
 
 // -----------------------------------------------------------------------------
@@ -107,6 +383,21 @@ static IRAM_ATTR bool gptimer_on_alarm(gptimer_handle_t timer, const gptimer_ala
 // -----------------------------------------------------------------------------
 esp_err_t synth_init(void)
 {
+    synth_engine_init();
+    pulse_train_init();
+    sequencer_init(SYNTH_SAMPLING_RATE_HZ);
+    // Optional, sampler programs stay silent without a bank
+    if (sample_bank_init() != ESP_OK) ESP_LOGW(TAG, "Sample playback disabled");
+
+    ESP_LOGI(TAG, "Vector mixer not compiled in, voices are mixed in C");
+
+    ESP_RETURN_ON_ERROR(spsc_ring_init(&cmd_rings[CMD_SOURCE_LIVE], live_storage, sizeof(timed_cmd_t),
+                            SYNTH_CMD_QUEUE_LEN), TAG, "");
+    ESP_RETURN_ON_ERROR(spsc_ring_init(&cmd_rings[CMD_SOURCE_SCHEDULED], scheduled_storage, sizeof(timed_cmd_t),
+                            SYNTH_SCHEDULE_QUEUE_LEN), TAG, "");
+    ESP_RETURN_ON_ERROR(spsc_ring_init(&cmd_rings[CMD_SOURCE_SETTINGS], settings_storage, sizeof(timed_cmd_t),
+                            SYNTH_SETTINGS_QUEUE_LEN), TAG, "");
+
     // Initialize GPTimer
     gptimer_config_t timer_config = {
         .clk_src = GPTIMER_CLK_SRC, .direction = GPTIMER_COUNT_UP, .resolution_hz = GPTIMER_FREQ_HZ};
@@ -119,67 +410,105 @@ esp_err_t synth_init(void)
     gptimer_alarm_config_t alarm_config = {.alarm_count = GPTIMER_ALARM_CNT, .flags.auto_reload_on_alarm = true};
     ESP_RETURN_ON_ERROR(gptimer_set_alarm_action(gptimer, &alarm_config), TAG, "");
 
-    // Fill sin table
-    for (int i = 0; i < SIN_TABLE_SIZE; i++)
-    {
-        float s = sinf(2.0f * M_PI * i / SIN_TABLE_SIZE);
-        // scale -1..+1 -> -32768..32767
-        sin_table[i] = (int16_t)(s * SIN_TABLE_MAX);
-    }
+#if CONFIG_INTERRUPTER_SYNTH_DUAL_CORE
+    helper_start = xSemaphoreCreateBinary();
+    helper_done = xSemaphoreCreateBinary();
+    ESP_RETURN_ON_FALSE(helper_start && helper_done, ESP_ERR_NO_MEM, TAG, "Failed to create helper semaphores");
+    xSemaphoreGive(helper_done); // Nothing in flight before the first block
+
+    BaseType_t helper_created = xTaskCreatePinnedToCore(
+        helper_task, "synth_helper", RENDER_TASK_STACK, NULL, RENDER_TASK_PRIO, NULL, HELPER_TASK_CORE);
+    ESP_RETURN_ON_FALSE(helper_created == pdPASS, ESP_ERR_NO_MEM, TAG, "Failed to create helper task");
+#endif
+
+    BaseType_t task_created = xTaskCreatePinnedToCore(
+        render_task, "synth_render", RENDER_TASK_STACK, NULL, RENDER_TASK_PRIO, &render_task_handle, RENDER_TASK_CORE);
+    ESP_RETURN_ON_FALSE(task_created == pdPASS, ESP_ERR_NO_MEM, TAG, "Failed to create render task");
 
     ESP_LOGI(TAG, "Initialization succeeded");
 
     return ESP_OK;
 }
 
-esp_err_t synth_play_note(synth_note_t note)
+esp_err_t synth_play_note(synth_note_t note, uint8_t channel, uint8_t velocity)
 {
-    if (active_notes_cnt >= SYNTH_MAX_CHORD_SIZE)
-    {
-        ESP_LOGW(TAG, "Max active note count reached");
-        return ESP_ERR_NO_MEM;
-    }
+    return push_cmd(CMD_SOURCE_LIVE, SYNTH_CMD_NOTE_ON, channel, note_to_code(note), velocity);
+}
 
-    uint8_t code = (note.octave + 2) * 12 + note.note;
+esp_err_t synth_stop_note(synth_note_t note, uint8_t channel)
+{
+    return push_cmd(CMD_SOURCE_LIVE, SYNTH_CMD_NOTE_OFF, channel, note_to_code(note), 0);
+}
 
-    for (int i = 0; i < SYNTH_MAX_CHORD_SIZE; ++i)
-    {
-        note_data_t *note = &active_notes[i];
-        if (note->active == 0)
-        {
-            float freq_hz = 440.0f * powf(2.0f, (code - 69) / 12.0f);
+esp_err_t synth_set_program(uint8_t channel, uint8_t program)
+{
+    ESP_LOGI(TAG, "Channel %d: program %d", (int)channel, (int)program);
+    return push_cmd(CMD_SOURCE_LIVE, SYNTH_CMD_PROGRAM_CHANGE, channel, program, 0);
+}
 
-            note->code = code;
-            note->phase_inc = (uint32_t)((freq_hz / (float)SYNTH_SAMPLING_RATE_HZ) * (1ULL << PHASE_BITS) + 0.5f);
-            note->active = 1;
+esp_err_t synth_control_change(uint8_t channel, uint8_t controller, uint8_t value)
+{
+    return push_cmd(CMD_SOURCE_LIVE, SYNTH_CMD_CONTROL_CHANGE, channel, controller, value);
+}
 
-            active_notes_cnt++;
-            break;
-        }
-    }
+esp_err_t synth_pitch_bend(uint8_t channel, uint8_t lsb, uint8_t msb)
+{
+    return push_cmd(CMD_SOURCE_LIVE, SYNTH_CMD_PITCH_BEND, channel, lsb, msb);
+}
 
-    return ESP_OK;
+esp_err_t synth_realtime(uint8_t status) { return push_cmd(CMD_SOURCE_LIVE, SYNTH_CMD_REALTIME, 0, status, 0); }
+
+uint32_t synth_now(void) { return play_clock + CMD_LATENCY; }
+
+/**
+ * @brief Queue an event for a given play clock sample
+ *
+ * Times must not go backwards from one call to the next. An event already
+ * in the past when the render task reaches it plays at once.
+ */
+esp_err_t synth_schedule(uint32_t time, const synth_cmd_t *cmd)
+{
+    timed_cmd_t timed = {.time = time, .cmd = *cmd};
+    return spsc_ring_push(&cmd_rings[CMD_SOURCE_SCHEDULED], &timed) ? ESP_OK : ESP_ERR_NO_MEM;
 }
 
-esp_err_t synth_stop_note(synth_note_t note)
+/**
+ * @brief Velocity curve of the next notes, queued so the engine is only
+ * touched by the render task
+ */
+esp_err_t synth_set_velocity_curve(velocity_curve_t curve)
 {
-    if (active_notes_cnt <= 0) return ESP_ERR_INVALID_STATE;
+    ESP_RETURN_ON_FALSE(curve < VELOCITY_CURVE_COUNT, ESP_ERR_INVALID_ARG, TAG, "Unknown velocity curve %d",
+        (int)curve);
 
-    uint8_t code = (note.octave + 2) * 12 + note.note;
-    for (int i = 0; i < SYNTH_MAX_CHORD_SIZE; ++i)
-    {
-        note_data_t *note = &active_notes[i];
-        if (note->code == code && note->active == 1)
-        {
-            // stop
-            note->active = 0;
+    return push_cmd(CMD_SOURCE_SETTINGS, SYNTH_CMD_SETTING, 0, SYNTH_SETTING_VELOCITY_CURVE, curve);
+}
 
-            active_notes_cnt--;
-            break;
-        }
+esp_err_t synth_set_steal_policy(synth_steal_policy_t policy)
+{
+    ESP_RETURN_ON_FALSE(policy < SYNTH_STEAL_COUNT, ESP_ERR_INVALID_ARG, TAG, "Unknown steal policy %d", (int)policy);
+
+    return push_cmd(CMD_SOURCE_SETTINGS, SYNTH_CMD_SETTING, 0, SYNTH_SETTING_STEAL_POLICY, policy);
+}
+
+void synth_log_render_load(void)
+{
+    uint32_t budget = (uint32_t)CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ * 1000000 / SYNTH_SAMPLING_RATE_HZ * SYNTH_BLOCK_SIZE;
+
+    for (int v = 0; v <= SYNTH_MAX_CHORD_SIZE; ++v)
+    {
+        if (render_cycles[v] == 0) continue;
+        ESP_LOGI(TAG, "%2d voices: %lu cycles/sample, %lu%% of the block period (%s)", v,
+            (unsigned long)(render_cycles[v] / SYNTH_BLOCK_SIZE), (unsigned long)(render_cycles[v] * 100 / budget),
+            RENDER_CORES_STR);
     }
 
-    return ESP_OK;
+    if (output != SYNTH_OUTPUT_PULSES) return;
+
+    pulse_train_stats_t stats;
+    pulse_train_get_stats(&stats);
+    ESP_LOGI(TAG, "%lu pulses, %lu merged, %lu dropped, %lu notes stolen", (unsigned long)stats.pulses,
+        (unsigned long)stats.merged, (unsigned long)stats.dropped, (unsigned long)stats.steals);
 }
 
 esp_err_t synth_enable(void) { return gptimer_start(gptimer); }
@@ -191,3 +520,35 @@ esp_err_t synth_set_on_sampling_cb(synth_on_sampling_cb_t cb)
     on_sampling_cb = cb;
     return cb ? ESP_OK : ESP_ERR_INVALID_ARG;
 }
+
+esp_err_t synth_set_on_pulse_cb(synth_on_pulse_cb_t cb)
+{
+    on_pulse_cb = cb;
+    return cb ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+/**
+ * @brief Play notes as audio samples or as pulse trains
+ *
+ * Change it with the synth disabled, notes sounding in one output are not
+ * carried to the other.
+ */
+esp_err_t synth_set_output(synth_output_t out)
+{
+    ESP_RETURN_ON_FALSE(out == SYNTH_OUTPUT_AUDIO || out == SYNTH_OUTPUT_PULSES, ESP_ERR_INVALID_ARG, TAG,
+        "Unknown output %d", (int)out);
+
+    output = out;
+    ESP_LOGI(TAG, "Output: %s", out == SYNTH_OUTPUT_PULSES ? "pulse trains" : "audio");
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Pulse width of a full velocity note, capped to CONFIG_INTERRUPTER_TON_MAX
+ */
+esp_err_t synth_set_pulse_width(uint16_t width_us)
+{
+    pulse_width = width_us;
+    return ESP_OK;
+}
@@ -27,16 +27,23 @@ extern "C"
 // -----------------------------------------------------------------------------
 // Includes
 // -----------------------------------------------------------------------------
+#include "dsp/pulse_train.h"
+#include "dsp/synth_engine.h"
 #include "esp_err.h"
 
 // -----------------------------------------------------------------------------
 // Macros and Constants
 // -----------------------------------------------------------------------------
-#define SYNTH_MAX_CHORD_SIZE (8)
-#define SYNTH_SAMPLING_RATE_HZ (16000)
-#define SYNTH_RESOLUTION_BITS 16
-#define SYNTH_OUT_MAX ((1U << SYNTH_RESOLUTION_BITS) - 1)
-#define SYNTH_OUT_SILENCE (SYNTH_OUT_MAX / 2)
+#define SYNTH_BLOCK_SIZE (SYNTH_CONTROL_PERIOD / 2)  // Samples rendered per block, 2 ms at 16 kHz
+#define SYNTH_BLOCK_COUNT (4)   // Blocks queued ahead of the sampling timer, power of two
+#define SYNTH_CMD_QUEUE_LEN (64)  // Pending note/controller events, power of two
+#define SYNTH_SCHEDULE_QUEUE_LEN (128)  // Pending synth_schedule() events, power of two
+#define SYNTH_SETTINGS_QUEUE_LEN (8)  // Pending engine settings, power of two
+
+// Play clock at power on, a host check starts it short of 2^32 to play across the wrap
+#ifndef SYNTH_CLOCK_START
+#define SYNTH_CLOCK_START (0)
+#endif
 
 // -----------------------------------------------------------------------------
 // Type Definitions
@@ -63,10 +70,17 @@ typedef struct
     synth_note_name_t note;
 } synth_note_t;
 
+typedef enum
+{
+    SYNTH_OUTPUT_AUDIO = 0,  // Rendered samples to the sampling callback
+    SYNTH_OUTPUT_PULSES      // One coil pulse per note period to the pulse callback
+} synth_output_t;
+
 // -----------------------------------------------------------------------------
 // Inline Function Definitions
 // -----------------------------------------------------------------------------
 typedef void (* synth_on_sampling_cb_t)(uint16_t value);
+typedef void (* synth_on_pulse_cb_t)(const pulse_t *pulse);
 
 // -----------------------------------------------------------------------------
 // Function Declarations
@@ -74,10 +88,32 @@ typedef void (* synth_on_sampling_cb_t)(uint16_t value);
 esp_err_t synth_init(void);
 esp_err_t synth_enable(void);
 esp_err_t synth_disable(void);
-esp_err_t synth_play_note(synth_note_t note);
-esp_err_t synth_stop_note(synth_note_t note);
+// Queued to the render task and played a fixed latency after the call, to the
+// sample. Call them from a single task (the MIDI client)
+esp_err_t synth_play_note(synth_note_t note, uint8_t channel, uint8_t velocity);
+esp_err_t synth_stop_note(synth_note_t note, uint8_t channel);
+esp_err_t synth_set_program(uint8_t channel, uint8_t program);
+esp_err_t synth_control_change(uint8_t channel, uint8_t controller, uint8_t value);
+esp_err_t synth_pitch_bend(uint8_t channel, uint8_t lsb, uint8_t msb);
+// MIDI clock, start, continue and stop for the arpeggiator and step sequencer
+esp_err_t synth_realtime(uint8_t status);
+// Timestamped events from a second task (a sequencer), merged with the above.
+// synth_now() is the earliest play clock sample an event can still make.
+uint32_t synth_now(void);
+esp_err_t synth_schedule(uint32_t time, const synth_cmd_t *cmd);
+// Engine settings from a third task (the UI), applied by the render task at
+// synth_now() like live events
+esp_err_t synth_set_velocity_curve(velocity_curve_t curve);
+esp_err_t synth_set_steal_policy(synth_steal_policy_t policy);
+// Average render cost for each number of sounding voices seen so far
+void synth_log_render_load(void);
 
 esp_err_t synth_set_on_sampling_cb(synth_on_sampling_cb_t cb);
+// Pulses come from the render task ahead of the output, in time order, their
+// start in us of play clock
+esp_err_t synth_set_on_pulse_cb(synth_on_pulse_cb_t cb);
+esp_err_t synth_set_output(synth_output_t output);
+esp_err_t synth_set_pulse_width(uint16_t width_us);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+#
+# Distributed under terms of the MIT license.
+
+"""
+Render load of the synthesizer for each sampling rate and number of voices.
+
+Builds tools/synth_render once per rate from the project sdkconfig, renders
+chords of growing size and prints the CPU time of the rendered blocks as a
+percentage of real time, best of a few runs. Figures are for the host and
+only compare rates and voice counts with each other; on the board
+synth_log_render_load() gives the column of the rate it was built for.
+
+    bench_rates.py --voices 1,4,8,16 --program 0 --runs 5
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+TOOLS_DIR = os.path.dirname(os.path.abspath(__file__))
+RENDER_DIR = os.path.join(TOOLS_DIR, "synth_render")
+SDKCONFIG = os.path.join(TOOLS_DIR, "..", "sdkconfig")
+
+RATES = [8000, 16000, 24000, 32000]
+RENDER_MS = 5000
+LOAD_RE = re.compile(r"render: ([0-9.]+) ms of host CPU per second of audio")
+
+
+def sdkconfig_for(rate, path):
+    """Project sdkconfig with only the sampling rate choice changed"""
+    with open(SDKCONFIG) as f:
+        lines = f.read().splitlines()
+
+    out = []
+    for line in lines:
+        m = re.match(r"^(# )?CONFIG_INTERRUPTER_SYNTH_SAMPLE_RATE_(\d+)K(=y| is not set)$", line)
+        if m:
+            k = int(m.group(2))
+            line = (f"CONFIG_INTERRUPTER_SYNTH_SAMPLE_RATE_{k}K=y" if k * 1000 == rate else
+                    f"# CONFIG_INTERRUPTER_SYNTH_SAMPLE_RATE_{k}K is not set")
+        elif line.startswith("CONFIG_INTERRUPTER_SYNTH_SAMPLE_RATE_HZ="):
+            line = f"CONFIG_INTERRUPTER_SYNTH_SAMPLE_RATE_HZ={rate}"
+        out.append(line)
+
+    with open(path, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+def build(rate, work):
+    config = os.path.join(work, f"sdkconfig.{rate}")
+    build_dir = os.path.join(work, f"build.{rate}")
+    sdkconfig_for(rate, config)
+
+    subprocess.run(["cmake", "-S", RENDER_DIR, "-B", build_dir, f"-DSDKCONFIG={config}"], check=True,
+                   stdout=subprocess.DEVNULL)
+    subprocess.run(["cmake", "--build", build_dir, "-j", str(os.cpu_count() or 1)], check=True,
+                   stdout=subprocess.DEVNULL)
+
+    return os.path.join(build_dir, "synth_render")
+
+
+def load(binary, voices, program, work):
+    """Percent of real time spent rendering a held chord"""
+    script = os.path.join(work, "chord.txt")
+    with open(script, "w") as f:
+        f.write(f"0 prog 1 {program}\n")
+        for v in range(voices):
+            f.write(f"0 on 1 {36 + 3 * v} 100\n")
+        f.write(f"{RENDER_MS} cc 1 123 0\n")
+
+    result = subprocess.run([binary, "-t", "0", "-o", os.path.join(work, "out.wav"), script], check=True,
+                            capture_output=True, text=True)
+    m = LOAD_RE.search(result.stdout)
+    if not m:
+        sys.exit(f"Unexpected synth_render output:\n{result.stdout}")
+
+    return float(m.group(1)) / 10
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--voices", default="0,1,2,4,8,16", help="comma separated chord sizes")
+    parser.add_argument("--program", type=int, default=0, help="MIDI program of the chord")
+    parser.add_argument("--rates", default=",".join(str(r) for r in RATES), help="comma separated rates in Hz")
+    parser.add_argument("--runs", type=int, default=3, help="renders per entry, the fastest is kept")
+    args = parser.parse_args()
+
+    voices = [int(v) for v in args.voices.split(",")]
+    rates = [int(r) for r in args.rates.split(",")]
+
+    with tempfile.TemporaryDirectory() as work:
+        table = {}
+        for rate in rates:
+            binary = build(rate, work)
+            for v in voices:
+                table[rate, v] = min(load(binary, v, args.program, work) for _ in range(args.runs))
+
+    print("voices " + "".join(f"{r // 1000:>7} kHz" for r in rates))
+    for v in voices:
+        print(f"{v:>6} " + "".join(f"{table[r, v]:>9.3f} %" for r in rates))
+
+
+if __name__ == "__main__":
+    main()
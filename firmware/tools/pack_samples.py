@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+#
+# Distributed under terms of the MIT license.
+
+"""
+Pack mono WAV files into a sample bank image for the "samples" partition.
+
+Each input is FILE:ROOT[:LOW-HIGH] where ROOT is the MIDI note the recording
+plays at its own rate and LOW-HIGH the notes it answers to (ROOT alone by
+default). Layout must match firmware/main/dsp/sampler.h.
+
+    pack_samples.py --adpcm -o samples.bin kick.wav:36 voice.wav:60:48-72
+    parttool.py write_partition --partition-name samples --input samples.bin
+"""
+
+import argparse
+import struct
+import sys
+import wave
+
+MAGIC = 0x4C504D53
+VERSION = 1
+HEADER = struct.Struct("<IHH")
+ENTRY = struct.Struct("<IIHBBBBBBhH")
+FORMAT_PCM16 = 0
+FORMAT_IMA_ADPCM = 1
+
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8] * 2
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+    107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871,
+    5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623,
+    27086, 29794, 32767,
+]
+
+
+def ima_encode(samples):
+    """Encode to a headerless nibble stream, low nibble first.
+
+    The decoder starts from the first sample with the step index that best
+    fits the opening of the recording, returned alongside the data.
+    """
+    predictor = samples[0] if samples else 0
+    index = 0
+    if len(samples) > 1:
+        opening = max(abs(b - a) for a, b in zip(samples[:64], samples[1:65]))
+        while index < 88 and STEP_TABLE[index] < opening:
+            index += 1
+    start = (predictor, index)
+
+    nibbles = []
+    for s in samples:
+        step = STEP_TABLE[index]
+        diff = s - predictor
+        nibble = 0
+        if diff < 0:
+            nibble = 8
+            diff = -diff
+        delta = step >> 3
+        if diff >= step:
+            nibble |= 4
+            diff -= step
+            delta += step
+        if diff >= step >> 1:
+            nibble |= 2
+            diff -= step >> 1
+            delta += step >> 1
+        if diff >= step >> 2:
+            nibble |= 1
+            delta += step >> 2
+        predictor = max(-32768, min(32767, predictor - delta if nibble & 8 else predictor + delta))
+        index = max(0, min(88, index + INDEX_TABLE[nibble]))
+        nibbles.append(nibble)
+
+    if len(nibbles) & 1:
+        nibbles.append(0)
+    data = bytes(nibbles[i] | nibbles[i + 1] << 4 for i in range(0, len(nibbles), 2))
+    return data, start
+
+
+def read_wav(path):
+    with wave.open(path, "rb") as w:
+        if w.getnchannels() != 1 or w.getsampwidth() != 2:
+            sys.exit(f"{path}: only mono 16-bit WAV is supported")
+        rate = w.getframerate()
+        frames = w.readframes(w.getnframes())
+    return rate, list(struct.unpack(f"<{len(frames) // 2}h", frames))
+
+
+def parse_spec(spec):
+    parts = spec.split(":")
+    root = int(parts[1])
+    low, high = root, root
+    if len(parts) > 2:
+        low, high = (int(n) for n in parts[2].split("-"))
+    return parts[0], root, low, high
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("inputs", nargs="+", metavar="FILE:ROOT[:LOW-HIGH]")
+    parser.add_argument("-o", "--output", required=True)
+    parser.add_argument("--adpcm", action="store_true", help="IMA-ADPCM, 4x smaller than PCM")
+    args = parser.parse_args()
+
+    entries = []
+    blobs = []
+    offset = HEADER.size + ENTRY.size * len(args.inputs)
+
+    for spec in args.inputs:
+        path, root, low, high = parse_spec(spec)
+        rate, samples = read_wav(path)
+        if args.adpcm:
+            data, (predictor, index) = ima_encode(samples)
+            fmt = FORMAT_IMA_ADPCM
+        else:
+            data, predictor, index = struct.pack(f"<{len(samples)}h", *samples), 0, 0
+            fmt = FORMAT_PCM16
+
+        offset += offset & 1  # PCM16 samples are read as aligned halfwords
+        entries.append(ENTRY.pack(offset, len(samples), rate, fmt, root, low, high, index, 0, predictor, 0))
+        blobs.append((offset, data))
+        offset += len(data)
+
+    image = bytearray(offset)
+    image[: HEADER.size] = HEADER.pack(MAGIC, VERSION, len(entries))
+    for i, e in enumerate(entries):
+        image[HEADER.size + i * ENTRY.size : HEADER.size + (i + 1) * ENTRY.size] = e
+    for start, data in blobs:
+        image[start : start + len(data)] = data
+
+    with open(args.output, "wb") as f:
+        f.write(image)
+    print(f"{args.output}: {len(entries)} samples, {len(image)} bytes")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file accumulate_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/mixer.h"
+#include "host_check.h"
+#include <stdio.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: accumulate_check\n"                                                                                        \
+    "\n"                                                                                                               \
+    "Checks the reference voice accumulation of the mixer, the one the vector\n"                                       \
+    "path must match: every sample at gains from 0 to unity against the floor\n"                                       \
+    "of the exact product, voices summed in any order, and mixer_accumulate()\n"                                       \
+    "equal to it on aligned and unaligned buffers of every length. Then prints\n"                                      \
+    "the host time of the reference mixing 16 to 32 voices.\n"
+
+#define SAMPLES 65536 // Every int16
+#define BLOCK_LEN 72
+#define VOICES 16
+#define BENCH_VOICES 32
+#define BENCH_BLOCKS 20000
+#define BENCH_RUNS 5 // Best of, against scheduling noise
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const uint32_t gains[] = {0, 1, 2, 255, 12345, 16384, MIXER_GAIN_ONE - 1, MIXER_GAIN_ONE};
+
+static int16_t in[SAMPLES] __attribute__((aligned(MIXER_ALIGN)));
+static int32_t acc[SAMPLES] __attribute__((aligned(MIXER_ALIGN)));
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief (x * gain) / 2^15 rounded toward minus infinity, in 64 bits
+ */
+static int64_t floor_scaled(int64_t x, uint32_t gain)
+{
+    int64_t p = x * gain;
+
+    return p >= 0 ? p / MIXER_GAIN_ONE : -((-p + MIXER_GAIN_ONE - 1) / MIXER_GAIN_ONE);
+}
+
+/**
+ * @brief Accumulator before a sample is added, of either sign
+ */
+static inline int32_t base(int32_t n) { return (n % 3 - 1) * 1000000 + n; }
+
+/**
+ * @brief Every sample, over accumulators of both signs, at each gain
+ */
+static void check_exhaustive(void)
+{
+    for (size_t g = 0; g < sizeof(gains) / sizeof(gains[0]); ++g)
+    {
+        int failed = 0;
+
+        for (int32_t n = 0; n < SAMPLES; ++n)
+        {
+            in[n] = (int16_t)(n - 32768);
+            acc[n] = base(n);
+        }
+        mixer_accumulate_ref(acc, in, gains[g], SAMPLES);
+
+        for (int32_t n = 0; n < SAMPLES && failed < 4; ++n)
+        {
+            int64_t want = floor_scaled(in[n], gains[g]);
+            if (!CHECK(acc[n] - base(n) == want, "gain %lu: %d adds %ld, %lld expected", (unsigned long)gains[g],
+                    in[n], (long)(acc[n] - base(n)), (long long)want))
+                failed++;
+        }
+    }
+
+    // Unity passes samples through, zero adds nothing
+    for (int32_t n = 0; n < SAMPLES; ++n) acc[n] = 0;
+    mixer_accumulate_ref(acc, in, MIXER_GAIN_ONE, SAMPLES);
+    mixer_accumulate_ref(acc, in, 0, SAMPLES);
+    for (int32_t n = 0; n < SAMPLES; ++n)
+        if (!CHECK(acc[n] == in[n], "%d at unity gain gives %ld", in[n], (long)acc[n])) break;
+}
+
+/**
+ * @brief A chord sums to the same accumulator whatever the voice order
+ */
+static void check_voices(void)
+{
+    static int16_t voices[VOICES][BLOCK_LEN];
+    static int32_t forward[BLOCK_LEN], backward[BLOCK_LEN];
+    uint32_t seed = 7;
+
+    for (int v = 0; v < VOICES; ++v)
+        for (int n = 0; n < BLOCK_LEN; ++n)
+        {
+            seed = seed * 1664525 + 1013904223;
+            voices[v][n] = n == v ? (v % 2 ? -32768 : 32767) : (int16_t)(seed >> 16);
+        }
+
+    memset(forward, 0, sizeof(forward));
+    memset(backward, 0, sizeof(backward));
+    for (int v = 0; v < VOICES; ++v)
+    {
+        mixer_accumulate_ref(forward, voices[v], gains[v % 8], BLOCK_LEN);
+        mixer_accumulate_ref(backward, voices[VOICES - 1 - v], gains[(VOICES - 1 - v) % 8], BLOCK_LEN);
+    }
+
+    for (int n = 0; n < BLOCK_LEN; ++n)
+    {
+        int64_t want = 0;
+        for (int v = 0; v < VOICES; ++v) want += floor_scaled(voices[v][n], gains[v % 8]);
+        CHECK(forward[n] == want && backward[n] == want, "sample %d of %d voices: %ld and %ld, %lld expected", n,
+            VOICES, (long)forward[n], (long)backward[n], (long long)want);
+    }
+}
+
+/**
+ * @brief The dispatching mixer_accumulate() gives the reference at any alignment
+ */
+static void check_dispatch(void)
+{
+    static int32_t ref[BLOCK_LEN + 4];
+    uint32_t seed = 3;
+
+    for (size_t shift = 0; shift < 4; ++shift)
+        for (size_t len = 0; len <= BLOCK_LEN; ++len)
+            for (size_t g = 0; g < sizeof(gains) / sizeof(gains[0]); ++g)
+            {
+                for (size_t n = 0; n < len + shift; ++n)
+                {
+                    seed = seed * 1664525 + 1013904223;
+                    in[n] = (int16_t)(seed >> 16);
+                    acc[n] = ref[n] = (int32_t)seed >> 4;
+                }
+
+                mixer_accumulate(acc + shift, in + shift, gains[g], len);
+                mixer_accumulate_ref(ref + shift, in + shift, gains[g], len);
+                CHECK(memcmp(acc, ref, (len + shift) * sizeof(acc[0])) == 0,
+                    "%zu samples %zu off alignment at gain %lu differ from the reference", len, shift,
+                    (unsigned long)gains[g]);
+            }
+}
+
+/**
+ * @brief Host time of the reference mixing a block of every voice, 16 voices on
+ */
+static void bench_ref(void)
+{
+    static int16_t voices[BENCH_VOICES][BLOCK_LEN] __attribute__((aligned(MIXER_ALIGN)));
+    static int32_t mix[BLOCK_LEN] __attribute__((aligned(MIXER_ALIGN)));
+    uint32_t seed = 5;
+
+    for (int v = 0; v < BENCH_VOICES; ++v)
+        for (int n = 0; n < BLOCK_LEN; ++n)
+        {
+            seed = seed * 1664525 + 1013904223;
+            voices[v][n] = (int16_t)(seed >> 16);
+        }
+
+    for (int count = 16; count <= BENCH_VOICES; count += 8)
+    {
+        double best = 0;
+
+        for (int run = 0; run < BENCH_RUNS; ++run)
+        {
+            double t0 = host_check_now_ns();
+            for (int b = 0; b < BENCH_BLOCKS; ++b)
+            {
+                memset(mix, 0, sizeof(mix));
+                for (int v = 0; v < count; ++v) mixer_accumulate_ref(mix, voices[v], gains[v % 8], BLOCK_LEN);
+            }
+            double ns = (host_check_now_ns() - t0) / ((double)BENCH_BLOCKS * BLOCK_LEN);
+            if (run == 0 || ns < best) best = ns;
+        }
+
+        printf("reference mix of %d voices: %.2f ns per sample, %.3f ns per voice-sample (host time)\n", count, best,
+            best / count);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    check_exhaustive();
+    check_voices();
+    check_dispatch();
+    bench_ref();
+
+    return host_check_report("accumulate_check");
+}
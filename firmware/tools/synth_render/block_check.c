@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file block_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "hal/synth.h"
+#include "host_check.h"
+#include "host_rtos.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: block_check [played.raw]\n"                                                                                \
+    "\n"                                                                                                               \
+    "Plays a fixed set of events through the render task and the sampling timer\n"                                     \
+    "and checks the samples drained by the ISR against the engine rendered\n"                                          \
+    "directly in one pass: no block lost, repeated or out of order, events on\n"                                       \
+    "their sample, one sample and one clock step per alarm, no underrun. Then\n"                                       \
+    "prints the host time of the engine per sample for 1, 4 and 8 voices.\n"                                           \
+    "\n"                                                                                                               \
+    "The drained samples are written to played.raw when given, as native\n"                                            \
+    "16-bit words, to compare builds. A build with SYNTH_CLOCK_START just\n"                                           \
+    "short of 2^32 plays the same samples across the play clock wrap.\n"
+
+// Past the command latency of either render, so both play the events alike
+#define START (4 * SYNTH_BLOCK_COUNT * SYNTH_BLOCK_SIZE)
+#define LENGTH (SYNTH_SAMPLING_RATE_HZ / 2)
+
+#define COST_LEN (SYNTH_SAMPLING_RATE_HZ * 4)
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t time; // Samples after START
+    synth_cmd_t cmd;
+} event_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+// Off the block grid, on it, on its last sample, several on one sample, and
+// a note played again. No bend or vibrato: pitch moves at control rate, which
+// follows the split.
+static const event_t events[] = {
+    {0, {SYNTH_CMD_NOTE_ON, 0, 60, 100}},
+    {SYNTH_BLOCK_SIZE * 3 + 5, {SYNTH_CMD_NOTE_ON, 0, 64, 80}},
+    {SYNTH_BLOCK_SIZE * 3 + 5, {SYNTH_CMD_NOTE_ON, 0, 67, 60}},
+    {SYNTH_BLOCK_SIZE * 8, {SYNTH_CMD_PROGRAM_CHANGE, 1, 2, 0}},
+    {SYNTH_BLOCK_SIZE * 8, {SYNTH_CMD_NOTE_ON, 1, 48, 127}},
+    {SYNTH_BLOCK_SIZE * 12 - 1, {SYNTH_CMD_NOTE_OFF, 0, 60, 0}},
+    {SYNTH_BLOCK_SIZE * 20 + 17, {SYNTH_CMD_PROGRAM_CHANGE, 2, 3, 0}},
+    {SYNTH_BLOCK_SIZE * 20 + 17, {SYNTH_CMD_NOTE_ON, 2, 72, 90}},
+    {SYNTH_BLOCK_SIZE * 40 + 1, {SYNTH_CMD_CONTROL_CHANGE, 0, SYNTH_CC_SUSTAIN, 127}},
+    {SYNTH_BLOCK_SIZE * 41, {SYNTH_CMD_NOTE_OFF, 0, 64, 0}},
+    {SYNTH_BLOCK_SIZE * 41 + 2, {SYNTH_CMD_NOTE_OFF, 1, 48, 0}},
+    {SYNTH_BLOCK_SIZE * 60 + 11, {SYNTH_CMD_NOTE_ON, 0, 60, 100}},
+    {SYNTH_BLOCK_SIZE * 90 + 31, {SYNTH_CMD_CONTROL_CHANGE, 0, SYNTH_CC_SUSTAIN, 0}},
+    {SYNTH_BLOCK_SIZE * 90 + 31, {SYNTH_CMD_NOTE_OFF, 0, 67, 0}},
+    {SYNTH_BLOCK_SIZE * 100 + 9, {SYNTH_CMD_NOTE_OFF, 2, 72, 0}},
+    {SYNTH_BLOCK_SIZE * 100 + 9, {SYNTH_CMD_NOTE_OFF, 0, 60, 0}},
+};
+
+#define EVENT_COUNT (sizeof(events) / sizeof(events[0]))
+
+static uint16_t *played = NULL;
+static uint32_t played_len = 0;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void on_sampling_cb(uint16_t value)
+{
+    if (played_len < START + LENGTH) played[played_len] = value;
+    played_len++;
+}
+
+/**
+ * @brief The engine alone, split only at the events
+ */
+static void render_reference(uint16_t *out)
+{
+    uint32_t pos = 0;
+
+    synth_engine_init();
+
+    for (size_t e = 0; e <= EVENT_COUNT; ++e)
+    {
+        uint32_t end = e < EVENT_COUNT ? events[e].time : LENGTH;
+        if (end > pos) synth_engine_render(out + pos, end - pos);
+        pos = end;
+        if (e < EVENT_COUNT) synth_engine_apply(&events[e].cmd);
+    }
+}
+
+/**
+ * @brief Host time of the engine per sample with a chord of 1, 4 and 8 notes
+ */
+static void print_cost(void)
+{
+    static const int chords[] = {1, 4, 8};
+    static uint16_t out[COST_LEN];
+
+    for (size_t c = 0; c < sizeof(chords) / sizeof(chords[0]); ++c)
+    {
+        synth_engine_init();
+        for (int i = 0; i < chords[c]; ++i) synth_engine_note_on(48 + 5 * i, 0, 100);
+
+        double t0 = host_check_now_ns();
+        synth_engine_render(out, COST_LEN);
+        double ns = (host_check_now_ns() - t0) / COST_LEN;
+
+        printf("%d voices: %.1f ns per sample (host time)\n", chords[c], ns);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc > 2)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    uint16_t *reference = malloc(LENGTH * sizeof(*reference));
+    played = malloc((START + LENGTH) * sizeof(*played));
+    if (!reference || !played)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    render_reference(reference);
+
+    if (synth_init() != ESP_OK) return 1;
+    synth_set_on_sampling_cb(on_sampling_cb);
+    host_rtos_wait_idle();
+
+    for (size_t e = 0; e < EVENT_COUNT; ++e)
+        CHECK(synth_schedule(SYNTH_CLOCK_START + START + events[e].time, &events[e].cmd) == ESP_OK,
+            "event %zu not queued", e);
+
+    synth_enable();
+
+    // The render task is idle again before each alarm, so an alarm that does
+    // not move the clock can only be an empty ring
+    uint32_t underruns = 0;
+    for (uint32_t n = 0; n < START + LENGTH; ++n)
+    {
+        uint32_t now = synth_now();
+        host_timer_fire();
+        host_rtos_wait_idle();
+        if (synth_now() != now + 1) underruns++;
+    }
+
+    CHECK(played_len == START + LENGTH, "%lu samples out of %lu alarms", (unsigned long)played_len,
+        (unsigned long)(START + LENGTH));
+    CHECK(underruns == 0, "%lu alarms found the ring empty", (unsigned long)underruns);
+
+    uint32_t noisy = 0;
+    for (uint32_t n = 0; n < START; ++n) noisy += played[n] != SYNTH_OUT_SILENCE;
+    CHECK(noisy == 0, "%lu samples before the first event are not silence", (unsigned long)noisy);
+
+    uint32_t first_diff = LENGTH, diffs = 0;
+    for (uint32_t n = 0; n < LENGTH; ++n)
+    {
+        if (played[START + n] == reference[n]) continue;
+        if (first_diff == LENGTH) first_diff = n;
+        diffs++;
+    }
+    CHECK(diffs == 0, "%lu samples differ from the direct render, first at %lu (block %lu, offset %lu): %u, %u",
+        (unsigned long)diffs, (unsigned long)first_diff, (unsigned long)(first_diff / SYNTH_BLOCK_SIZE),
+        (unsigned long)(first_diff % SYNTH_BLOCK_SIZE), diffs ? played[START + first_diff] : 0,
+        diffs ? reference[first_diff] : 0);
+
+    // The events above must have been heard, or the comparison proves nothing
+    uint32_t peak = 0;
+    for (uint32_t n = 0; n < LENGTH; ++n)
+    {
+        uint32_t level = abs((int32_t)reference[n] - SYNTH_OUT_SILENCE);
+        if (level > peak) peak = level;
+    }
+    CHECK(peak > 1000, "reference peaks at %lu", (unsigned long)peak);
+
+    if (argc == 2)
+    {
+        FILE *f = fopen(argv[1], "wb");
+        CHECK(f && fwrite(played, sizeof(*played), START + LENGTH, f) == START + LENGTH && fclose(f) == 0,
+            "cannot write %s", argv[1]);
+    }
+
+    printf("%lu samples in %lu blocks of %d, %zu events\n", (unsigned long)played_len,
+        (unsigned long)(played_len / SYNTH_BLOCK_SIZE), SYNTH_BLOCK_SIZE, EVENT_COUNT);
+
+    print_cost();
+
+    return host_check_report("block_check");
+}
@@ -0,0 +1,353 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file drums_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/percussion.h"
+#include "dsp/synth_engine.h"
+#include "dsp/velocity.h"
+#include "dsp/wavetable.h"
+#include "host_check.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: drums_check\n"                                                                                             \
+    "\n"                                                                                                               \
+    "Renders the percussion kit: the note map, decay of every drum to silence,\n"                                      \
+    "velocity, the hi-hat choke group, retrigger in place, stealing of the\n"                                          \
+    "oldest drum past the pool, and a kit initialized again playing like the\n"                                        \
+    "first.\n"
+
+#define RATE SYNTH_SAMPLING_RATE_HZ
+#define MS (RATE / 1000)
+#define LEN (3 * RATE) // Past the longest drum, a crash cymbal of 1.2 s to -60 dB
+#define CHUNK SYNTH_CONTROL_PERIOD
+// Kits compared with drums rendered alone are struck on the chunk grid: a
+// drum under half an LSB still floors to -1 until the chunk that frees it ends
+#define GRID(n) ((n) * CHUNK)
+#define GAIN VELOCITY_GAIN_ONE
+
+#define FIRST_NOTE 35 // Acoustic bass drum
+#define LAST_NOTE 59  // Ride cymbal 2
+#define UNMAPPED 58   // Vibraslap, not in the kit
+
+#define SNARE 38
+#define CLOSED_HAT 42
+#define PEDAL_HAT 44
+#define OPEN_HAT 46
+#define TAMBOURINE 54
+#define COWBELL 56
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t time; // Samples
+    uint8_t note;
+} hit_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+// Tone drums only: no noise, so one drum renders the same alone or in a kit
+static const uint8_t tone_drums[] = {35, 36, 41, 43, 45, 47, 48, 50};
+
+static int32_t played[LEN];
+static int32_t expected[LEN];
+static int32_t alone[LEN];
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static bool is_mapped(int note) { return note >= FIRST_NOTE && note <= LAST_NOTE && note != UNMAPPED; }
+
+/**
+ * @brief Render from a fresh kit, hits in time order, in blocks as the engine does
+ */
+static void play(const hit_t *hits, size_t count, int32_t *out, size_t len)
+{
+    size_t next = 0;
+
+    percussion_init(RATE);
+    memset(out, 0, len * sizeof(*out));
+
+    for (size_t pos = 0; pos < len;)
+    {
+        while (next < count && hits[next].time <= pos) percussion_trigger(hits[next++].note, GAIN);
+
+        size_t end = pos + CHUNK < len ? pos + CHUNK : len;
+        if (next < count && hits[next].time < end) end = hits[next].time;
+        percussion_render(out + pos, end - pos);
+        pos = end;
+    }
+}
+
+/**
+ * @brief Add one drum struck alone at start and cut at stop
+ */
+static void add_alone(int32_t *out, uint8_t note, uint32_t start, uint32_t stop)
+{
+    hit_t hit = {start, note};
+
+    play(&hit, 1, alone, LEN);
+    for (uint32_t n = start; n < stop && n < LEN; ++n) out[n] += alone[n];
+}
+
+static size_t first_diff(const int32_t *a, const int32_t *b, size_t len)
+{
+    for (size_t n = 0; n < len; ++n)
+        if (a[n] != b[n]) return n;
+
+    return len;
+}
+
+static size_t last_sound(const int32_t *x, size_t len)
+{
+    for (size_t n = len; n > 0; --n)
+        if (x[n - 1] != 0) return n;
+
+    return 0;
+}
+
+static double rms(const int32_t *x, size_t len)
+{
+    double sum = 0;
+    for (size_t n = 0; n < len; ++n) sum += (double)x[n] * x[n];
+
+    return sqrt(sum / len);
+}
+
+static void check_note_map(void)
+{
+    int mapped = 0;
+
+    for (int note = 0; note < 128; ++note)
+    {
+        percussion_init(RATE);
+        esp_err_t err = percussion_trigger(note, GAIN);
+        CHECK((err == ESP_OK) == is_mapped(note) && (err == ESP_OK || err == ESP_ERR_NOT_SUPPORTED),
+            "note %d: error %d", note, err);
+        if (err != ESP_OK) continue;
+
+        memset(played, 0, sizeof(played));
+        percussion_render(played, 20 * MS);
+        CHECK(rms(played, 20 * MS) > 100, "note %d is silent", note);
+        mapped++;
+    }
+    CHECK(percussion_trigger(128, GAIN) == ESP_ERR_NOT_SUPPORTED, "note 128 accepted");
+
+    // Through the engine: unmapped notes are refused, note-offs ignored
+    synth_engine_init();
+    for (int note = 0; note < 128; ++note)
+    {
+        esp_err_t err = synth_engine_note_on(note, SYNTH_PERCUSSION_CHANNEL, 100);
+        CHECK(err == (is_mapped(note) ? ESP_OK : ESP_ERR_NOT_SUPPORTED), "channel 10 note %d: error %d", note,
+            err);
+        CHECK(synth_engine_note_off(note, SYNTH_PERCUSSION_CHANNEL) == ESP_OK, "channel 10 note-off %d", note);
+    }
+    CHECK(synth_engine_active_voices() == 0, "drums took %d melodic voices", synth_engine_active_voices());
+
+    printf("%d drums mapped from note %d to %d\n", mapped, FIRST_NOTE, LAST_NOTE);
+}
+
+/**
+ * @brief Every drum fades and frees its voice within twice its length
+ */
+static void check_decay(void)
+{
+    size_t longest = 0;
+
+    for (int note = FIRST_NOTE; note <= LAST_NOTE; ++note)
+    {
+        if (!is_mapped(note)) continue;
+
+        hit_t hit = {0, note};
+        play(&hit, 1, played, LEN);
+
+        // Exponential decays reach -60 dB at the length and half an LSB at
+        // 1.6 times it, hits ramp down to zero at the length
+        size_t end = last_sound(played, LEN);
+        size_t start_rms = end / 10;
+        CHECK(end > 0 && end < LEN - RATE, "note %d sounds for %zu samples", note, end);
+        CHECK(end > 0 && rms(played + end - start_rms, start_rms) < rms(played, start_rms) / 10,
+            "note %d does not fade", note);
+        if (end > longest) longest = end;
+
+        // Nothing left in the pool: a second render adds nothing
+        memset(played, 0, RATE / 10 * sizeof(*played));
+        percussion_render(played, RATE / 10);
+        CHECK(last_sound(played, RATE / 10) == 0, "note %d rings again", note);
+    }
+
+    printf("longest drum: %.0f ms\n", longest / (double)MS);
+}
+
+static void check_velocity(void)
+{
+    uint16_t soft = velocity_gain(VELOCITY_CURVE_LINEAR, 64);
+    uint16_t hard = velocity_gain(VELOCITY_CURVE_LINEAR, 127);
+    double level[2];
+
+    for (int i = 0; i < 2; ++i)
+    {
+        percussion_init(RATE);
+        percussion_trigger(COWBELL, i ? hard : soft);
+        memset(played, 0, sizeof(played));
+        percussion_render(played, 50 * MS);
+        level[i] = rms(played, 50 * MS);
+    }
+
+    CHECK(fabs(level[0] / level[1] - (double)soft / hard) < 0.01, "velocity 64 at %.3f of 127, %.3f expected",
+        level[0] / level[1], (double)soft / hard);
+}
+
+/**
+ * @brief Hi-hats cut each other, other drums do not
+ */
+static void check_choke(void)
+{
+    const uint8_t chokers[] = {CLOSED_HAT, PEDAL_HAT};
+    uint32_t at = GRID(12);
+
+    for (size_t i = 0; i < sizeof(chokers) / sizeof(chokers[0]); ++i)
+    {
+        hit_t hits[] = {{0, OPEN_HAT}, {at, chokers[i]}};
+        play(hits, 2, played, LEN);
+        size_t end = last_sound(played, LEN);
+        CHECK(end < at + 150 * MS, "open hi-hat still sounds %zu ms after hi-hat %d", (end - at) / MS, chokers[i]);
+    }
+
+    // Same timing with a drum out of the group: the open hi-hat rings on
+    hit_t hits[] = {{0, OPEN_HAT}, {at, TAMBOURINE}};
+    play(hits, 2, played, LEN);
+    size_t end = last_sound(played, LEN);
+    CHECK(end > at + 250 * MS, "tambourine cut the open hi-hat at %zu ms", end / MS);
+
+    // The closed hi-hat takes the open one's voice: with the rest of the pool
+    // busy no tone drum is stolen, and once the hi-hat ends only they are left
+    hit_t kit[PERCUSSION_VOICES + 1];
+    memset(expected, 0, sizeof(expected));
+    for (int d = 0; d < PERCUSSION_VOICES - 1; ++d)
+    {
+        kit[d] = (hit_t){GRID(d), tone_drums[d]};
+        add_alone(expected, tone_drums[d], GRID(d), LEN);
+    }
+    kit[PERCUSSION_VOICES - 1] = (hit_t){GRID(PERCUSSION_VOICES), OPEN_HAT};
+    kit[PERCUSSION_VOICES] = (hit_t){at, CLOSED_HAT};
+    play(kit, PERCUSSION_VOICES + 1, played, LEN);
+
+    size_t diff = first_diff(played + at + 150 * MS, expected + at + 150 * MS, LEN - at - 150 * MS);
+    CHECK(diff == LEN - at - 150 * MS, "choke with a full pool: tone drums differ %zu ms after the closed hi-hat",
+        diff / MS + 150);
+}
+
+/**
+ * @brief A drum struck again restarts in its own voice
+ */
+static void check_retrigger(void)
+{
+    uint32_t again = 100 * MS + 7;
+    hit_t hits[] = {{0, 45}, {again, 45}};
+
+    memset(expected, 0, sizeof(expected));
+    add_alone(expected, 45, 0, again);
+    add_alone(expected, 45, again, LEN);
+    play(hits, 2, played, LEN);
+
+    size_t diff = first_diff(played, expected, LEN);
+    CHECK(diff == LEN, "retriggered tom differs at %zu ms", diff / MS);
+}
+
+/**
+ * @brief Past the pool, the oldest drums are cut for the new ones
+ */
+static void check_steal(void)
+{
+    const size_t count = sizeof(tone_drums) / sizeof(tone_drums[0]);
+    hit_t hits[sizeof(tone_drums) / sizeof(tone_drums[0])];
+
+    memset(expected, 0, sizeof(expected));
+    for (size_t d = 0; d < count; ++d) hits[d] = (hit_t){GRID(3 * d), tone_drums[d]};
+
+    // Drum d is cut when drum d + PERCUSSION_VOICES is struck
+    for (size_t d = 0; d < count; ++d)
+    {
+        uint32_t cut = d + PERCUSSION_VOICES < count ? hits[d + PERCUSSION_VOICES].time : LEN;
+        add_alone(expected, tone_drums[d], hits[d].time, cut);
+    }
+    play(hits, count, played, LEN);
+
+    size_t diff = first_diff(played, expected, LEN);
+    CHECK(diff == LEN, "%zu drums on %d voices differ at %zu ms", count, PERCUSSION_VOICES, diff / MS);
+
+    // A drum done ringing frees its voice, nothing is stolen for the next one
+    hit_t reuse[PERCUSSION_VOICES + 1] = {{0, COWBELL}};
+    memset(expected, 0, sizeof(expected));
+    add_alone(expected, COWBELL, 0, LEN);
+    for (int d = 1; d <= PERCUSSION_VOICES; ++d)
+    {
+        reuse[d] = (hit_t){GRID(100 + d), tone_drums[d - 1]}; // Past the cowbell
+        add_alone(expected, tone_drums[d - 1], reuse[d].time, LEN);
+    }
+    play(reuse, PERCUSSION_VOICES + 1, played, LEN);
+
+    diff = first_diff(played, expected, LEN);
+    CHECK(diff == LEN, "drum struck after the cowbell ended stole a voice, differs at %zu ms", diff / MS);
+}
+
+/**
+ * @brief A kit initialized again plays like the first, noise included
+ */
+static void check_init(void)
+{
+    hit_t hits[] = {{0, SNARE}, {GRID(2), CLOSED_HAT}};
+
+    play(hits, 2, expected, LEN);
+    play(hits, 2, played, LEN);
+
+    size_t diff = first_diff(played, expected, LEN);
+    CHECK(diff == LEN, "a second kit differs at %zu ms", diff / MS);
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    wavetable_init();
+    check_note_map();
+    check_decay();
+    check_velocity();
+    check_choke();
+    check_retrigger();
+    check_steal();
+    check_init();
+
+    return host_check_report("drums_check");
+}
@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file envelope_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/envelope.h"
+#include "dsp/synth_engine.h"
+#include "host_check.h"
+#include <stdio.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: envelope_check\n"                                                                                          \
+    "\n"                                                                                                               \
+    "Counts the samples of each envelope stage, checks zero-length stages,\n"                                         \
+    "retriggers and the output range, then plays the sustain and sostenuto\n"                                         \
+    "pedals through the engine and counts the voices they hold.\n"
+
+#define RATE_HZ 16000
+#define OUT_ONE (1L << ENVELOPE_OUT_BITS)
+#define SUSTAIN_Q15 16384
+
+#define RANDOM_RUNS 2000
+#define SETTLE_SAMPLES (SYNTH_SAMPLING_RATE_HZ / 2) // Past the longest default release
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t samples;
+    int32_t first;
+    int32_t last;
+    bool monotonic;
+    bool in_range;
+} stage_run_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const envelope_config_t adsr = {.attack_ms = 10, .decay_ms = 20, .sustain_level = SUSTAIN_Q15, .release_ms = 30};
+
+static int16_t scratch[SETTLE_SAMPLES];
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief Step the envelope while it stays in its current stage
+ *
+ * @param direction 1 for a rise, -1 for a fall, 0 for a hold
+ */
+static stage_run_t run_stage(envelope_t *env, int direction, uint32_t max)
+{
+    stage_run_t run = {.monotonic = true, .in_range = true};
+    uint8_t stage = env->stage;
+    int32_t prev = env->level >> (ENVELOPE_LEVEL_BITS - ENVELOPE_OUT_BITS);
+
+    while (env->stage == stage && run.samples < max)
+    {
+        int32_t out = envelope_step(env);
+        if (run.samples == 0) run.first = out;
+        run.last = out;
+        run.samples++;
+
+        if (out < 0 || out > OUT_ONE) run.in_range = false;
+        if ((direction > 0 && out < prev) || (direction < 0 && out > prev) || (direction == 0 && out != prev))
+            run.monotonic = false;
+        prev = out;
+    }
+
+    return run;
+}
+
+static uint32_t samples_of(uint16_t ms) { return (uint32_t)ms * RATE_HZ / 1000; }
+
+static void check_stages(void)
+{
+    envelope_t env = {0};
+    envelope_start(&env, &adsr, RATE_HZ);
+    CHECK(env.stage == ENVELOPE_STAGE_ATTACK, "starts in stage %d", env.stage);
+
+    stage_run_t run = run_stage(&env, 1, UINT32_MAX);
+    CHECK(run.samples == samples_of(adsr.attack_ms), "attack lasts %lu samples", (unsigned long)run.samples);
+    CHECK(run.monotonic && run.in_range && run.last == OUT_ONE, "attack ends at %ld", (long)run.last);
+
+    run = run_stage(&env, -1, UINT32_MAX);
+    CHECK(run.samples == samples_of(adsr.decay_ms), "decay lasts %lu samples", (unsigned long)run.samples);
+    CHECK(run.monotonic && run.in_range && run.last == SUSTAIN_Q15, "decay ends at %ld", (long)run.last);
+    CHECK(env.stage == ENVELOPE_STAGE_SUSTAIN, "stage %d after the decay", env.stage);
+
+    run = run_stage(&env, 0, RATE_HZ * 10);
+    CHECK(run.samples == RATE_HZ * 10 && run.monotonic && run.first == SUSTAIN_Q15, "sustain moves or ends");
+
+    envelope_release(&env);
+    run = run_stage(&env, -1, UINT32_MAX);
+    CHECK(run.samples == samples_of(adsr.release_ms), "release lasts %lu samples", (unsigned long)run.samples);
+    CHECK(run.monotonic && run.in_range && run.last == 0, "release ends at %ld", (long)run.last);
+    CHECK(env.stage == ENVELOPE_STAGE_IDLE, "stage %d after the release", env.stage);
+
+    // Releasing an idle or releasing envelope does not restart it
+    envelope_release(&env);
+    CHECK(env.stage == ENVELOPE_STAGE_IDLE, "idle envelope released to stage %d", env.stage);
+}
+
+static void check_zero_stages(void)
+{
+    envelope_t env = {0};
+    envelope_config_t cfg = adsr;
+
+    cfg.attack_ms = 0;
+    envelope_start(&env, &cfg, RATE_HZ);
+    CHECK(env.stage == ENVELOPE_STAGE_DECAY && env.level == ENVELOPE_LEVEL_ONE, "no attack: stage %d level %ld",
+        env.stage, (long)env.level);
+
+    env = (envelope_t){0};
+    cfg.decay_ms = 0;
+    envelope_start(&env, &cfg, RATE_HZ);
+    CHECK(env.stage == ENVELOPE_STAGE_SUSTAIN && envelope_step(&env) == SUSTAIN_Q15,
+        "no attack or decay: stage %d", env.stage);
+
+    env = (envelope_t){0};
+    cfg = adsr;
+    cfg.decay_ms = 0;
+    envelope_start(&env, &cfg, RATE_HZ);
+    run_stage(&env, 1, UINT32_MAX);
+    CHECK(env.stage == ENVELOPE_STAGE_SUSTAIN, "no decay: stage %d after the attack", env.stage);
+
+    cfg.release_ms = 0;
+    envelope_start(&env, &cfg, RATE_HZ);
+    envelope_release(&env);
+    CHECK(env.stage == ENVELOPE_STAGE_IDLE && env.level == 0, "no release: stage %d level %ld", env.stage,
+        (long)env.level);
+}
+
+static void check_retrigger(void)
+{
+    envelope_t env = {0};
+    envelope_start(&env, &adsr, RATE_HZ);
+    run_stage(&env, 1, UINT32_MAX);
+    run_stage(&env, -1, UINT32_MAX);
+    envelope_release(&env);
+    run_stage(&env, -1, samples_of(adsr.release_ms) / 2);
+
+    // Rises again from where the release left it, over a full attack
+    int32_t level = env.level >> (ENVELOPE_LEVEL_BITS - ENVELOPE_OUT_BITS);
+    envelope_start(&env, &adsr, RATE_HZ);
+    stage_run_t run = run_stage(&env, 1, UINT32_MAX);
+    CHECK(run.first >= level && run.first < level + OUT_ONE / 100, "retrigger at %ld jumps to %ld", (long)level,
+        (long)run.first);
+    CHECK(run.samples == samples_of(adsr.attack_ms) && run.monotonic && run.last == OUT_ONE,
+        "retriggered attack lasts %lu samples", (unsigned long)run.samples);
+
+    // A release in the attack falls from the current level
+    env = (envelope_t){0};
+    envelope_start(&env, &adsr, RATE_HZ);
+    run_stage(&env, 1, samples_of(adsr.attack_ms) / 4);
+    level = env.level >> (ENVELOPE_LEVEL_BITS - ENVELOPE_OUT_BITS);
+    envelope_release(&env);
+    run = run_stage(&env, -1, UINT32_MAX);
+    CHECK(run.first <= level && run.samples == samples_of(adsr.release_ms) && run.monotonic && run.last == 0,
+        "release from the attack at %ld: %ld first, %lu samples", (long)level, (long)run.first,
+        (unsigned long)run.samples);
+}
+
+static void check_range(void)
+{
+    uint32_t seed = 7;
+    unsigned long out_of_range = 0;
+
+    for (int i = 0; i < RANDOM_RUNS; ++i)
+    {
+        seed = seed * 1664525 + 1013904223;
+        envelope_config_t cfg = {.attack_ms = seed % 50,
+            .decay_ms = (seed >> 8) % 50,
+            .sustain_level = (seed >> 12) % 32768,
+            .release_ms = (seed >> 20) % 50};
+        envelope_t env = {0};
+        uint32_t release_at = (seed >> 4) % (RATE_HZ / 5);
+
+        envelope_start(&env, &cfg, RATE_HZ);
+        for (uint32_t n = 0; n < RATE_HZ / 4; ++n)
+        {
+            if (n == release_at) envelope_release(&env);
+            // Retrigger some of the runs in the middle of their release
+            if (n == release_at + 10 && (seed & 1)) envelope_start(&env, &cfg, RATE_HZ);
+            int32_t out = envelope_step(&env);
+            if (out < 0 || out > OUT_ONE) out_of_range++;
+        }
+    }
+
+    CHECK(out_of_range == 0, "%lu samples out of 0..%ld", out_of_range, (long)OUT_ONE);
+}
+
+/**
+ * @brief Voices left after the longest release
+ */
+static uint8_t settle(void)
+{
+    host_check_render(scratch, SETTLE_SAMPLES);
+
+    return synth_engine_active_voices();
+}
+
+static void cc(uint8_t channel, uint8_t controller, uint8_t value)
+{
+    synth_cmd_t cmd = {SYNTH_CMD_CONTROL_CHANGE, channel, controller, value};
+    synth_engine_apply(&cmd);
+}
+
+static void check_sustain(void)
+{
+    synth_engine_init();
+
+    synth_engine_note_on(60, 0, 100);
+    cc(0, SYNTH_CC_SUSTAIN, 127);
+    synth_engine_note_off(60, 0);
+    synth_engine_note_on(64, 0, 100); // Struck with the pedal down
+    synth_engine_note_off(64, 0);
+    synth_engine_note_on(67, 0, 100); // Key still down at pedal up
+    synth_engine_note_on(48, 1, 100); // Other channel
+    synth_engine_note_off(48, 1);
+    CHECK(settle() == 3, "sustain holds %d voices", synth_engine_active_voices());
+
+    cc(0, SYNTH_CC_SUSTAIN, 0);
+    CHECK(settle() == 1, "%d voices after the sustain pedal", synth_engine_active_voices());
+
+    // The key let go sounds for its release and no longer
+    synth_engine_note_off(67, 0);
+    size_t tail = host_check_render_until_idle(SETTLE_SAMPLES);
+    uint32_t release = CONFIG_INTERRUPTER_SYNTH_RELEASE_MS * SYNTH_SAMPLING_RATE_HZ / 1000;
+    CHECK(synth_engine_active_voices() == 0 && tail >= release && tail <= release + SYNTH_CONTROL_PERIOD,
+        "%d voices, last key released in %zu samples", synth_engine_active_voices(), tail);
+}
+
+static void check_sostenuto(void)
+{
+    synth_engine_init();
+
+    synth_engine_note_on(60, 0, 100);
+    cc(0, SYNTH_CC_SOSTENUTO, 127);
+    synth_engine_note_on(64, 0, 100); // After the pedal, not latched
+    synth_engine_note_off(60, 0);
+    synth_engine_note_off(64, 0);
+    CHECK(settle() == 1, "sostenuto holds %d voices", synth_engine_active_voices());
+    CHECK(synth_engine_note_off(60, 0) == ESP_ERR_INVALID_STATE, "latched note still has its key down");
+
+    // Struck again while latched, the latched voice plays on and the new one
+    // is released with its key
+    synth_engine_note_on(60, 0, 100);
+    synth_engine_note_off(60, 0);
+    CHECK(settle() == 1, "restruck latched note: %d voices", synth_engine_active_voices());
+
+    cc(0, SYNTH_CC_SOSTENUTO, 0);
+    CHECK(settle() == 0, "%d voices after the sostenuto pedal", synth_engine_active_voices());
+
+    // Sustain and sostenuto together, each holds until both are up
+    synth_engine_note_on(60, 0, 100);
+    cc(0, SYNTH_CC_SOSTENUTO, 127);
+    cc(0, SYNTH_CC_SUSTAIN, 127);
+    synth_engine_note_off(60, 0);
+    cc(0, SYNTH_CC_SUSTAIN, 0);
+    CHECK(settle() == 1, "sostenuto let go under sustain");
+    cc(0, SYNTH_CC_SUSTAIN, 127);
+    cc(0, SYNTH_CC_SOSTENUTO, 0);
+    CHECK(settle() == 1, "sustain let go under sostenuto");
+    cc(0, SYNTH_CC_SUSTAIN, 0);
+    CHECK(settle() == 0, "%d voices after both pedals", synth_engine_active_voices());
+}
+
+static void check_channel_messages(void)
+{
+    synth_engine_init();
+
+    // Reset controllers lets both pedals go
+    synth_engine_note_on(60, 0, 100);
+    cc(0, SYNTH_CC_SOSTENUTO, 127);
+    synth_engine_note_on(64, 0, 100);
+    cc(0, SYNTH_CC_SUSTAIN, 127);
+    synth_engine_note_off(60, 0);
+    synth_engine_note_off(64, 0);
+    CHECK(settle() == 2, "%d voices under both pedals", synth_engine_active_voices());
+    cc(0, SYNTH_CC_RESET_CONTROLLERS, 0);
+    CHECK(settle() == 0, "%d voices after reset controllers", synth_engine_active_voices());
+
+    // All notes off lets the keys go, not the pedals
+    synth_engine_note_on(60, 0, 100);
+    synth_engine_note_on(64, 1, 100);
+    cc(0, SYNTH_CC_SUSTAIN, 127);
+    cc(0, SYNTH_CC_ALL_NOTES_OFF, 0);
+    cc(1, SYNTH_CC_ALL_NOTES_OFF, 0);
+    CHECK(settle() == 1, "%d voices after all notes off", synth_engine_active_voices());
+    CHECK(synth_engine_note_off(60, 0) == ESP_ERR_INVALID_STATE, "all notes off left the key down");
+    cc(0, SYNTH_CC_SUSTAIN, 0);
+    CHECK(settle() == 0, "%d voices after the pedal", synth_engine_active_voices());
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    check_stages();
+    check_zero_stages();
+    check_retrigger();
+    check_range();
+
+    check_sustain();
+    check_sostenuto();
+    check_channel_messages();
+
+    return host_check_report("envelope_check");
+}
@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file fm_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/fm.h"
+#include "dsp/note_table.h"
+#include "dsp/synth_engine.h"
+#include "dsp/wavetable.h"
+#include "host_check.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: fm_check\n"                                                                                                \
+    "\n"                                                                                                               \
+    "Plays every FM patch and checks its spectrum against the Bessel weights\n"                                       \
+    "of its ratio and index: sustained, and along the decay of the index\n"                                           \
+    "envelope. Also checks the patch table bounds and the program mapping.\n"
+
+#define CODE 57 // A3, the widest patch keeps its sidebands under Nyquist
+#define CHANNEL 0
+#define PHASE_ONE 4294967296.0
+#define NYQUIST_HZ (SYNTH_SAMPLING_RATE_HZ / 2.0)
+
+#define SIDEBANDS 16 // Each side of the carrier, Bessel weights past it are negligible
+#define COMPONENTS (2 * SIDEBANDS + 1)
+
+#define SUSTAIN_AT (2 * SYNTH_SAMPLING_RATE_HZ) // Past the longest index decay
+#define SUSTAIN_LEN (SYNTH_SAMPLING_RATE_HZ / 2)
+#define SUSTAIN_TOL 0.01 // Of the peak amplitude, per component
+#define POWER_TOL 0.01   // Share of the power outside the predicted components
+
+#define DECAY_START (SYNTH_SAMPLING_RATE_HZ / 8) // Past the amplitude attack and decay
+#define DECAY_WINDOW (SYNTH_SAMPLING_RATE_HZ / 20)
+#define DECAY_TOL 0.04 // The index moves within a window
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    double hz;
+    double amplitude; // Of the peak amplitude
+} component_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static int16_t buf[SUSTAIN_AT + SUSTAIN_LEN];
+static component_t components[COMPONENTS];
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static double carrier_hz(void) { return note_table_phase_inc(CODE) * (double)SYNTH_SAMPLING_RATE_HZ / PHASE_ONE; }
+
+static double modulator_hz(const fm_patch_t *patch)
+{
+    return fm_mod_inc(note_table_phase_inc(CODE), patch->ratio) * (double)SYNTH_SAMPLING_RATE_HZ / PHASE_ONE;
+}
+
+/**
+ * @brief Index in radians for a Q15 level of the index envelope
+ */
+static double index_at(const fm_patch_t *patch, double level)
+{
+    return 2 * M_PI * patch->depth * level / 32768.0 / (1 << FM_DEPTH_BITS);
+}
+
+/**
+ * @brief Spectrum of sin(wc t + index sin(wm t)), folded at 0 Hz
+ *
+ * Sideband k has the weight J_k(index) at fc + k fm. Both phases start
+ * together, so sidebands landing on one frequency add with their sign, and
+ * a negative frequency folds back inverted. The sum is scaled to the peak
+ * amplitude, which folding moves away from 1. Returns the count of components.
+ */
+static size_t fm_spectrum(const fm_patch_t *patch, double index)
+{
+    double fc = carrier_hz();
+    double fm = modulator_hz(patch);
+    size_t count = 0;
+
+    for (int k = -SIDEBANDS; k <= SIDEBANDS; ++k)
+    {
+        double hz = fc + k * fm;
+        double weight = jn(k, index) * (hz < 0 ? -1 : 1);
+        if (fabs(hz) < 1e-6) continue; // sin(0)
+
+        size_t c = 0;
+        while (c < count && fabs(components[c].hz - fabs(hz)) > 1e-6) c++;
+        if (c == count) components[count++] = (component_t){.hz = fabs(hz), .amplitude = 0};
+        components[c].amplitude += weight;
+    }
+
+    double power = 0;
+    for (size_t c = 0; c < count; ++c)
+        if (components[c].hz < NYQUIST_HZ) power += components[c].amplitude * components[c].amplitude;
+    for (size_t c = 0; c < count; ++c) components[c].amplitude = fabs(components[c].amplitude) / sqrt(power);
+
+    return count;
+}
+
+static double expected_at(size_t count, double hz)
+{
+    for (size_t c = 0; c < count; ++c)
+        if (fabs(components[c].hz - hz) <= 1e-6) return components[c].amplitude;
+
+    return 0;
+}
+
+/**
+ * @brief Level of the index envelope t samples after the strike, Q15
+ */
+static double index_level_at(const fm_patch_t *patch, double t)
+{
+    double attack = (double)patch->index_env.attack_ms * SYNTH_SAMPLING_RATE_HZ / 1000;
+    double decay = (double)patch->index_env.decay_ms * SYNTH_SAMPLING_RATE_HZ / 1000;
+    double sustain = patch->index_env.sustain_level;
+
+    if (t < attack) return 32768 * t / attack;
+    if (t < attack + decay) return 32768 - (32768 - sustain) * (t - attack) / decay;
+
+    return sustain;
+}
+
+static double peak_of(const int16_t *x, size_t len)
+{
+    double sum = 0;
+    for (size_t n = 0; n < len; ++n) sum += (double)x[n] * x[n];
+
+    return sqrt(2 * sum / len);
+}
+
+static void check_sustain(fm_patch_id_t id)
+{
+    const fm_patch_t *patch = fm_patch_get(id);
+    const int16_t *x = buf + SUSTAIN_AT;
+
+    synth_engine_init();
+    synth_engine_set_fm_patch(CHANNEL, id);
+    synth_engine_note_on(CODE, CHANNEL, 127);
+    host_check_render(buf, SUSTAIN_AT + SUSTAIN_LEN);
+
+    double index = index_at(patch, patch->index_env.sustain_level);
+    size_t count = fm_spectrum(patch, index);
+    double peak = peak_of(x, SUSTAIN_LEN);
+    double power = 0, worst = 0;
+
+    for (size_t c = 0; c < count; ++c)
+    {
+        if (components[c].hz >= NYQUIST_HZ) continue;
+
+        double measured = host_check_amplitude(x, SUSTAIN_LEN, components[c].hz, SYNTH_SAMPLING_RATE_HZ) / peak;
+        double error = fabs(measured - components[c].amplitude);
+        CHECK(error <= SUSTAIN_TOL, "%s: %.1f Hz at %.4f, %.4f expected", patch->name, components[c].hz, measured,
+            components[c].amplitude);
+        if (error > worst) worst = error;
+        power += measured * measured;
+    }
+
+    CHECK(fabs(1 - power) <= POWER_TOL, "%s: %.2f%% of the power off the sidebands", patch->name,
+        100 * (1 - power));
+    printf("%-8s ratio %.2f, index %.2f sustained: sidebands within %.4f\n", patch->name,
+        patch->ratio / (double)(1 << FM_RATIO_BITS), index, worst);
+}
+
+/**
+ * @brief Carrier and first upper sideband along the index envelope
+ */
+static void check_decay(fm_patch_id_t id)
+{
+    const fm_patch_t *patch = fm_patch_get(id);
+    uint32_t len = (uint32_t)(patch->index_env.attack_ms + patch->index_env.decay_ms) * SYNTH_SAMPLING_RATE_HZ / 1000
+                 + SUSTAIN_LEN;
+    double fc = carrier_hz();
+    double upper = fc + modulator_hz(patch);
+    double worst = 0;
+
+    synth_engine_init();
+    synth_engine_set_fm_patch(CHANNEL, id);
+    synth_engine_note_on(CODE, CHANNEL, 127);
+    host_check_render(buf, len);
+
+    for (uint32_t start = DECAY_START; start + DECAY_WINDOW <= len; start += DECAY_WINDOW)
+    {
+        const int16_t *x = buf + start;
+        double t = start + DECAY_WINDOW / 2.0;
+        double index = index_at(patch, index_level_at(patch, t));
+        size_t count = fm_spectrum(patch, index);
+        double peak = peak_of(x, DECAY_WINDOW);
+        double carrier = host_check_amplitude(x, DECAY_WINDOW, fc, SYNTH_SAMPLING_RATE_HZ) / peak;
+        double side = host_check_amplitude(x, DECAY_WINDOW, upper, SYNTH_SAMPLING_RATE_HZ) / peak;
+        double error = fmax(fabs(carrier - expected_at(count, fc)), fabs(side - expected_at(count, upper)));
+
+        CHECK(error <= DECAY_TOL, "%s at %.0f ms, index %.2f: carrier %.3f and sideband %.3f, %.3f and %.3f expected",
+            patch->name, 1000 * t / SYNTH_SAMPLING_RATE_HZ, index, carrier, side, expected_at(count, fc),
+            expected_at(count, upper));
+        if (error > worst) worst = error;
+    }
+
+    printf("%-8s index envelope over %lu ms: carrier and sideband within %.4f\n", patch->name,
+        (unsigned long)len * 1000 / SYNTH_SAMPLING_RATE_HZ, worst);
+}
+
+static void check_patches(void)
+{
+    for (fm_patch_id_t id = 0; id < FM_PATCH_COUNT; ++id)
+    {
+        const fm_patch_t *patch = fm_patch_get(id);
+        if (!CHECK(patch != NULL, "patch %d missing", id)) continue;
+        CHECK(patch->name && patch->ratio > 0 && patch->depth > 0, "patch %d: empty name, ratio or depth", id);
+        CHECK(patch->index_env.sustain_level <= 32767, "%s: index sustain past the peak", patch->name);
+    }
+
+    CHECK(fm_patch_get(FM_PATCH_COUNT) == NULL, "patch past the table");
+    CHECK(fm_patch_get((fm_patch_id_t)255) == NULL, "patch 255 past the table");
+    CHECK(synth_engine_set_fm_patch(CHANNEL, FM_PATCH_COUNT) == ESP_ERR_INVALID_ARG, "patch past the table set");
+    CHECK(synth_engine_set_fm_patch(SYNTH_CHANNEL_COUNT, 0) == ESP_ERR_INVALID_ARG, "patch set past the channels");
+}
+
+/**
+ * @brief Programs after the waveforms play the patches, and wrap around
+ */
+static void check_programs(void)
+{
+    static int16_t by_patch[SYNTH_SAMPLING_RATE_HZ / 4];
+    static int16_t by_program[SYNTH_SAMPLING_RATE_HZ / 4];
+    const uint8_t cycle = WAVETABLE_SHAPE_COUNT + FM_PATCH_COUNT + 1;
+
+    for (fm_patch_id_t id = 0; id < FM_PATCH_COUNT; ++id)
+    {
+        synth_engine_init();
+        synth_engine_set_fm_patch(CHANNEL, id);
+        synth_engine_note_on(CODE, CHANNEL, 100);
+        host_check_render(by_patch, sizeof(by_patch) / sizeof(by_patch[0]));
+
+        for (uint8_t program = WAVETABLE_SHAPE_COUNT + id; program < 128; program += cycle)
+        {
+            synth_cmd_t cmd = {SYNTH_CMD_PROGRAM_CHANGE, CHANNEL, program, 0};
+            synth_engine_init();
+            synth_engine_apply(&cmd);
+            synth_engine_note_on(CODE, CHANNEL, 100);
+            host_check_render(by_program, sizeof(by_program) / sizeof(by_program[0]));
+            CHECK(memcmp(by_patch, by_program, sizeof(by_patch)) == 0, "program %d does not play %s", program,
+                fm_patch_get(id)->name);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    check_patches();
+    for (fm_patch_id_t id = 0; id < FM_PATCH_COUNT; ++id) check_sustain(id);
+    for (fm_patch_id_t id = 0; id < FM_PATCH_COUNT; ++id) check_decay(id);
+    check_programs();
+
+    return host_check_report("fm_check");
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file host_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "host_check.h"
+#include "dsp/synth_engine.h"
+#include "hal/sample_bank.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <time.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define RENDER_CHUNK 256
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static unsigned long checked = 0;
+static unsigned long failed = 0;
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+bool host_check(bool ok, const char *file, int line, const char *fmt, ...)
+{
+    checked++;
+    if (ok) return true;
+
+    failed++;
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "%s:%d: ", file, line);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+
+    return false;
+}
+
+int host_check_report(const char *name)
+{
+    printf("%s: %lu checks, %lu failed\n", name, checked, failed);
+
+    return failed ? 1 : 0;
+}
+
+void host_check_render(int16_t *out, size_t len)
+{
+    uint16_t buf[RENDER_CHUNK];
+
+    for (size_t pos = 0; pos < len; pos += RENDER_CHUNK)
+    {
+        size_t n = len - pos < RENDER_CHUNK ? len - pos : RENDER_CHUNK;
+        synth_engine_render(buf, n);
+        for (size_t i = 0; i < n; ++i) out[pos + i] = (int16_t)((int32_t)buf[i] - SYNTH_OUT_SILENCE);
+    }
+}
+
+size_t host_check_render_until_idle(size_t max)
+{
+    uint16_t buf[SYNTH_CONTROL_PERIOD];
+    size_t done = 0;
+
+    while (synth_engine_active_voices() > 0 && done < max)
+    {
+        synth_engine_render(buf, SYNTH_CONTROL_PERIOD);
+        done += SYNTH_CONTROL_PERIOD;
+    }
+
+    return done;
+}
+
+double host_check_amplitude(const int16_t *x, size_t len, double freq_hz, double rate_hz)
+{
+    double re = 0, im = 0, weight = 0;
+
+    for (size_t n = 0; n < len; ++n)
+    {
+        double w = 0.5 - 0.5 * cos(2 * M_PI * n / len);
+        double a = 2 * M_PI * freq_hz * n / rate_hz;
+        re += w * x[n] * cos(a);
+        im -= w * x[n] * sin(a);
+        weight += w;
+    }
+
+    return 2 * sqrt(re * re + im * im) / weight;
+}
+
+double host_check_pitch_hz(const int16_t *x, size_t len, double rate_hz)
+{
+    double first = -1, last = -1;
+    unsigned long crossings = 0;
+
+    for (size_t n = 1; n < len; ++n)
+    {
+        if (x[n - 1] >= 0 || x[n] < 0) continue;
+
+        // Where the line between the two samples crosses zero
+        double t = n - 1 + (double)-x[n - 1] / (x[n] - x[n - 1]);
+        if (first < 0) first = t;
+        last = t;
+        crossings++;
+    }
+
+    return crossings > 1 ? (crossings - 1) * rate_hz / (last - first) : 0;
+}
+
+double host_check_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief No sample partition on the host, sampler programs stay silent
+ */
+esp_err_t sample_bank_init(void) { return ESP_ERR_NOT_FOUND; }
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file host_check.h
+ * @brief Shared helpers of the host checks
+ *
+ * Each check is its own program: CHECK() counts and prints failures and the
+ * program exits with host_check_report(), which is what ctest looks at. The
+ * engine helpers drive the firmware engine directly, without the tasks.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef HOST_CHECK_H
+#define HOST_CHECK_H
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+// True if the condition held, the message is printed otherwise
+#define CHECK(cond, ...) host_check((cond), __FILE__, __LINE__, __VA_ARGS__)
+
+// -----------------------------------------------------------------------------
+// Inline Function Definitions
+// -----------------------------------------------------------------------------
+static inline double host_check_cents(double hz, double ref_hz) { return 1200.0 * log2(hz / ref_hz); }
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+bool host_check(bool ok, const char *file, int line, const char *fmt, ...) __attribute__((format(printf, 4, 5)));
+// Prints the totals, returns the exit code of the check
+int host_check_report(const char *name);
+
+// Engine output for len samples, centered on 0
+void host_check_render(int16_t *out, size_t len);
+// Renders until no voice sounds, at most max samples, returns the count
+size_t host_check_render_until_idle(size_t max);
+// Amplitude of one frequency under a Hann window, in output units
+double host_check_amplitude(const int16_t *x, size_t len, double freq_hz, double rate_hz);
+// Mean frequency between the first and last rising zero crossing, 0 if
+// there are fewer than two
+double host_check_pitch_hz(const int16_t *x, size_t len, double rate_hz);
+// Monotonic host time in ns, for the costs the checks print. Host figures
+// only compare code paths with each other, they say nothing of the board.
+double host_check_now_ns(void);
+
+#endif /* !HOST_CHECK_H */
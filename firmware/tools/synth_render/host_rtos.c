@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file host_rtos.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "host_rtos.h"
+#include "driver/gptimer.h"
+#include "esp_cpu.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define MAX_TASKS 8
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+struct host_task
+{
+    pthread_t thread;
+    TaskFunction_t fn;
+    void *param;
+    uint32_t notify;
+    const uint32_t *wait_on; // Count the task is blocked on, NULL while it runs
+};
+
+struct host_semaphore
+{
+    uint32_t count;
+};
+
+struct host_gptimer
+{
+    gptimer_alarm_cb_t on_alarm;
+    void *user_data;
+    uint64_t count;
+    uint64_t alarm_count;
+    bool running;
+};
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+// Every count below is only touched with the lock held
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t changed = PTHREAD_COND_INITIALIZER;
+
+static struct host_task tasks[MAX_TASKS];
+static int task_count = 0;
+static __thread struct host_task *current = NULL;
+
+static struct host_gptimer timer;
+
+// Cycle count reads come in pairs around each rendered block
+static __thread uint64_t span_start_ns = 0;
+static __thread bool span_open = false;
+static uint64_t spans_ns = 0;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void *task_entry(void *arg)
+{
+    current = arg;
+    current->fn(current->param);
+    return NULL;
+}
+
+/**
+ * @brief Block the calling task until a count is non zero, then take from it
+ */
+static uint32_t take(uint32_t *count, bool clear)
+{
+    pthread_mutex_lock(&lock);
+
+    while (*count == 0)
+    {
+        current->wait_on = count;
+        pthread_cond_broadcast(&changed);
+        pthread_cond_wait(&changed, &lock);
+    }
+    current->wait_on = NULL;
+
+    uint32_t value = *count;
+    *count = clear ? 0 : value - 1;
+
+    pthread_mutex_unlock(&lock);
+
+    return value;
+}
+
+static void give(uint32_t *count, bool binary)
+{
+    pthread_mutex_lock(&lock);
+    *count = binary ? 1 : *count + 1;
+    pthread_cond_broadcast(&changed);
+    pthread_mutex_unlock(&lock);
+}
+
+static bool all_idle(void)
+{
+    for (int i = 0; i < task_count; ++i)
+        if (!tasks[i].wait_on || *tasks[i].wait_on != 0) return false;
+
+    return true;
+}
+
+static uint64_t thread_cpu_ns(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *param,
+    UBaseType_t prio, TaskHandle_t *handle, BaseType_t core)
+{
+    pthread_mutex_lock(&lock);
+
+    if (task_count == MAX_TASKS)
+    {
+        pthread_mutex_unlock(&lock);
+        return pdFAIL;
+    }
+
+    struct host_task *task = &tasks[task_count++];
+    *task = (struct host_task){.fn = fn, .param = param};
+    if (handle) *handle = task;
+
+    pthread_create(&task->thread, NULL, task_entry, task);
+    pthread_detach(task->thread);
+
+    pthread_mutex_unlock(&lock);
+
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) { return take(&current->notify, clear); }
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken)
+{
+    give(&task->notify, false);
+    *woken = pdTRUE;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) { return calloc(1, sizeof(struct host_semaphore)); }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    take(&sem->count, false);
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    give(&sem->count, true);
+    return pdTRUE;
+}
+
+uint32_t esp_cpu_get_cycle_count(void)
+{
+    uint64_t ns = thread_cpu_ns(CLOCK_THREAD_CPUTIME_ID);
+
+    if (span_open) __atomic_fetch_add(&spans_ns, ns - span_start_ns, __ATOMIC_RELAXED);
+    span_start_ns = ns;
+    span_open = !span_open;
+
+    return (uint32_t)(ns * CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ / 1000);
+}
+
+esp_err_t gptimer_new_timer(const gptimer_config_t *config, gptimer_handle_t *ret_timer)
+{
+    *ret_timer = &timer;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_register_event_callbacks(gptimer_handle_t timer, const gptimer_event_callbacks_t *cbs, void *user_data)
+{
+    timer->on_alarm = cbs->on_alarm;
+    timer->user_data = user_data;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_enable(gptimer_handle_t timer) { return ESP_OK; }
+
+esp_err_t gptimer_set_alarm_action(gptimer_handle_t timer, const gptimer_alarm_config_t *config)
+{
+    timer->alarm_count = config->alarm_count;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_start(gptimer_handle_t timer)
+{
+    timer->running = true;
+    return ESP_OK;
+}
+
+esp_err_t gptimer_stop(gptimer_handle_t timer)
+{
+    timer->running = false;
+    return ESP_OK;
+}
+
+/**
+ * @brief Wait until every task is blocked on a count that is still zero
+ *
+ * Nothing can then happen until the driver gives something.
+ */
+void host_rtos_wait_idle(void)
+{
+    pthread_mutex_lock(&lock);
+    while (!all_idle()) pthread_cond_wait(&changed, &lock);
+    pthread_mutex_unlock(&lock);
+}
+
+/**
+ * @brief One alarm of the sampling timer, the ISR runs on the calling thread
+ */
+void host_timer_fire(void)
+{
+    if (!timer.running || !timer.on_alarm) return;
+
+    timer.count += timer.alarm_count;
+    gptimer_alarm_event_data_t edata = {.count_value = timer.count, .alarm_value = timer.alarm_count};
+    timer.on_alarm(&timer, &edata, timer.user_data);
+}
+
+uint64_t host_rtos_cpu_ns(void)
+{
+    uint64_t total = 0;
+
+    pthread_mutex_lock(&lock);
+    for (int i = 0; i < task_count; ++i)
+    {
+        clockid_t clock;
+        if (pthread_getcpuclockid(tasks[i].thread, &clock) == 0) total += thread_cpu_ns(clock);
+    }
+    pthread_mutex_unlock(&lock);
+
+    return total;
+}
+
+uint64_t host_rtos_measured_ns(void) { return __atomic_load_n(&spans_ns, __ATOMIC_RELAXED); }
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file host_rtos.h
+ * @brief FreeRTOS tasks and the sampling timer on pthreads, in lock step
+ *
+ * Tasks are real threads but the driver only ever moves on once all of them
+ * are blocked, so a render is deterministic and does not depend on the host
+ * load: the timer alarm fires when host_timer_fire() is called, not on a
+ * clock.
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#ifndef HOST_RTOS_H
+#define HOST_RTOS_H
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Function Declarations
+// -----------------------------------------------------------------------------
+void host_rtos_wait_idle(void);
+void host_timer_fire(void);
+// CPU time used by all tasks so far
+uint64_t host_rtos_cpu_ns(void);
+// CPU time between the pairs of cycle count reads, the blocks timed by synth.c
+uint64_t host_rtos_measured_ns(void);
+
+#endif /* !HOST_RTOS_H */
@@ -0,0 +1,751 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file main.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "core/duty_governor.h"
+#include "core/smf.h"
+#include "dsp/sampler.h"
+#include "hal/pwm.h"
+#include "hal/sample_bank.h"
+#include "hal/synth.h"
+#include "host_rtos.h"
+#include "sdkconfig.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: synth_render [-m audio|pulses] [-o out] [-d duty.bin] [-p power_pct] [-s samples.bin] [-t tail_ms]\n"    \
+    "                    input\n"                                                                                     \
+    "\n"                                                                                                               \
+    "input is a standard MIDI file, played like the song player does, or an\n"                                        \
+    "event script played like the keyboard (through the arpeggiator):\n"                                               \
+    "\n"                                                                                                               \
+    "    # time_ms event args, channels 1 to 16\n"                                                                     \
+    "    0    prog 1 8\n"                                                                                              \
+    "    0    on 1 60 100\n"                                                                                           \
+    "    500  off 1 60\n"                                                                                              \
+    "    500  cc 1 7 90\n"                                                                                             \
+    "    600  bend 1 -4096\n"                                                                                          \
+    "    1000 start | continue | stop | clock\n"                                                                       \
+    "    1000 clocks 120 96        (96 MIDI clocks at 120 BPM)\n"                                                   \
+    "\n"                                                                                                               \
+    "-m pulses plays the notes as pulse trains instead and writes \"start_us width_us\"\n"                            \
+    "lines, checking every pulse against the safety constraints.\n"                                                  \
+    "\n"                                                                                                               \
+    "Either output goes through the duty governor of the PWM, and the on-time it lets\n"                              \
+    "out is checked against the budgets over every 10 ms and 1 s window.\n"
+
+// Events are queued this far ahead of the output, as the song player does
+#define LOOKAHEAD_SAMPLES (SYNTH_SAMPLING_RATE_HZ / 20)
+#define DEFAULT_TAIL_MS 1000
+#define DEFAULT_POWER_PCT 50
+#define VIOLATIONS_SHOWN 10
+#define MOD_SAMPLE_LEN DUTY_GOVERNOR_SAMPLE_LEN(SYNTH_SAMPLING_RATE_HZ)
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t time; // Samples from the start of the render
+    uint32_t order;
+    synth_cmd_t cmd;
+} script_event_t;
+
+typedef struct
+{
+    int16_t *samples;
+    uint8_t *duty;
+    size_t len;
+    size_t cap;
+} recording_t;
+
+typedef struct
+{
+    pulse_t *pulses;
+    size_t len;
+    size_t cap;
+    uint32_t violations;
+    uint16_t width_max;
+    uint32_t gap_min;
+} pulse_recording_t;
+
+// On-time out of the governor, in governor units from the start of the render
+typedef struct
+{
+    uint64_t start;
+    uint32_t width;
+} span_t;
+
+typedef struct
+{
+    span_t *spans;
+    size_t len;
+    size_t cap;
+} span_recording_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const char *sample_bank_path = NULL;
+static uint32_t power_pct = DEFAULT_POWER_PCT;
+static recording_t rec = {0};
+static pulse_recording_t pulse_rec = {.gap_min = UINT32_MAX};
+static uint32_t ticks = 0;
+
+static duty_governor_t governor;
+static span_recording_t on_rec = {0};
+static uint64_t mod_clock = 0;
+
+static script_event_t *script = NULL;
+static size_t script_len = 0;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static uint8_t *read_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    uint8_t *data = malloc(*size ? *size : 1);
+    if (data && fread(data, 1, *size, f) != *size)
+    {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+
+    return data;
+}
+
+/**
+ * @brief Sampling timer output, what the firmware hands to the PWM
+ */
+static void record_on_time(uint64_t start, uint32_t width)
+{
+    if (on_rec.len == on_rec.cap)
+    {
+        on_rec.cap = on_rec.cap ? 2 * on_rec.cap : 1024;
+        on_rec.spans = realloc(on_rec.spans, on_rec.cap * sizeof(*on_rec.spans));
+        if (!on_rec.spans)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+
+    on_rec.spans[on_rec.len++] = (span_t){.start = start, .width = width};
+}
+
+static void on_sampling_cb(uint16_t value)
+{
+    if (rec.len == rec.cap)
+    {
+        rec.cap = rec.cap ? 2 * rec.cap : SYNTH_SAMPLING_RATE_HZ;
+        rec.samples = realloc(rec.samples, rec.cap * sizeof(*rec.samples));
+        rec.duty = realloc(rec.duty, rec.cap);
+        if (!rec.samples || !rec.duty)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+
+    rec.samples[rec.len] = (int16_t)((int32_t)value - 32768);
+
+    // As pwm_modulation_update() governs it, charged the same rounded up way
+    uint8_t duty = pwm_modulation_duty(value, SYNTH_OUT_MAX, power_pct, 100);
+    duty = duty_governor_duty(&governor, (uint32_t)mod_clock, duty, MOD_SAMPLE_LEN);
+    uint32_t on = (duty * MOD_SAMPLE_LEN + 255) / 256;
+    if (on) record_on_time(mod_clock, on);
+    mod_clock += MOD_SAMPLE_LEN;
+
+    rec.duty[rec.len] = duty;
+    rec.len++;
+}
+
+/**
+ * @brief Pulse out of the synth, what the firmware queues to the RMT
+ *
+ * Governed as the RMT translator does, on the synth clock since the stream
+ * keeps its spacing, then checked here on its own rather than trusting the
+ * merger.
+ */
+static void on_pulse_cb(const pulse_t *pulse_in)
+{
+    pulse_t governed = *pulse_in;
+    const pulse_t *pulse = &governed;
+
+    if (governed.width > CONFIG_INTERRUPTER_TON_MAX) governed.width = CONFIG_INTERRUPTER_TON_MAX;
+    governed.width = duty_governor_pulse(&governor, governed.start, governed.width, CONFIG_INTERRUPTER_TON_MIN);
+    if (governed.width == 0) return;
+
+    if (pulse_rec.len == pulse_rec.cap)
+    {
+        pulse_rec.cap = pulse_rec.cap ? 2 * pulse_rec.cap : 1024;
+        pulse_rec.pulses = realloc(pulse_rec.pulses, pulse_rec.cap * sizeof(*pulse_rec.pulses));
+        if (!pulse_rec.pulses)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+
+    const char *violation = NULL;
+    if (pulse->width > CONFIG_INTERRUPTER_TON_MAX) violation = "longer than TON_MAX";
+    if (pulse->width < CONFIG_INTERRUPTER_TON_MIN) violation = "shorter than TON_MIN";
+
+    if (pulse_rec.len > 0)
+    {
+        const pulse_t *prev = &pulse_rec.pulses[pulse_rec.len - 1];
+        int32_t gap = (int32_t)(pulse->start - (prev->start + prev->width));
+        if (gap < CONFIG_INTERRUPTER_TOFF_MIN) violation = gap < 0 ? "out of order" : "closer than TOFF_MIN";
+        if (gap >= 0 && (uint32_t)gap < pulse_rec.gap_min) pulse_rec.gap_min = gap;
+    }
+
+    if (violation && pulse_rec.violations++ < VIOLATIONS_SHOWN)
+        fprintf(stderr, "Pulse %lu at %lu us, %u us: %s\n", (unsigned long)pulse_rec.len, (unsigned long)pulse->start,
+            (unsigned)pulse->width, violation);
+
+    if (pulse->width > pulse_rec.width_max) pulse_rec.width_max = pulse->width;
+    pulse_rec.pulses[pulse_rec.len++] = *pulse;
+    record_on_time((uint64_t)pulse->start * DUTY_GOVERNOR_UNITS_PER_US, pulse->width * DUTY_GOVERNOR_UNITS_PER_US);
+}
+
+/**
+ * @brief On-time of the recording within [from, from + len)
+ *
+ * Spans are in time order and do not overlap.
+ */
+static uint64_t on_time_in(const uint64_t *prefix, uint64_t from, uint64_t len)
+{
+    const span_t *spans = on_rec.spans;
+    uint64_t to = from + len;
+
+    // First span ending after from, first span starting at or after to
+    size_t lo = 0, hi = on_rec.len;
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        if (spans[mid].start + spans[mid].width <= from)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    size_t first = lo;
+    hi = on_rec.len;
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        if (spans[mid].start < to)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    size_t end = lo;
+    if (first >= end) return 0;
+
+    uint64_t on = prefix[end] - prefix[first];
+    if (spans[first].start < from) on -= from - spans[first].start;
+    if (spans[end - 1].start + spans[end - 1].width > to) on -= spans[end - 1].start + spans[end - 1].width - to;
+
+    return on;
+}
+
+/**
+ * @brief Largest on-time over any window of the given length, exactly
+ *
+ * The on-time of a sliding window only changes slope where one of its
+ * edges meets the edge of a span, so windows ending at each span end and
+ * starting at each span start are enough.
+ */
+static uint64_t busiest_window(const uint64_t *prefix, uint64_t len)
+{
+    uint64_t busiest = 0;
+
+    for (size_t i = 0; i < on_rec.len; ++i)
+    {
+        uint64_t end = on_rec.spans[i].start + on_rec.spans[i].width;
+        uint64_t a = on_time_in(prefix, end > len ? end - len : 0, end > len ? len : end);
+        uint64_t b = on_time_in(prefix, on_rec.spans[i].start, len);
+        if (a > busiest) busiest = a;
+        if (b > busiest) busiest = b;
+    }
+
+    return busiest;
+}
+
+/**
+ * @brief Check the governed output against both budgets, false if over
+ */
+static bool check_duty(void)
+{
+    static const struct
+    {
+        const char *name;
+        uint64_t len_us;
+        uint32_t pct;
+    } windows[] = {{"10 ms", DUTY_GOVERNOR_SHORT_US, DUTY_GOVERNOR_SHORT_PCT},
+        {"1 s", DUTY_GOVERNOR_LONG_US, DUTY_GOVERNOR_LONG_PCT}};
+
+    uint64_t *prefix = malloc((on_rec.len + 1) * sizeof(*prefix));
+    if (!prefix)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    prefix[0] = 0;
+    for (size_t i = 0; i < on_rec.len; ++i) prefix[i + 1] = prefix[i] + on_rec.spans[i].width;
+
+    bool ok = true;
+    printf("duty:");
+    for (size_t w = 0; w < sizeof(windows) / sizeof(windows[0]); ++w)
+    {
+        uint64_t len = windows[w].len_us * DUTY_GOVERNOR_UNITS_PER_US;
+        uint64_t busiest = busiest_window(prefix, len);
+        uint64_t budget = windows[w].len_us / 100 * windows[w].pct * DUTY_GOVERNOR_UNITS_PER_US;
+        printf("%s busiest %s %.2f%% (max %lu%%)", w ? "," : "", windows[w].name, 100.0 * busiest / len,
+            (unsigned long)windows[w].pct);
+        if (busiest > budget) ok = false;
+    }
+    printf(", %lu scaled, %lu dropped%s\n", (unsigned long)governor.scaled, (unsigned long)governor.dropped,
+        ok ? "" : ", OVER BUDGET");
+
+    free(prefix);
+
+    return ok;
+}
+
+static void put_le(uint8_t *p, uint32_t value, int bytes)
+{
+    for (int i = 0; i < bytes; ++i) p[i] = value >> (8 * i);
+}
+
+static int write_wav(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) return -1;
+
+    uint32_t data_size = rec.len * sizeof(int16_t);
+    uint8_t header[44];
+    memcpy(header, "RIFF", 4);
+    put_le(header + 4, 36 + data_size, 4);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    put_le(header + 16, 16, 4);
+    put_le(header + 20, 1, 2); // PCM
+    put_le(header + 22, 1, 2); // Mono
+    put_le(header + 24, SYNTH_SAMPLING_RATE_HZ, 4);
+    put_le(header + 28, SYNTH_SAMPLING_RATE_HZ * 2, 4);
+    put_le(header + 32, 2, 2);
+    put_le(header + 34, 16, 2);
+    memcpy(header + 36, "data", 4);
+    put_le(header + 40, data_size, 4);
+
+    fwrite(header, 1, sizeof(header), f);
+    for (size_t i = 0; i < rec.len; ++i)
+    {
+        uint8_t le[2];
+        put_le(le, (uint16_t)rec.samples[i], 2);
+        fwrite(le, 1, 2, f);
+    }
+
+    return fclose(f);
+}
+
+static int write_pulses(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+
+    for (size_t i = 0; i < pulse_rec.len; ++i)
+        fprintf(f, "%lu %u\n", (unsigned long)pulse_rec.pulses[i].start, (unsigned)pulse_rec.pulses[i].width);
+
+    return fclose(f);
+}
+
+static int write_duty(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) return -1;
+
+    fwrite(rec.duty, 1, rec.len, f);
+
+    return fclose(f);
+}
+
+static bool smf_to_cmd(const smf_event_t *event, synth_cmd_t *cmd)
+{
+    cmd->channel = event->status & 0x0F;
+    cmd->data1 = event->data1;
+    cmd->data2 = event->data2;
+
+    switch (event->status >> 4)
+    {
+    case 0x8:
+        cmd->type = SYNTH_CMD_NOTE_OFF;
+        return true;
+    case 0x9:
+        cmd->type = event->data2 ? SYNTH_CMD_NOTE_ON : SYNTH_CMD_NOTE_OFF;
+        return true;
+    case 0xB:
+        cmd->type = SYNTH_CMD_CONTROL_CHANGE;
+        return true;
+    case 0xC:
+        cmd->type = SYNTH_CMD_PROGRAM_CHANGE;
+        return true;
+    case 0xE:
+        cmd->type = SYNTH_CMD_PITCH_BEND;
+        return true;
+    default:
+        return false;
+    }
+}
+
+static uint32_t ms_to_samples(double ms) { return (uint32_t)(ms * SYNTH_SAMPLING_RATE_HZ / 1000 + 0.5); }
+
+static void script_add(uint32_t time, synth_cmd_type_t type, uint8_t channel, uint8_t data1, uint8_t data2)
+{
+    static size_t cap = 0;
+
+    if (script_len == cap)
+    {
+        cap = cap ? 2 * cap : 256;
+        script = realloc(script, cap * sizeof(*script));
+        if (!script)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+
+    script[script_len] = (script_event_t){.time = time,
+        .order = script_len,
+        .cmd = {.type = type, .channel = channel, .data1 = data1, .data2 = data2}};
+    script_len++;
+}
+
+static int script_compare(const void *a, const void *b)
+{
+    const script_event_t *ea = a, *eb = b;
+
+    if (ea->time != eb->time) return ea->time < eb->time ? -1 : 1;
+    return ea->order < eb->order ? -1 : 1;
+}
+
+static int parse_script(char *text)
+{
+    int line_no = 0;
+
+    for (char *line = strtok(text, "\n"); line; line = strtok(NULL, "\n"))
+    {
+        line_no++;
+        char *comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+
+        double ms;
+        char verb[16];
+        int a = 0, b = 0, c = 0;
+        int n = sscanf(line, "%lf %15s %d %d %d", &ms, verb, &a, &b, &c);
+        if (n <= 0) continue; // Blank line
+
+        uint32_t time = ms_to_samples(ms);
+        uint8_t ch = (uint8_t)(a - 1);
+        bool channel_ok = a >= 1 && a <= SYNTH_CHANNEL_COUNT;
+
+        if (n == 5 && !strcmp(verb, "on") && channel_ok)
+            script_add(time, c ? SYNTH_CMD_NOTE_ON : SYNTH_CMD_NOTE_OFF, ch, b & 0x7F, c & 0x7F);
+        else if (n == 4 && !strcmp(verb, "off") && channel_ok)
+            script_add(time, SYNTH_CMD_NOTE_OFF, ch, b & 0x7F, 0);
+        else if (n == 5 && !strcmp(verb, "cc") && channel_ok)
+            script_add(time, SYNTH_CMD_CONTROL_CHANGE, ch, b & 0x7F, c & 0x7F);
+        else if (n == 4 && !strcmp(verb, "prog") && channel_ok)
+            script_add(time, SYNTH_CMD_PROGRAM_CHANGE, ch, b & 0x7F, 0);
+        else if (n == 4 && !strcmp(verb, "bend") && channel_ok && b >= -8192 && b <= 8191)
+            script_add(time, SYNTH_CMD_PITCH_BEND, ch, (b + 8192) & 0x7F, (b + 8192) >> 7);
+        else if (n == 2 && !strcmp(verb, "clock"))
+            script_add(time, SYNTH_CMD_REALTIME, 0, 0xF8, 0);
+        else if (n == 2 && !strcmp(verb, "start"))
+            script_add(time, SYNTH_CMD_REALTIME, 0, 0xFA, 0);
+        else if (n == 2 && !strcmp(verb, "continue"))
+            script_add(time, SYNTH_CMD_REALTIME, 0, 0xFB, 0);
+        else if (n == 2 && !strcmp(verb, "stop"))
+            script_add(time, SYNTH_CMD_REALTIME, 0, 0xFC, 0);
+        else if (n == 4 && !strcmp(verb, "clocks") && a > 0 && b >= 0)
+        {
+            // 24 clocks per beat
+            for (int i = 0; i < b; ++i) script_add(ms_to_samples(ms + i * 2500.0 / a), SYNTH_CMD_REALTIME, 0, 0xF8, 0);
+        }
+        else
+        {
+            fprintf(stderr, "Line %d: cannot parse \"%s\"\n", line_no, line);
+            return -1;
+        }
+    }
+
+    qsort(script, script_len, sizeof(*script), script_compare);
+
+    return 0;
+}
+
+/**
+ * @brief Hand a script event to the synth as the MIDI client would
+ */
+static esp_err_t play_live(const synth_cmd_t *cmd)
+{
+    synth_note_t note = {.octave = cmd->data1 / 12 - 2, .note = cmd->data1 % 12};
+
+    switch (cmd->type)
+    {
+    case SYNTH_CMD_NOTE_ON:
+        return synth_play_note(note, cmd->channel, cmd->data2);
+    case SYNTH_CMD_NOTE_OFF:
+        return synth_stop_note(note, cmd->channel);
+    case SYNTH_CMD_CONTROL_CHANGE:
+        return synth_control_change(cmd->channel, cmd->data1, cmd->data2);
+    case SYNTH_CMD_PROGRAM_CHANGE:
+        return synth_set_program(cmd->channel, cmd->data1);
+    case SYNTH_CMD_PITCH_BEND:
+        return synth_pitch_bend(cmd->channel, cmd->data1, cmd->data2);
+    case SYNTH_CMD_REALTIME:
+        return synth_realtime(cmd->data1);
+    default:
+        return ESP_ERR_INVALID_ARG;
+    }
+}
+
+/**
+ * @brief Move the output one sample on, with every task done with its work
+ */
+static void tick(void)
+{
+    ticks++;
+    host_timer_fire();
+    host_rtos_wait_idle();
+}
+
+static void render_smf(smf_t *smf, uint32_t tail)
+{
+    uint32_t start = synth_now();
+    smf_event_t event;
+    bool pending = smf_next(smf, &event);
+
+    while (pending)
+    {
+        uint32_t horizon = synth_now() + LOOKAHEAD_SAMPLES;
+
+        while (pending && (int32_t)(start + event.time - horizon) <= 0)
+        {
+            synth_cmd_t cmd;
+            if (smf_to_cmd(&event, &cmd) && synth_schedule(start + event.time, &cmd) != ESP_OK) break;
+            pending = smf_next(smf, &event);
+        }
+
+        tick();
+    }
+
+    uint32_t end = synth_now() + LOOKAHEAD_SAMPLES + tail;
+    while ((int32_t)(synth_now() - end) < 0) tick();
+}
+
+static void render_script(uint32_t tail)
+{
+    uint32_t start = synth_now();
+    size_t next = 0;
+
+    // Live events play a fixed latency after the call, so each one is sent
+    // when synth_now() reaches its time to land on it exactly
+    while (next < script_len)
+    {
+        while (next < script_len && (int32_t)(start + script[next].time - synth_now()) <= 0)
+        {
+            if (play_live(&script[next].cmd) != ESP_OK) break; // Full, retried next sample
+            next++;
+        }
+
+        tick();
+    }
+
+    uint32_t end = synth_now() + tail;
+    while ((int32_t)(synth_now() - end) < 0) tick();
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief Sample bank from the file given with -s, in place of the partition
+ */
+esp_err_t sample_bank_init(void)
+{
+    if (!sample_bank_path) return ESP_ERR_NOT_FOUND;
+
+    size_t size;
+    uint8_t *bank = read_file(sample_bank_path, &size);
+    if (!bank) return ESP_ERR_NOT_FOUND;
+
+    size = sampler_bank_size(bank, size);
+    if (size == 0) return ESP_ERR_NOT_FOUND;
+
+    return sampler_init(bank, size);
+}
+
+int main(int argc, char **argv)
+{
+    const char *out_path = NULL;
+    const char *duty_path = NULL;
+    bool pulses = false;
+    uint32_t tail_ms = DEFAULT_TAIL_MS;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "m:o:d:p:s:t:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'm':
+            pulses = !strcmp(optarg, "pulses");
+            if (!pulses && strcmp(optarg, "audio"))
+            {
+                fputs(USAGE, stderr);
+                return 2;
+            }
+            break;
+        case 'o':
+            out_path = optarg;
+            break;
+        case 'd':
+            duty_path = optarg;
+            break;
+        case 'p':
+            power_pct = strtoul(optarg, NULL, 10);
+            if (power_pct > 100) power_pct = 100;
+            break;
+        case 's':
+            sample_bank_path = optarg;
+            break;
+        case 't':
+            tail_ms = strtoul(optarg, NULL, 10);
+            break;
+        default:
+            fputs(USAGE, stderr);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if (optind != argc - 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    size_t size;
+    uint8_t *input = read_file(argv[optind], &size);
+    if (!input)
+    {
+        fprintf(stderr, "Cannot read %s\n", argv[optind]);
+        return 1;
+    }
+
+    static smf_t smf;
+    bool is_smf = size >= 4 && !memcmp(input, "MThd", 4);
+    if (is_smf && smf_open(&smf, input, size, SYNTH_SAMPLING_RATE_HZ) != ESP_OK)
+    {
+        fprintf(stderr, "%s is not a playable MIDI file\n", argv[optind]);
+        return 1;
+    }
+    if (!is_smf)
+    {
+        char *text = realloc(input, size + 1);
+        text[size] = '\0';
+        if (parse_script(text) != 0) return 1;
+    }
+
+    if (synth_init() != ESP_OK) return 1;
+    duty_governor_init(&governor, 0);
+    if (pulses)
+    {
+        // The power knob as the firmware maps it
+        synth_set_pulse_width(CONFIG_INTERRUPTER_TON_MAX * power_pct / 100);
+        synth_set_on_pulse_cb(on_pulse_cb);
+        synth_set_output(SYNTH_OUTPUT_PULSES);
+    }
+    else
+    {
+        synth_set_on_sampling_cb(on_sampling_cb);
+    }
+    host_rtos_wait_idle();
+    synth_enable();
+
+    struct timespec wall_start, wall_end;
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+
+    uint32_t tail = (uint32_t)((uint64_t)tail_ms * SYNTH_SAMPLING_RATE_HZ / 1000);
+    if (is_smf)
+        render_smf(&smf, tail);
+    else
+        render_script(tail);
+
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+
+    int written = pulses ? write_pulses(out_path ? out_path : "out.txt") : write_wav(out_path ? out_path : "out.wav");
+    if (written != 0 || (duty_path && !pulses && write_duty(duty_path) != 0))
+    {
+        fprintf(stderr, "Cannot write the output\n");
+        return 1;
+    }
+
+    // The blocks alone, the lock step with the driver thread does not exist
+    // on the target. Host time only, the target cycles are what
+    // synth_log_render_load() reports on the board.
+    double seconds = (double)ticks / SYNTH_SAMPLING_RATE_HZ;
+    double render_ms = host_rtos_measured_ns() / 1e6;
+    double tasks_ms = host_rtos_cpu_ns() / 1e6;
+    double wall = (wall_end.tv_sec - wall_start.tv_sec) + (wall_end.tv_nsec - wall_start.tv_nsec) / 1e9;
+    printf("%.2f s of audio at %d Hz, %lu samples\n", seconds, SYNTH_SAMPLING_RATE_HZ, (unsigned long)ticks);
+    printf("render: %.3f ms of host CPU per second of audio, %.1f ns per sample (host time)\n", render_ms / seconds,
+        ticks ? render_ms * 1e6 / ticks : 0);
+    printf("tasks: %.3f ms of host CPU per second of audio, wall time %.2f s\n", tasks_ms / seconds, wall);
+    synth_log_render_load();
+    bool duty_ok = check_duty();
+
+    if (!pulses) return duty_ok ? 0 : 1;
+
+    // Cost of the blocks, events included, spread over the pulses out
+    pulse_train_stats_t stats;
+    pulse_train_get_stats(&stats);
+    double ns_per_pulse = pulse_rec.len ? host_rtos_measured_ns() / pulse_rec.len : 0;
+    printf("pulses: %lu (%.0f/s), %lu merged, %lu dropped, %lu notes stolen\n", (unsigned long)pulse_rec.len,
+        pulse_rec.len / seconds, (unsigned long)stats.merged, (unsigned long)stats.dropped,
+        (unsigned long)stats.steals);
+    printf("limits: longest %u us (max %d), shortest gap %lu us (min %d), %lu violations\n",
+        (unsigned)pulse_rec.width_max, CONFIG_INTERRUPTER_TON_MAX,
+        (unsigned long)(pulse_rec.len > 1 ? pulse_rec.gap_min : 0), CONFIG_INTERRUPTER_TOFF_MIN,
+        (unsigned long)pulse_rec.violations);
+    printf("scheduler: %.0f ns of host CPU per pulse (host time)\n", ns_per_pulse);
+
+    return pulse_rec.violations || !duty_ok ? 1 : 0;
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file mip_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/note_table.h"
+#include "dsp/synth_engine.h"
+#include "dsp/wavetable.h"
+#include "host_check.h"
+#include <math.h>
+#include <stdio.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: mip_check\n"                                                                                               \
+    "\n"                                                                                                               \
+    "Takes the spectrum of every band-limited table and checks that the one\n"                                        \
+    "picked for each note keeps its harmonics under Nyquist, and that the low\n"                                       \
+    "harmonics keep the shape of the waveform.\n"
+
+#define PHASE_ONE 4294967296.0
+#define HARMONICS (WAVETABLE_SIZE / 2)
+#define NYQUIST_HZ (SYNTH_SAMPLING_RATE_HZ / 2.0)
+
+#define AUDIBLE_DB -80.0     // Harmonics under it are rounding noise of the table
+#define SHAPE_RATIO_MAX 0.01 // Low harmonics against the Fourier series
+#define SHAPE_HARMONICS 8
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const char *shape_names[WAVETABLE_SHAPE_COUNT] = {"sine", "square", "saw", "pulse"};
+
+static double spectrum[HARMONICS];
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief Amplitude of each harmonic of one table period, full scale 1
+ */
+static void table_spectrum(const int16_t *table)
+{
+    for (int h = 1; h < HARMONICS; ++h)
+    {
+        double re = 0, im = 0;
+        for (int i = 0; i < WAVETABLE_SIZE; ++i)
+        {
+            double w = 2 * M_PI * (double)((h * i) % WAVETABLE_SIZE) / WAVETABLE_SIZE;
+            re += table[i] * cos(w);
+            im -= table[i] * sin(w);
+        }
+        spectrum[h] = 2 * sqrt(re * re + im * im) / WAVETABLE_SIZE / WAVETABLE_MAX;
+    }
+}
+
+static int highest_harmonic(void)
+{
+    double floor = pow(10, AUDIBLE_DB / 20);
+
+    for (int h = HARMONICS - 1; h > 1; --h)
+        if (spectrum[h] > floor) return h;
+
+    return 1;
+}
+
+/**
+ * @brief Harmonic h against the fundamental, as the table builder weights it
+ */
+static double expected_ratio(wavetable_shape_t shape, int h, int harmonics)
+{
+    double gain[2];
+    int at[2] = {1, h};
+
+    for (int k = 0; k < 2; ++k)
+    {
+        int n = at[k];
+        switch (shape)
+        {
+        case WAVETABLE_SHAPE_SQUARE:
+            gain[k] = (n & 1) ? 1.0 / n : 0.0;
+            break;
+        case WAVETABLE_SHAPE_SAW:
+            gain[k] = 1.0 / n;
+            break;
+        default:
+            gain[k] = fabs(sin(M_PI * n * WAVETABLE_PULSE_DUTY_PCT / 100.0)) / n;
+            break;
+        }
+
+        // Lanczos sigma factor
+        double x = M_PI * n / (harmonics + 1);
+        gain[k] *= sin(x) / x;
+    }
+
+    return gain[1] / gain[0];
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    wavetable_init();
+
+    for (int shape = WAVETABLE_SHAPE_SINE; shape < WAVETABLE_SHAPE_COUNT; ++shape)
+    {
+        const int16_t *last = NULL;
+        int highest = 1;
+        double top_hz = 0;
+
+        for (int code = 0; code < NOTE_TABLE_SIZE; ++code)
+        {
+            const int16_t *table = wavetable_get(shape, code);
+            if (table != last)
+            {
+                table_spectrum(table);
+                highest = highest_harmonic();
+                last = table;
+
+                // Same count of harmonics as the builder gives this octave
+                int mip = code < WAVETABLE_MIP_FIRST_CODE ? 0 : (code - WAVETABLE_MIP_FIRST_CODE) / 12;
+                int top = WAVETABLE_MIP_FIRST_CODE + 12 * mip + 11;
+                int harmonics = table == wavetable_sine() ? 1 : (int)(NYQUIST_HZ / note_table_freq_hz(top));
+                if (harmonics > HARMONICS - 1) harmonics = HARMONICS - 1;
+
+                for (int h = 2; h <= SHAPE_HARMONICS && h <= harmonics; ++h)
+                {
+                    double ratio = spectrum[h] / spectrum[1];
+                    double expected = expected_ratio(shape, h, harmonics);
+                    CHECK(fabs(ratio - expected) <= SHAPE_RATIO_MAX,
+                        "%s from note %d: harmonic %d at %.4f, %.4f expected",
+                        shape_names[shape], code, h, ratio, expected);
+                }
+
+                printf("%-6s from note %3d: %3d harmonics\n", shape_names[shape], code, highest);
+            }
+
+            // What the oscillator plays, clamped below Nyquist at the top
+            double freq_hz = note_table_phase_inc(code) * (double)SYNTH_SAMPLING_RATE_HZ / PHASE_ONE;
+            CHECK(highest == 1 || highest * freq_hz < NYQUIST_HZ, "%s note %d: harmonic %d at %.1f Hz aliases",
+                shape_names[shape], code, highest, highest * freq_hz);
+            if (highest > 1 && highest * freq_hz > top_hz) top_hz = highest * freq_hz;
+        }
+
+        if (top_hz > 0) printf("%-6s harmonics up to %.1f Hz\n", shape_names[shape], top_hz);
+    }
+
+    return host_check_report("mip_check");
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file note_table_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/note_table.h"
+#include "dsp/synth_engine.h"
+#include "host_check.h"
+#include "sdkconfig.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: note_table_check\n"                                                                                        \
+    "\n"                                                                                                               \
+    "Compares the note tables with powf() for all 128 notes, and the fine\n"                                          \
+    "tuning steps over two octaves of bend around each note.\n"
+
+#define A4_CODE 69
+#define PHASE_ONE 4294967296.0
+#define PHASE_INC_MAX 0x7FFFFFFFUL
+
+#define NOTE_CENTS_MAX 0.01  // Rounding of the increment, and float against double
+#define FINE_CENTS_MAX 0.01  // The Q30 fine ratios on top
+#define FINE_RANGE (24 * NOTE_TABLE_FINE_STEPS)
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const char *names[12] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief Increment of a frequency, clamped to Nyquist as the table does
+ */
+static double expected_inc(float freq_hz)
+{
+    double inc = freq_hz / SYNTH_SAMPLING_RATE_HZ * PHASE_ONE;
+    return inc > PHASE_INC_MAX ? PHASE_INC_MAX : inc;
+}
+
+static double inc_cents(uint32_t inc, double expected) { return host_check_cents(inc, expected); }
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    note_table_init();
+
+    double note_worst = 0, fine_worst = 0;
+    int clamped = 0;
+
+    for (int code = 0; code < NOTE_TABLE_SIZE; ++code)
+    {
+        float freq_hz = CONFIG_INTERRUPTER_SYNTH_A4_HZ * powf(2.0f, (code - A4_CODE) / 12.0f);
+        double expected = expected_inc(freq_hz);
+        double cents = inc_cents(note_table_phase_inc(code), expected);
+        if (fabs(cents) > note_worst) note_worst = fabs(cents);
+        if (expected >= PHASE_INC_MAX) clamped++;
+
+        CHECK(fabs(cents) <= NOTE_CENTS_MAX, "note %d: increment %lu is %.4f cents off %.1f", code,
+            (unsigned long)note_table_phase_inc(code), cents, expected);
+        CHECK(fabsf(note_table_freq_hz(code) - freq_hz) <= freq_hz * 1e-6f, "note %d: %.4f Hz, %.4f expected", code,
+            note_table_freq_hz(code), freq_hz);
+        CHECK(note_table_phase_inc_fine(code, 0) == note_table_phase_inc(code), "note %d: fine 0 is not the note",
+            code);
+        CHECK(!strcmp(note_table_name(code), names[code % 12]) && note_table_octave(code) == code / 12 - 2,
+            "note %d named %s%d", code, note_table_name(code), note_table_octave(code));
+
+        // Every fine step within two octaves, as bend and vibrato reach them
+        for (int fine = -FINE_RANGE; fine <= FINE_RANGE; ++fine)
+        {
+            float steps = code + (float)fine / NOTE_TABLE_FINE_STEPS;
+            if (steps < 0 || steps > NOTE_TABLE_SIZE - 1) continue; // Clamped to the table ends
+
+            float fine_hz = CONFIG_INTERRUPTER_SYNTH_A4_HZ * powf(2.0f, (steps - A4_CODE) / 12.0f);
+            double fine_expected = expected_inc(fine_hz);
+            double fine_cents = inc_cents(note_table_phase_inc_fine(code, fine), fine_expected);
+            if (fabs(fine_cents) > fine_worst) fine_worst = fabs(fine_cents);
+
+            if (!CHECK(fabs(fine_cents) <= FINE_CENTS_MAX, "note %d fine %d: %.4f cents off", code, fine, fine_cents))
+                break;
+        }
+    }
+
+    // Past the table ends the pitch stops, it does not wrap
+    CHECK(note_table_phase_inc_fine(0, -FINE_RANGE) == note_table_phase_inc(0), "bend under note 0 wraps");
+    CHECK(note_table_phase_inc_fine(NOTE_TABLE_SIZE - 1, FINE_RANGE) == note_table_phase_inc(NOTE_TABLE_SIZE - 1),
+        "bend over note 127 wraps");
+
+    printf("notes off by %.5f cents at most, fine steps by %.5f, %d notes clamped to Nyquist\n", note_worst,
+        fine_worst, clamped);
+
+    return host_check_report("note_table_check");
+}
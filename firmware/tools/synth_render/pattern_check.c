@@ -0,0 +1,352 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file pattern_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "core/duty_governor.h"
+#include "core/pulse_pattern.h"
+#include "hal/pwm.h"
+#include "sdkconfig.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: pattern_check [-f prf_hz] [-w width_us] [-n burst_on_ms] [-F burst_off_ms]\n"                            \
+    "\n"                                                                                                               \
+    "Encodes the manual output as the PWM does, a burst off time of 0 for a\n"                                         \
+    "continuous train, then plays the symbols back and checks the period, width,\n"                                    \
+    "pulses per burst, burst cycle, symbol durations and on-time budgets, and lists\n"                               \
+    "the symbols. With no settings, every setting of a sweep is checked, then the\n"                                  \
+    "period of a continuous train at every PRF from 0.1 Hz to 20 kHz.\n"
+
+#define WINDOWS_US {DUTY_GOVERNOR_SHORT_US, DUTY_GOVERNOR_LONG_US}
+#define BUDGETS_PCT {DUTY_GOVERNOR_SHORT_PCT, DUTY_GOVERNOR_LONG_PCT}
+
+#define PERIOD_SWEEP_MAX_HZ 20000 // Every whole PRF up to it, as the knob sets them
+#define PERIOD_SWEEP_LOG_STEPS 4000 // Then fractional ones from the lowest PRF up
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const float sweep_prf_hz[] = {0.1f, 0.5f, 1, 3, 10, 30, 31, 33, 50, 100, 440, 1000, 2000, 5000, 10000, 20000};
+static const uint32_t sweep_width_us[] = {1, 10, 100, 250, 500};
+static const uint32_t sweep_on_ms[] = {1, 10, 100, 1000};
+static const uint32_t sweep_off_ms[] = {0, 1, 10, 100, 1000, 10000};
+static const uint32_t period_sweep_width_us[] = {1, CONFIG_INTERRUPTER_PD_DEFAULT, CONFIG_INTERRUPTER_TON_MAX};
+
+static pulse_symbol_t symbols[PWM_PATTERN_SYMBOLS_MAX];
+static double period_error_max = 0; // us
+static size_t symbols_used_max = 0;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief On-time of the looped pattern in the window starting at the given time
+ */
+static uint64_t on_time_in(const pulse_pattern_t *p, uint64_t from, uint64_t len)
+{
+    uint32_t pulses = p->burst_pulses ? p->burst_pulses : 1;
+    uint64_t on = 0;
+
+    for (uint64_t cycle = from / p->burst_cycle * p->burst_cycle; cycle < from + len; cycle += p->burst_cycle)
+    {
+        for (uint32_t i = 0; i < pulses; ++i)
+        {
+            uint64_t start = cycle + (uint64_t)i * p->period;
+            uint64_t end = start + p->width;
+            if (start < from) start = from;
+            if (end > from + len) end = from + len;
+            if (end > start) on += end - start;
+        }
+    }
+
+    return on;
+}
+
+/**
+ * @brief Whether the busiest window of each budget holds, windows start at a pulse
+ */
+static bool check_budgets(const pulse_pattern_t *p, char *why, size_t why_len)
+{
+    const uint32_t window_us[] = WINDOWS_US;
+    const uint32_t budget_pct[] = BUDGETS_PCT;
+    uint32_t pulses = p->burst_pulses ? p->burst_pulses : 1;
+
+    for (int w = 0; w < DUTY_GOVERNOR_WINDOW_COUNT; ++w)
+    {
+        uint64_t budget = (uint64_t)window_us[w] / 100 * budget_pct[w];
+
+        for (uint32_t i = 0; i < pulses; ++i)
+        {
+            uint64_t on = on_time_in(p, (uint64_t)i * p->period, window_us[w]);
+            if (on > budget)
+            {
+                snprintf(why, why_len, "%llu us on in %lu us from pulse %lu, budget %llu us", (unsigned long long)on,
+                    (unsigned long)window_us[w], (unsigned long)i, (unsigned long long)budget);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Play the symbols back and compare them with the pattern
+ */
+static bool check_symbols(const pulse_pattern_t *p, size_t len, char *why, size_t why_len)
+{
+    uint32_t pulses = p->burst_pulses ? p->burst_pulses : 1;
+    uint32_t cycle = p->burst_pulses ? p->burst_cycle : p->period;
+    uint64_t t = 0;
+    uint32_t seen = 0;
+    uint32_t low = 0;
+    uint32_t low_min = UINT32_MAX;
+
+    if (len != pulse_pattern_symbol_count(p) || len > PWM_PATTERN_SYMBOLS_MAX)
+    {
+        snprintf(why, why_len, "%zu symbols, %zu counted", len, pulse_pattern_symbol_count(p));
+        return false;
+    }
+
+    for (size_t i = 0; i < len; ++i)
+    {
+        const pulse_symbol_t *s = &symbols[i];
+        if (s->duration0 == 0 || s->duration1 == 0 || s->duration0 > PULSE_PATTERN_DURATION_MAX ||
+            s->duration1 > PULSE_PATTERN_DURATION_MAX)
+        {
+            snprintf(why, why_len, "symbol %zu lasts %u+%u ticks", i, s->duration0, s->duration1);
+            return false;
+        }
+
+        if (s->level0)
+        {
+            if (seen > 0 && low < low_min) low_min = low;
+            if (t != (uint64_t)seen * p->period || s->duration0 != p->width)
+            {
+                snprintf(why, why_len, "pulse %lu at %llu us for %u us", (unsigned long)seen, (unsigned long long)t,
+                    s->duration0);
+                return false;
+            }
+            seen++;
+            low = 0;
+        }
+        else
+        {
+            low += s->duration0;
+        }
+
+        low += s->duration1;
+        t += s->duration0 + s->duration1;
+    }
+
+    // The low time up to the first pulse of the next cycle
+    if (low < low_min) low_min = low;
+
+    if (seen != pulses || t != cycle)
+    {
+        snprintf(why, why_len, "%lu pulses in %llu us, %lu in %lu us expected", (unsigned long)seen,
+            (unsigned long long)t, (unsigned long)pulses, (unsigned long)cycle);
+        return false;
+    }
+    if (low_min < p->period - p->width)
+    {
+        snprintf(why, why_len, "pulses %lu us apart, under a period", (unsigned long)(low_min + p->width));
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Encode and check one setting, as pwm_manual_update() would
+ */
+static bool check(float prf_hz, uint32_t width_us, uint32_t on_ms, uint32_t off_ms, bool verbose)
+{
+    char why[160] = "";
+    pulse_pattern_t p;
+
+    if (pulse_pattern_make(&p, prf_hz, width_us, on_ms, off_ms) != ESP_OK)
+    {
+        fprintf(stderr, "prf=%.1f pd=%lu burst=%lu/%lu: rejected\n", prf_hz, (unsigned long)width_us,
+            (unsigned long)on_ms, (unsigned long)off_ms);
+        return false;
+    }
+
+    // Rounded to the nearest tick
+    double period_error = fabs(p.period - 1.e6 / prf_hz);
+    if (period_error > period_error_max) period_error_max = period_error;
+
+    uint32_t asked = p.burst_pulses;
+    bool ok = pulse_pattern_fit(&p, PWM_PATTERN_SYMBOLS_MAX);
+    uint32_t width_max = duty_governor_train_width(p.period, p.burst_pulses, p.burst_cycle);
+    if (p.width > width_max) p.width = width_max;
+
+    size_t len = 0;
+    ok = ok &&
+        (p.width == 0 ||
+            (pulse_pattern_fit(&p, PWM_PATTERN_SYMBOLS_MAX) &&
+                pulse_pattern_encode(&p, symbols, PWM_PATTERN_SYMBOLS_MAX, &len) == ESP_OK));
+    if (!ok) snprintf(why, sizeof(why), "cannot be encoded");
+    if (len > symbols_used_max) symbols_used_max = len;
+
+    if (ok && period_error > 0.5)
+    {
+        snprintf(why, sizeof(why), "period off by %.2f us", period_error);
+        ok = false;
+    }
+
+    // Every pulse started within the on time, the cycle no shorter than asked
+    if (ok && p.width > 0 && asked > 0)
+    {
+        uint32_t expected = (on_ms * 1000 + p.period - 1) / p.period;
+        if (expected == 0) expected = 1;
+        if (asked != expected || p.burst_cycle < (on_ms + off_ms) * 1000 || p.burst_cycle < asked * p.period)
+        {
+            snprintf(why, sizeof(why), "%lu pulses per cycle of %lu us", (unsigned long)asked,
+                (unsigned long)p.burst_cycle);
+            ok = false;
+        }
+    }
+
+    if (ok && p.width > 0) ok = check_symbols(&p, len, why, sizeof(why)) && check_budgets(&p, why, sizeof(why));
+
+    if (!ok || verbose)
+    {
+        FILE *out = ok ? stdout : stderr;
+        fprintf(out, "prf=%.1f pd=%lu burst=%lu/%lu: period %lu us, width %lu us, ", prf_hz, (unsigned long)width_us,
+            (unsigned long)on_ms, (unsigned long)off_ms, (unsigned long)p.period, (unsigned long)p.width);
+        if (p.burst_pulses)
+            fprintf(out, "%lu of %lu pulses per cycle of %lu us, ", (unsigned long)p.burst_pulses,
+                (unsigned long)asked, (unsigned long)p.burst_cycle);
+        fprintf(out, "%zu symbols%s%s\n", len, ok ? "" : ": ", why);
+    }
+
+    if (ok && verbose)
+    {
+        for (size_t i = 0; i < len; ++i)
+            printf("%u %u 0 %u\n", symbols[i].level0, symbols[i].duration0, symbols[i].duration1);
+    }
+
+    return ok;
+}
+
+static int sweep(void)
+{
+    unsigned long checked = 0, failed = 0;
+
+    for (size_t f = 0; f < sizeof(sweep_prf_hz) / sizeof(sweep_prf_hz[0]); ++f)
+    {
+        // Widths over a period are cut by the pattern, not left to the knob
+        for (size_t w = 0; w < sizeof(sweep_width_us) / sizeof(sweep_width_us[0]); ++w)
+        {
+            uint32_t width = sweep_width_us[w];
+
+            for (size_t n = 0; n < sizeof(sweep_on_ms) / sizeof(sweep_on_ms[0]); ++n)
+            {
+                for (size_t o = 0; o < sizeof(sweep_off_ms) / sizeof(sweep_off_ms[0]); ++o)
+                {
+                    checked++;
+                    if (!check(sweep_prf_hz[f], width, sweep_on_ms[n], sweep_off_ms[o], false)) failed++;
+                }
+            }
+        }
+    }
+
+    printf("bursts: %lu settings checked, %lu failed\n", checked, failed);
+
+    unsigned long burst_failed = failed;
+    checked = 0;
+    period_error_max = 0;
+    symbols_used_max = 0;
+
+    for (uint32_t i = 0; i < PERIOD_SWEEP_MAX_HZ + PERIOD_SWEEP_LOG_STEPS; ++i)
+    {
+        float prf_hz = i < PERIOD_SWEEP_MAX_HZ
+            ? i + 1
+            : PULSE_PATTERN_FREQ_MIN_HZ *
+                powf(PERIOD_SWEEP_MAX_HZ / PULSE_PATTERN_FREQ_MIN_HZ,
+                    (float)(i - PERIOD_SWEEP_MAX_HZ) / PERIOD_SWEEP_LOG_STEPS);
+        for (size_t w = 0; w < sizeof(period_sweep_width_us) / sizeof(period_sweep_width_us[0]); ++w)
+        {
+            checked++;
+            if (!check(prf_hz, period_sweep_width_us[w], 0, 0, false)) failed++;
+        }
+    }
+
+    printf("periods: %lu settings from %.1f Hz to %d Hz checked, %lu failed, off by %.2f us at most, up to %zu of "
+           "%d symbols\n",
+        checked, PULSE_PATTERN_FREQ_MIN_HZ, PERIOD_SWEEP_MAX_HZ, failed - burst_failed, period_error_max,
+        symbols_used_max, PWM_PATTERN_SYMBOLS_MAX);
+
+    return failed ? 1 : 0;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    float prf_hz = CONFIG_INTERRUPTER_PRF_DEFAULT;
+    uint32_t width_us = CONFIG_INTERRUPTER_PD_DEFAULT;
+    uint32_t on_ms = CONFIG_INTERRUPTER_BURST_ON_DEFAULT;
+    uint32_t off_ms = 0;
+    bool single = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "f:w:n:F:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'f':
+            prf_hz = strtof(optarg, NULL);
+            single = true;
+            break;
+        case 'w':
+            width_us = strtoul(optarg, NULL, 10);
+            single = true;
+            break;
+        case 'n':
+            on_ms = strtoul(optarg, NULL, 10);
+            single = true;
+            break;
+        case 'F':
+            off_ms = strtoul(optarg, NULL, 10);
+            single = true;
+            break;
+        default:
+            fputs(USAGE, stderr);
+            return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if (optind != argc)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    if (!single) return sweep();
+
+    return check(prf_hz, width_us, on_ms, off_ms, true) ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file pitch_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/note_table.h"
+#include "dsp/synth_engine.h"
+#include "host_check.h"
+#include "sdkconfig.h"
+#include <math.h>
+#include <stdio.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: pitch_check\n"                                                                                             \
+    "\n"                                                                                                               \
+    "Plays a sine through the engine and measures its pitch from the zero\n"                                           \
+    "crossings under pitch bend, bend range RPN, vibrato and reset controllers.\n"
+
+#define CODE 69
+#define CHANNEL 0
+#define OTHER_CHANNEL 1
+
+#define BEND_CENTER 8192
+#define FINE_CENTS (100.0 / NOTE_TABLE_FINE_STEPS)
+#define BEND_CENTS_MAX (FINE_CENTS / 2 + 0.1) // Bend is rounded to a fine step
+#define STEADY_CENTS_MAX 0.1
+
+#define MEASURE_LEN (SYNTH_SAMPLING_RATE_HZ / 2)
+#define SETTLE_LEN (2 * SYNTH_CONTROL_PERIOD) // A control update after each event
+
+#define VIBRATO_CENTS CONFIG_INTERRUPTER_SYNTH_VIBRATO_CENTS
+#define VIBRATO_HZ (CONFIG_INTERRUPTER_SYNTH_VIBRATO_RATE_DHZ / 10.0)
+#define VIBRATO_LEN (2 * SYNTH_SAMPLING_RATE_HZ)
+#define VIBRATO_WINDOW (SYNTH_SAMPLING_RATE_HZ / 100) // Pitch is averaged over it
+#define VIBRATO_CENTS_TOL 3.0 // Control rate steps, the window and the floor of the depth
+#define VIBRATO_HZ_TOL 0.1
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static int16_t buf[VIBRATO_LEN];
+static double window_cents[VIBRATO_LEN / VIBRATO_WINDOW];
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void cc(uint8_t channel, uint8_t controller, uint8_t value)
+{
+    synth_cmd_t cmd = {SYNTH_CMD_CONTROL_CHANGE, channel, controller, value};
+    synth_engine_apply(&cmd);
+}
+
+static void bend(uint8_t channel, int16_t value)
+{
+    uint16_t raw = value + BEND_CENTER;
+    synth_cmd_t cmd = {SYNTH_CMD_PITCH_BEND, channel, raw & 0x7F, raw >> 7};
+    synth_engine_apply(&cmd);
+}
+
+static void bend_range(uint8_t channel, uint8_t semitones)
+{
+    cc(channel, SYNTH_CC_RPN_MSB, 0);
+    cc(channel, SYNTH_CC_RPN_LSB, 0);
+    cc(channel, SYNTH_CC_DATA_ENTRY, semitones);
+}
+
+/**
+ * @brief Pitch of the sounding note against its table frequency
+ */
+static double measure_cents(void)
+{
+    host_check_render(buf, SETTLE_LEN);
+    host_check_render(buf, MEASURE_LEN);
+
+    return host_check_cents(host_check_pitch_hz(buf, MEASURE_LEN, SYNTH_SAMPLING_RATE_HZ), note_table_freq_hz(CODE));
+}
+
+static void start(void)
+{
+    synth_engine_init();
+    synth_engine_set_shape(CHANNEL, WAVETABLE_SHAPE_SINE);
+    synth_engine_note_on(CODE, CHANNEL, 127);
+}
+
+static void check_bend_at(int16_t value, int range)
+{
+    double expected = 100.0 * range * value / BEND_CENTER;
+
+    bend(CHANNEL, value);
+    double cents = measure_cents();
+    CHECK(fabs(cents - expected) <= BEND_CENTS_MAX, "bend %d over %d semitones: %.2f cents, %.2f expected", value,
+        range, cents, expected);
+}
+
+static void check_bend(void)
+{
+    start();
+
+    double cents = measure_cents();
+    CHECK(fabs(cents) <= STEADY_CENTS_MAX, "no bend: %.3f cents", cents);
+
+    const int16_t values[] = {BEND_CENTER - 1, -BEND_CENTER, BEND_CENTER / 2, -BEND_CENTER / 2, 1000, -3333, 0};
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) check_bend_at(values[i], 2);
+
+    // Channels bend on their own
+    bend(OTHER_CHANNEL, BEND_CENTER - 1);
+    cents = measure_cents();
+    CHECK(fabs(cents) <= STEADY_CENTS_MAX, "bend of another channel moves the note by %.3f cents", cents);
+
+    // A note struck under a bend is bent from its first sample, measured
+    // alone as the release of the previous one would pull the crossings
+    bend(CHANNEL, -BEND_CENTER);
+    synth_engine_note_off(CODE, CHANNEL);
+    host_check_render_until_idle(SYNTH_SAMPLING_RATE_HZ);
+    synth_engine_note_on(CODE, CHANNEL, 127);
+    host_check_render(buf, SETTLE_LEN);
+    cents = host_check_cents(host_check_pitch_hz(buf, SETTLE_LEN, SYNTH_SAMPLING_RATE_HZ), note_table_freq_hz(CODE));
+    CHECK(fabs(cents + 200) <= 5 * BEND_CENTS_MAX, "note struck under a bend starts at %.2f cents", cents);
+    cents = measure_cents();
+    CHECK(fabs(cents + 200) <= BEND_CENTS_MAX, "note struck under a bend: %.2f cents", cents);
+}
+
+static void check_rpn(void)
+{
+    start();
+
+    bend_range(CHANNEL, 12);
+    check_bend_at(BEND_CENTER - 1, 12);
+    check_bend_at(-BEND_CENTER, 12);
+    check_bend_at(BEND_CENTER / 2, 12);
+
+    // Data entry with no RPN selected, or another one, leaves the range alone
+    cc(CHANNEL, SYNTH_CC_RPN_MSB, 127);
+    cc(CHANNEL, SYNTH_CC_RPN_LSB, 127);
+    cc(CHANNEL, SYNTH_CC_DATA_ENTRY, 5);
+    check_bend_at(BEND_CENTER / 2, 12);
+    cc(CHANNEL, SYNTH_CC_RPN_MSB, 0);
+    cc(CHANNEL, SYNTH_CC_RPN_LSB, 1); // Fine tuning
+    cc(CHANNEL, SYNTH_CC_DATA_ENTRY, 5);
+    check_bend_at(BEND_CENTER / 2, 12);
+
+    // Past two octaves the range is clamped
+    bend_range(CHANNEL, 30);
+    check_bend_at(BEND_CENTER - 1, 24);
+    check_bend_at(-BEND_CENTER, 24);
+
+    // The range is per channel
+    bend(CHANNEL, 0);
+    bend_range(OTHER_CHANNEL, 1);
+    check_bend_at(BEND_CENTER / 2, 24);
+}
+
+static void check_vibrato(void)
+{
+    start();
+    cc(CHANNEL, SYNTH_CC_MODULATION, 127);
+    host_check_render(buf, SETTLE_LEN);
+    host_check_render(buf, VIBRATO_LEN);
+
+    size_t windows = VIBRATO_LEN / VIBRATO_WINDOW;
+    double low = 0, high = 0, sum = 0;
+    double first = -1, last = -1;
+    int crossings = 0;
+
+    for (size_t w = 0; w < windows; ++w)
+    {
+        double hz = host_check_pitch_hz(buf + w * VIBRATO_WINDOW, VIBRATO_WINDOW, SYNTH_SAMPLING_RATE_HZ);
+        double cents = host_check_cents(hz, note_table_freq_hz(CODE));
+        window_cents[w] = cents;
+        if (cents < low) low = cents;
+        if (cents > high) high = cents;
+
+        // Rising crossings of the centre give the rate
+        if (w > 0 && window_cents[w - 1] < 0 && cents >= 0)
+        {
+            double t = w - 1 + -window_cents[w - 1] / (cents - window_cents[w - 1]);
+            if (first < 0) first = t;
+            last = t;
+            crossings++;
+        }
+    }
+
+    // Mean over whole vibrato periods, between the first and last crossing
+    size_t counted = 0;
+    for (size_t w = (size_t)ceil(first); w <= (size_t)last; ++w, ++counted) sum += window_cents[w];
+
+    double windows_hz = (double)SYNTH_SAMPLING_RATE_HZ / VIBRATO_WINDOW;
+    double rate_hz = crossings > 1 ? (crossings - 1) * windows_hz / (last - first) : 0;
+    double centre = counted ? sum / counted : 0;
+
+    CHECK(fabs(high - VIBRATO_CENTS) <= VIBRATO_CENTS_TOL && fabs(low + VIBRATO_CENTS) <= VIBRATO_CENTS_TOL,
+        "vibrato from %.2f to %.2f cents, +-%d expected", low, high, VIBRATO_CENTS);
+    CHECK(fabs(rate_hz - VIBRATO_HZ) <= VIBRATO_HZ_TOL, "vibrato at %.2f Hz, %.2f expected", rate_hz, VIBRATO_HZ);
+    CHECK(fabs(centre) <= 1.0, "vibrato centred on %.2f cents", centre);
+    printf("vibrato: %.2f to %.2f cents at %.2f Hz, centred on %.2f cents\n", low, high, rate_hz, centre);
+
+    // Half the wheel, half the depth
+    cc(CHANNEL, SYNTH_CC_MODULATION, 64);
+    host_check_render(buf, SETTLE_LEN);
+    host_check_render(buf, VIBRATO_LEN);
+    high = 0;
+    for (size_t w = 0; w < windows; ++w)
+    {
+        double hz = host_check_pitch_hz(buf + w * VIBRATO_WINDOW, VIBRATO_WINDOW, SYNTH_SAMPLING_RATE_HZ);
+        double cents = host_check_cents(hz, note_table_freq_hz(CODE));
+        if (cents > high) high = cents;
+    }
+    CHECK(fabs(high - VIBRATO_CENTS / 2.0) <= VIBRATO_CENTS_TOL, "half wheel vibrato up to %.2f cents", high);
+}
+
+static void check_reset(void)
+{
+    start();
+    bend_range(CHANNEL, 12);
+    bend(CHANNEL, BEND_CENTER / 2);
+    cc(CHANNEL, SYNTH_CC_MODULATION, 127);
+
+    cc(CHANNEL, SYNTH_CC_RESET_CONTROLLERS, 0);
+    double cents = measure_cents();
+    CHECK(fabs(cents) <= STEADY_CENTS_MAX, "reset controllers leaves %.3f cents", cents);
+
+    // The range itself is kept, the RPN selection is not
+    cc(CHANNEL, SYNTH_CC_DATA_ENTRY, 2);
+    check_bend_at(BEND_CENTER / 2, 12);
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    check_bend();
+    check_rpn();
+    check_vibrato();
+    check_reset();
+
+    return host_check_report("pitch_check");
+}
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file pulse_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/note_table.h"
+#include "dsp/pulse_train.h"
+#include "host_check.h"
+#include <stdio.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: pulse_check\n"                                                                                             \
+    "\n"                                                                                                               \
+    "Checks the pulse train periods: every note at its table frequency, bent\n"                                        \
+    "by the pitch wheel over the bend range the channel set by RPN, with the\n"                                        \
+    "range following data entry on sounding notes, clamped, reset with the\n"                                          \
+    "controllers and kept apart between channels.\n"
+
+#define PULSES 200
+#define CODE_LOW 21      // A0
+#define CODE_HIGH 96     // C7, the highest the off time lets through
+#define BENT_LOW 24      // Two octaves down stays in the table
+#define BENT_HIGH 72     // Two octaves up stays under C7
+#define BEND_MAX 8191
+#define BEND_MIN (-8192)
+#define CENTS_TOLERANCE 0.05
+#define FINE_CENTS (100.0 / NOTE_TABLE_FINE_STEPS)
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static uint32_t now = 0;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void send(uint8_t type, uint8_t channel, uint8_t data1, uint8_t data2)
+{
+    synth_cmd_t cmd = {.type = type, .channel = channel, .data1 = data1, .data2 = data2};
+    pulse_t pulse;
+
+    while (pulse_train_next(now, &pulse)) continue;
+    CHECK(pulse_train_apply(&cmd, now) == ESP_OK, "event %u %u %u on channel %u refused", type, data1, data2,
+        channel);
+}
+
+static void cc(uint8_t channel, uint8_t controller, uint8_t value)
+{
+    send(SYNTH_CMD_CONTROL_CHANGE, channel, controller, value);
+}
+
+static void bend(uint8_t channel, int32_t value)
+{
+    uint32_t raw = (uint32_t)(value + 8192);
+    send(SYNTH_CMD_PITCH_BEND, channel, raw & 0x7F, (uint8_t)(raw >> 7));
+}
+
+static void bend_range(uint8_t channel, uint8_t semitones)
+{
+    cc(channel, SYNTH_CC_RPN_MSB, 0);
+    cc(channel, SYNTH_CC_RPN_LSB, 0);
+    cc(channel, SYNTH_CC_DATA_ENTRY, semitones);
+}
+
+/**
+ * @brief Mean frequency of the next pulses of the only sounding note
+ *
+ * The pulse already due was placed at the period before the last event, the
+ * count starts after it.
+ */
+static double pulse_hz(void)
+{
+    pulse_t pulse;
+    uint32_t first = 0, last = 0;
+    int count = -1;
+
+    while (pulse_train_next(now, &pulse)) continue;
+    while (count < PULSES)
+    {
+        now += 1000;
+        while (count < PULSES && pulse_train_next(now, &pulse))
+        {
+            if (count++ == 0) first = pulse.start;
+            last = pulse.start;
+        }
+    }
+    now = last + 1;
+
+    return 1e6 * (PULSES - 1) / (double)(last - first);
+}
+
+/**
+ * @brief Bend of a note against the exact one of the range, within half a fine step
+ */
+static void check_bent(const char *what, uint8_t code, int32_t value, double range)
+{
+    double want = 100.0 * range * value / 8192;
+    double cents = host_check_cents(pulse_hz(), note_table_freq_hz(code));
+
+    CHECK(fabs(cents - want) <= FINE_CENTS / 2 + CENTS_TOLERANCE, "%s: note %u bent %ld is %.3f cents, %.3f expected",
+        what, code, (long)value, cents, want);
+}
+
+static void reset(void)
+{
+    pulse_train_init();
+    pulse_train_set_width(PULSE_TRAIN_TON_MAX);
+    now = 0;
+}
+
+/**
+ * @brief Every note unbent at its table frequency
+ */
+static void check_notes(void)
+{
+    for (uint8_t code = CODE_LOW; code <= CODE_HIGH; ++code)
+    {
+        reset();
+        send(SYNTH_CMD_NOTE_ON, 0, code, 127);
+        double cents = host_check_cents(pulse_hz(), note_table_freq_hz(code));
+        CHECK(fabs(cents) <= CENTS_TOLERANCE, "note %u is %.3f cents off", code, cents);
+    }
+}
+
+/**
+ * @brief Default range, then ranges set by RPN before and during the note
+ */
+static void check_ranges(void)
+{
+    static const uint8_t ranges[] = {0, 1, 2, 7, 12, 24};
+    static const int32_t values[] = {BEND_MIN, -4096, -1, 1, 2048, BEND_MAX};
+
+    for (uint8_t code = BENT_LOW; code <= BENT_HIGH; code += 6)
+        for (size_t v = 0; v < sizeof(values) / sizeof(values[0]); ++v)
+        {
+            reset();
+            send(SYNTH_CMD_NOTE_ON, 0, code, 127);
+            bend(0, values[v]);
+            check_bent("default range", code, values[v], 2);
+
+            for (size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); ++r)
+            {
+                bend_range(0, ranges[r]);
+                check_bent("range set while sounding", code, values[v], ranges[r]);
+            }
+
+            send(SYNTH_CMD_NOTE_OFF, 0, code, 0);
+            send(SYNTH_CMD_NOTE_ON, 0, code, 127);
+            check_bent("range kept for the next note", code, values[v], 24);
+        }
+}
+
+/**
+ * @brief Clamped to two octaves, other RPNs and resets leave the range alone
+ */
+static void check_rpn(void)
+{
+    reset();
+    bend_range(0, 127);
+    send(SYNTH_CMD_NOTE_ON, 0, 60, 127);
+    bend(0, BEND_MIN);
+    check_bent("range over 24", 60, BEND_MIN, 24);
+
+    // Fine tuning RPN, then no RPN selected
+    bend_range(0, 12);
+    cc(0, SYNTH_CC_RPN_LSB, 1);
+    cc(0, SYNTH_CC_DATA_ENTRY, 3);
+    check_bent("data entry of another RPN", 60, BEND_MIN, 12);
+    cc(0, SYNTH_CC_RPN_MSB, 0x7F);
+    cc(0, SYNTH_CC_RPN_LSB, 0x7F);
+    cc(0, SYNTH_CC_DATA_ENTRY, 3);
+    check_bent("data entry with no RPN", 60, BEND_MIN, 12);
+
+    // The reset centers the wheel and deselects the RPN, not the range
+    bend_range(0, 5);
+    cc(0, SYNTH_CC_RESET_CONTROLLERS, 0);
+    cc(0, SYNTH_CC_DATA_ENTRY, 24);
+    check_bent("reset controllers", 60, 0, 5);
+    bend(0, BEND_MIN);
+    check_bent("data entry after a reset", 60, BEND_MIN, 5);
+
+    // Each channel has its own
+    reset();
+    bend_range(1, 12);
+    bend(0, BEND_MAX);
+    bend(1, BEND_MAX);
+    send(SYNTH_CMD_NOTE_ON, 0, 60, 127);
+    check_bent("channel 0", 60, BEND_MAX, 2);
+    send(SYNTH_CMD_NOTE_OFF, 0, 60, 0);
+    send(SYNTH_CMD_NOTE_ON, 1, 60, 127);
+    check_bent("channel 1", 60, BEND_MAX, 12);
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    check_notes();
+    check_ranges();
+    check_rpn();
+
+    return host_check_report("pulse_check");
+}
@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file ring_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "core/spsc_ring.h"
+#include "host_check.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: ring_check\n"                                                                                              \
+    "\n"                                                                                                               \
+    "Checks the lock-free command ring: argument checks, full and empty edges\n"                                       \
+    "with the indices wrapping around 2^32, then a producer thread pushing\n"                                          \
+    "numbered items as fast as it can while a consumer thread drains them,\n"                                          \
+    "for several capacities. Every item must come out once, in order and\n"                                           \
+    "whole. The build adds -fsanitize=thread when the compiler has it.\n"
+
+#define ITEMS 400000
+#define ITEM_WORDS 5                // Beside the sequence number, an odd size on purpose
+#define BURST 37                    // Pushes between yields, to vary how full the ring runs
+#define WRAP_START (UINT32_MAX - 5) // Indices a few items short of wrapping
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t seq;
+    uint32_t words[ITEM_WORDS]; // Derived from seq, a torn item breaks them
+} item_t;
+
+typedef struct
+{
+    spsc_ring_t *ring;
+    uint32_t capacity;
+    uint32_t fulls;   // Pushes refused
+    uint32_t empties; // Pops that found nothing
+    uint32_t lost, reordered, torn, overfull;
+} stress_t;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static uint32_t word(uint32_t seq, int i) { return (seq + 1) * 2654435761u ^ (uint32_t)i * 0x9E3779B9u; }
+
+static item_t make_item(uint32_t seq)
+{
+    item_t item = {.seq = seq};
+    for (int i = 0; i < ITEM_WORDS; ++i) item.words[i] = word(seq, i);
+    return item;
+}
+
+static bool whole(const item_t *item)
+{
+    for (int i = 0; i < ITEM_WORDS; ++i)
+        if (item->words[i] != word(item->seq, i)) return false;
+    return true;
+}
+
+static void *producer(void *arg)
+{
+    stress_t *s = arg;
+
+    for (uint32_t seq = 0; seq < ITEMS; ++seq)
+    {
+        item_t item = make_item(seq);
+        while (!spsc_ring_push(s->ring, &item))
+        {
+            s->fulls++;
+            sched_yield();
+        }
+        if (seq % BURST == 0) sched_yield();
+    }
+
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    stress_t *s = arg;
+    uint32_t expected = 0;
+
+    while (expected < ITEMS)
+    {
+        item_t item;
+
+        if (spsc_ring_count(s->ring) > s->capacity) s->overfull++;
+        if (!spsc_ring_pop(s->ring, &item))
+        {
+            s->empties++;
+            sched_yield();
+            continue;
+        }
+
+        if (!whole(&item)) s->torn++;
+        if (item.seq > expected) s->lost += item.seq - expected;
+        if (item.seq < expected) s->reordered++;
+        expected = item.seq + 1;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Bad arguments are refused, the ring holds exactly its capacity
+ */
+static void check_edges(void)
+{
+    static item_t storage[8];
+    spsc_ring_t ring;
+    item_t item = make_item(0);
+
+    CHECK(spsc_ring_init(&ring, storage, sizeof(item_t), 6) == ESP_ERR_INVALID_SIZE, "capacity 6 accepted");
+    CHECK(spsc_ring_init(&ring, storage, sizeof(item_t), 0) == ESP_ERR_INVALID_SIZE, "capacity 0 accepted");
+    CHECK(spsc_ring_init(&ring, NULL, sizeof(item_t), 8) == ESP_ERR_INVALID_ARG, "no storage accepted");
+    CHECK(spsc_ring_init(&ring, storage, 0, 8) == ESP_ERR_INVALID_ARG, "item size 0 accepted");
+
+    for (uint32_t capacity = 1; capacity <= 8; capacity *= 2)
+    {
+        spsc_ring_init(&ring, storage, sizeof(item_t), capacity);
+        // Start just short of the wrap so the indices cross it
+        atomic_store(&ring.head, WRAP_START);
+        atomic_store(&ring.tail, WRAP_START);
+        uint32_t next_in = 0, next_out = 0;
+
+        for (int round = 0; round < 12; ++round)
+        {
+            CHECK(!spsc_ring_pop(&ring, &item), "capacity %lu: pop from an empty ring", (unsigned long)capacity);
+
+            while (next_in - next_out < capacity)
+            {
+                item = make_item(next_in++);
+                CHECK(spsc_ring_push(&ring, &item), "capacity %lu: push %lu refused with %lu queued",
+                    (unsigned long)capacity, (unsigned long)next_in - 1, (unsigned long)spsc_ring_count(&ring));
+            }
+            CHECK(spsc_ring_count(&ring) == capacity, "capacity %lu: %lu queued when full", (unsigned long)capacity,
+                (unsigned long)spsc_ring_count(&ring));
+            item = make_item(next_in);
+            CHECK(!spsc_ring_push(&ring, &item), "capacity %lu: push into a full ring", (unsigned long)capacity);
+
+            while (next_out < next_in)
+            {
+                bool popped = spsc_ring_pop(&ring, &item);
+                CHECK(popped && item.seq == next_out && whole(&item), "capacity %lu: item %lu read as %lu",
+                    (unsigned long)capacity, (unsigned long)next_out, (unsigned long)item.seq);
+                next_out++;
+            }
+        }
+
+        CHECK(atomic_load(&ring.head) < WRAP_START, "capacity %lu: the indices never wrapped", (unsigned long)capacity);
+    }
+}
+
+/**
+ * @brief One producer and one consumer thread on rings of several sizes
+ */
+static void check_threads(void)
+{
+    static const uint32_t capacities[] = {1, 2, 16, 256};
+    static item_t storage[256];
+
+    for (size_t c = 0; c < sizeof(capacities) / sizeof(capacities[0]); ++c)
+    {
+        spsc_ring_t ring;
+        stress_t s = {.ring = &ring, .capacity = capacities[c]};
+        pthread_t threads[2];
+
+        spsc_ring_init(&ring, storage, sizeof(item_t), capacities[c]);
+        if (c % 2) // Every other run across the wrap of the indices
+        {
+            atomic_store(&ring.head, WRAP_START);
+            atomic_store(&ring.tail, WRAP_START);
+        }
+
+        pthread_create(&threads[0], NULL, consumer, &s);
+        pthread_create(&threads[1], NULL, producer, &s);
+        pthread_join(threads[1], NULL);
+        pthread_join(threads[0], NULL);
+
+        item_t item;
+        CHECK(s.lost == 0 && s.reordered == 0 && s.torn == 0,
+            "capacity %lu: %lu items lost, %lu out of order, %lu torn", (unsigned long)capacities[c],
+            (unsigned long)s.lost, (unsigned long)s.reordered, (unsigned long)s.torn);
+        CHECK(s.overfull == 0, "capacity %lu: more queued than the capacity %lu times", (unsigned long)capacities[c],
+            (unsigned long)s.overfull);
+        CHECK(!spsc_ring_pop(&ring, &item) && spsc_ring_count(&ring) == 0, "capacity %lu: items left after the last",
+            (unsigned long)capacities[c]);
+        printf("capacity %3lu: %d items, %lu pushes refused, %lu pops empty\n", (unsigned long)capacities[c], ITEMS,
+            (unsigned long)s.fulls, (unsigned long)s.empties);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    check_edges();
+    check_threads();
+
+    return host_check_report("ring_check");
+}
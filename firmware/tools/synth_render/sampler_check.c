@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file sampler_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/note_table.h"
+#include "dsp/sampler.h"
+#include "host_check.h"
+#include <stdio.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: sampler_check\n"                                                                                           \
+    "\n"                                                                                                               \
+    "Builds sample banks in memory and checks that the loader sizes the valid\n"                                       \
+    "ones and rejects every corrupt header or entry, lengths that would wrap\n"                                        \
+    "the data size included, then plays a recording to its last sample.\n"
+
+#define ENTRIES 2
+#define PCM_LENGTH 100
+#define ADPCM_LENGTH 51 // Odd, the last byte holds one nibble
+#define DATA_START (sizeof(sampler_bank_header_t) + ENTRIES * sizeof(sampler_entry_t))
+#define PCM_OFFSET DATA_START
+#define ADPCM_OFFSET (PCM_OFFSET + 2 * PCM_LENGTH)
+#define BANK_SIZE (ADPCM_OFFSET + (ADPCM_LENGTH + 1) / 2)
+#define RATE_HZ 16000
+#define ROOT_NOTE 60
+#define TAIL_LEN 32
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+typedef enum
+{
+    FIELD_OFFSET = 0,
+    FIELD_LENGTH,
+    FIELD_RATE,
+    FIELD_FORMAT,
+    FIELD_ROOT_NOTE,
+    FIELD_ADPCM_INDEX
+} field_t;
+
+typedef struct
+{
+    const char *name;
+    int entry;
+    field_t field;
+    uint32_t value;
+} corruption_t;
+
+typedef struct
+{
+    sampler_bank_header_t header;
+    sampler_entry_t entries[ENTRIES];
+    uint8_t data[BANK_SIZE - DATA_START];
+} bank_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static bank_t bank;
+
+static const corruption_t corruptions[] = {
+    // 2 * length is a multiple of 2^32 or just past it: 0 or 2 bytes in 32 bits
+    {"16-bit length 2^31", 0, FIELD_LENGTH, 0x80000000UL},
+    {"16-bit length 2^31 + 1", 0, FIELD_LENGTH, 0x80000001UL},
+    {"16-bit length 2^32 - 1", 0, FIELD_LENGTH, UINT32_MAX},
+    // length + 1 is 0 in 32 bits
+    {"ADPCM length 2^32 - 1", 1, FIELD_LENGTH, UINT32_MAX},
+    {"ADPCM length 2^32 - 2", 1, FIELD_LENGTH, UINT32_MAX - 1},
+    {"16-bit length one past the end", 0, FIELD_LENGTH, PCM_LENGTH + (BANK_SIZE - ADPCM_OFFSET) / 2 + 1},
+    {"offset past the bank", 1, FIELD_OFFSET, BANK_SIZE + 1},
+    {"offset near 2^32", 1, FIELD_OFFSET, UINT32_MAX - 1},
+    {"odd 16-bit offset", 0, FIELD_OFFSET, PCM_OFFSET + 1},
+    {"unknown format", 0, FIELD_FORMAT, SAMPLER_FORMAT_IMA_ADPCM + 1},
+    {"rate 0", 0, FIELD_RATE, 0},
+    {"root note 128", 0, FIELD_ROOT_NOTE, 128},
+    {"ADPCM index 89", 1, FIELD_ADPCM_INDEX, 89},
+};
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief A 16-bit recording on notes 0..63 and an ADPCM one above
+ */
+static void build(void)
+{
+    memset(&bank, 0, sizeof(bank));
+    bank.header = (sampler_bank_header_t){.magic = SAMPLER_MAGIC, .version = SAMPLER_VERSION, .count = ENTRIES};
+    bank.entries[0] = (sampler_entry_t){.offset = PCM_OFFSET, .length = PCM_LENGTH, .rate_hz = RATE_HZ,
+        .format = SAMPLER_FORMAT_PCM16, .root_note = ROOT_NOTE, .low_note = 0, .high_note = 63};
+    bank.entries[1] = (sampler_entry_t){.offset = ADPCM_OFFSET, .length = ADPCM_LENGTH, .rate_hz = RATE_HZ,
+        .format = SAMPLER_FORMAT_IMA_ADPCM, .root_note = ROOT_NOTE + 12, .low_note = 64, .high_note = 127};
+
+    int16_t *pcm = (int16_t *)bank.data;
+    for (int n = 0; n < PCM_LENGTH; ++n) pcm[n] = (int16_t)(n * 300 - 15000);
+    for (int n = 0; n < (ADPCM_LENGTH + 1) / 2; ++n) bank.data[2 * PCM_LENGTH + n] = 0x73;
+}
+
+static void check_sizes(void)
+{
+    build();
+    CHECK(sampler_bank_size(&bank, sizeof(bank)) == BANK_SIZE, "valid bank sized %zu, %zu expected",
+        sampler_bank_size(&bank, sizeof(bank)), (size_t)BANK_SIZE);
+    CHECK(sampler_bank_size(&bank, BANK_SIZE) == BANK_SIZE, "bank ending on its last byte refused");
+    CHECK(sampler_bank_size(&bank, BANK_SIZE - 1) == 0, "bank one byte short accepted");
+    CHECK(sampler_bank_size(&bank, sizeof(bank.header) - 1) == 0, "bank shorter than its header accepted");
+    CHECK(sampler_bank_size(&bank, DATA_START - 1) == 0, "bank shorter than its table accepted");
+}
+
+/**
+ * @brief Each corruption alone must make the bank invalid
+ */
+static void check_corrupt(void)
+{
+    for (size_t i = 0; i < sizeof(corruptions) / sizeof(corruptions[0]); ++i)
+    {
+        const corruption_t *c = &corruptions[i];
+
+        build();
+        sampler_entry_t *e = &bank.entries[c->entry];
+        switch (c->field)
+        {
+        case FIELD_OFFSET:
+            e->offset = c->value;
+            break;
+        case FIELD_LENGTH:
+            e->length = c->value;
+            break;
+        case FIELD_RATE:
+            e->rate_hz = c->value;
+            break;
+        case FIELD_FORMAT:
+            e->format = c->value;
+            break;
+        case FIELD_ROOT_NOTE:
+            e->root_note = c->value;
+            break;
+        default:
+            e->adpcm_index = c->value;
+            break;
+        }
+
+        CHECK(sampler_bank_size(&bank, BANK_SIZE) == 0, "%s accepted", c->name);
+        CHECK(sampler_init(&bank, BANK_SIZE) == ESP_ERR_INVALID_ARG, "%s loaded", c->name);
+    }
+
+    build();
+    bank.header.magic ^= 1;
+    CHECK(sampler_bank_size(&bank, BANK_SIZE) == 0, "bad magic accepted");
+    build();
+    bank.header.version++;
+    CHECK(sampler_bank_size(&bank, BANK_SIZE) == 0, "unknown version accepted");
+    build();
+    bank.header.count = UINT16_MAX;
+    CHECK(sampler_bank_size(&bank, BANK_SIZE) == 0, "table past the bank accepted");
+    CHECK(sampler_init(NULL, BANK_SIZE) == ESP_ERR_INVALID_ARG, "no bank loaded");
+}
+
+/**
+ * @brief At its root note and rate, a recording plays back sample for sample
+ */
+static void check_playback(void)
+{
+    int16_t out[PCM_LENGTH];
+    sampler_voice_t sv;
+
+    build();
+    note_table_init();
+    CHECK(sampler_init(&bank, BANK_SIZE) == ESP_OK, "valid bank not loaded");
+    CHECK(sampler_find(63) == &bank.entries[0] && sampler_find(64) == &bank.entries[1], "notes mapped wrong");
+
+    const sampler_entry_t *e = sampler_find(ROOT_NOTE);
+    sampler_start(&sv, e);
+    sv.step = sampler_step(e, note_table_phase_inc(ROOT_NOTE), RATE_HZ);
+    CHECK(sv.step == 1UL << SAMPLER_STEP_BITS, "step %lu at the root note", (unsigned long)sv.step);
+
+    bool more = sampler_render(&sv, out, PCM_LENGTH);
+    CHECK(memcmp(out, bank.data, PCM_LENGTH * sizeof(int16_t)) == 0, "recording not played as stored");
+    CHECK(!more, "recording still playing past its %d samples", PCM_LENGTH);
+    CHECK(!sampler_render(&sv, out, TAIL_LEN) && out[0] == 0 && out[TAIL_LEN - 1] == 0,
+        "sound past the end of the recording");
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    check_sizes();
+    check_corrupt();
+    check_playback();
+
+    return host_check_report("sampler_check");
+}
@@ -0,0 +1,577 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file sequencer_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/sequencer.h"
+#include "hal/synth.h"
+#include "host_check.h"
+#include "host_rtos.h"
+#include "sdkconfig.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: sequencer_check\n"                                                                                         \
+    "\n"                                                                                                               \
+    "Plays keys and MIDI clock into the arpeggiator and step sequencer and\n"                                         \
+    "checks the notes they output: sample exact steps on the internal tempo,\n"                                        \
+    "arpeggio orders, mode changes, following clock with start, stop and\n"                                           \
+    "continue, the internal tempo taking over when the clock goes silent,\n"                                         \
+    "steps against an ideal grid under clock jitter, drum notes going past,\n"                                       \
+    "and that no note is left hanging in the synth by a mode change or all\n"                                        \
+    "notes off.\n"
+
+#define RATE_HZ SYNTH_SAMPLING_RATE_HZ
+#define MS(ms) ((ms) * RATE_HZ / 1000)
+#define STEPS_PER_BEAT CONFIG_INTERRUPTER_SYNTH_SEQ_STEPS_PER_BEAT
+#define CLOCKS_PER_STEP (SEQUENCER_CLOCKS_PER_BEAT / STEPS_PER_BEAT)
+#define GATE_PCT CONFIG_INTERRUPTER_SYNTH_SEQ_GATE_PCT
+
+#define EVENTS_MAX 4096
+#define CHANNEL 0
+#define GAP MS(250) // Past the release, the synth is silent again
+
+#define CLOCK_BPM 125      // 320 samples per clock at 16 kHz
+#define JITTER MS(3)       // Of USB delivered clock, each way
+#define JITTER_GATE_TOL 0.1 // Of the ideal gate
+#define CLOCK_TIMEOUT MS(500)
+#define DRUM_CODE 38 // Snare
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t time;
+    synth_cmd_t cmd;
+} out_event_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static out_event_t out[EVENTS_MAX];
+static size_t out_len = 0;
+static uint32_t now = 0; // Sequencer side clock, next sample to pop
+
+static uint16_t played[MS(2000)];
+static uint32_t drained = 0;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void reset(sequencer_mode_t mode)
+{
+    sequencer_init(RATE_HZ);
+    sequencer_set_mode(mode);
+    out_len = 0;
+    now = 0;
+}
+
+/**
+ * @brief Take the sequencer output up to the given sample, as the render task does
+ */
+static void run_until(uint32_t time)
+{
+    synth_cmd_t cmd;
+
+    for (; (int32_t)(now - time) < 0; ++now)
+    {
+        sequencer_poll(now);
+        while (sequencer_pop(now, &cmd))
+            if (out_len < EVENTS_MAX) out[out_len++] = (out_event_t){.time = now, .cmd = cmd};
+    }
+}
+
+static bool input(uint32_t time, synth_cmd_type_t type, uint8_t data1, uint8_t data2)
+{
+    synth_cmd_t cmd = {.type = type, .channel = CHANNEL, .data1 = data1, .data2 = data2};
+
+    run_until(time);
+    return sequencer_input(&cmd, time);
+}
+
+static bool key_on(uint32_t time, uint8_t code) { return input(time, SYNTH_CMD_NOTE_ON, code, 100); }
+
+static bool key_off(uint32_t time, uint8_t code) { return input(time, SYNTH_CMD_NOTE_OFF, code, 0); }
+
+static void clock_at(uint32_t time, uint8_t status) { input(time, SYNTH_CMD_REALTIME, status, 0); }
+
+/**
+ * @brief Note-ons output from the given event on, times and codes
+ */
+static size_t note_ons(size_t from, uint32_t *times, uint8_t *codes, size_t max)
+{
+    size_t count = 0;
+
+    for (size_t i = from; i < out_len && count < max; ++i)
+    {
+        if (out[i].cmd.type != SYNTH_CMD_NOTE_ON) continue;
+        if (times) times[count] = out[i].time;
+        if (codes) codes[count] = out[i].cmd.data1;
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Every note-on is followed by its note-off before the next one
+ */
+static bool gates_closed(size_t from, uint32_t gate)
+{
+    bool ok = true;
+
+    for (size_t i = from; i < out_len; ++i)
+    {
+        if (out[i].cmd.type != SYNTH_CMD_NOTE_ON) continue;
+
+        bool closed = i + 1 < out_len && out[i + 1].cmd.type == SYNTH_CMD_NOTE_OFF
+                   && out[i + 1].cmd.data1 == out[i].cmd.data1;
+        ok &= CHECK(closed, "note %d at %lu not released before the next event", out[i].cmd.data1,
+            (unsigned long)out[i].time);
+        if (closed && gate)
+            ok &= CHECK(out[i + 1].time - out[i].time == gate, "note at %lu held %lu samples, %lu expected",
+                (unsigned long)out[i].time, (unsigned long)(out[i + 1].time - out[i].time), (unsigned long)gate);
+    }
+
+    return ok;
+}
+
+/**
+ * @brief Steps on the internal tempo fall on the exact grid, rounded down
+ */
+static void check_step_timing(void)
+{
+    const uint16_t bpm = 130; // 1846.15 samples per step
+    const uint32_t start = 1000;
+    const uint32_t num = RATE_HZ * 60;
+    const uint32_t den = (uint32_t)bpm * STEPS_PER_BEAT;
+    const size_t steps = 500;
+    static uint32_t times[EVENTS_MAX];
+    double worst = 0;
+
+    reset(SEQUENCER_ARP_UP);
+    CHECK(sequencer_set_tempo(bpm) == ESP_OK, "tempo %d refused", bpm);
+    CHECK(key_on(start, 60), "key not taken by the arpeggiator");
+    run_until(start + (uint64_t)steps * num / den);
+
+    size_t count = note_ons(0, times, NULL, EVENTS_MAX);
+    CHECK(count == steps, "%zu steps in %zu step lengths", count, steps);
+    for (size_t k = 0; k < count; ++k)
+    {
+        uint32_t want = start + (uint64_t)k * num / den;
+        double error = times[k] - (start + (double)k * num / den);
+        CHECK(times[k] == want, "step %zu at %lu, %lu expected", k, (unsigned long)times[k], (unsigned long)want);
+        if (error < 0) error = -error;
+        if (error > worst) worst = error;
+    }
+    gates_closed(0, (uint64_t)(num / den) * GATE_PCT / 100);
+    printf("%zu steps at %d BPM within %.2f samples of the ideal grid\n", count, bpm, worst);
+
+    // Tempo controller, 40 + 2 * value BPM
+    reset(SEQUENCER_ARP_UP);
+    CHECK(input(0, SYNTH_CMD_CONTROL_CHANGE, SEQUENCER_CC_TEMPO, 40), "tempo controller not taken");
+    key_on(0, 60);
+    run_until(RATE_HZ);
+    count = note_ons(0, times, NULL, EVENTS_MAX);
+    CHECK(count == 2 * STEPS_PER_BEAT && times[1] == RATE_HZ * 60 / (120 * STEPS_PER_BEAT),
+        "%zu steps at 120 BPM in a second, second at %lu", count, (unsigned long)times[1]);
+}
+
+static void check_arp(sequencer_mode_t mode, const char *name, const uint8_t *want, size_t len)
+{
+    uint8_t codes[16];
+
+    reset(mode);
+    key_on(0, 64);
+    key_on(0, 60);
+    key_on(0, 67);
+    run_until(len * RATE_HZ * 60 / (CONFIG_INTERRUPTER_SYNTH_SEQ_BPM * STEPS_PER_BEAT));
+
+    size_t count = note_ons(0, NULL, codes, len);
+    CHECK(count == len, "%s: %zu steps, %zu expected", name, count, len);
+    for (size_t i = 0; i < count; ++i)
+        CHECK(codes[i] == want[i], "%s: step %zu plays %d, %d expected", name, i, codes[i], want[i]);
+}
+
+/**
+ * @brief Each mode plays the held keys, or the pattern, in its order
+ */
+static void check_orders(void)
+{
+    static const uint8_t up[] = {60, 64, 67, 60, 64, 67};
+    static const uint8_t down[] = {67, 64, 60, 67, 64, 60};
+    static const uint8_t up_down[] = {60, 64, 67, 64, 60, 64, 67};
+    static const uint8_t played_order[] = {64, 60, 67, 64, 60, 67};
+    static const int8_t pattern[] = {0, 12, SEQUENCER_REST, 7};
+    static const uint8_t step[] = {67, 79, 74, 67, 79, 74}; // On the last key, the rest plays nothing
+
+    check_arp(SEQUENCER_ARP_UP, "up", up, sizeof(up));
+    check_arp(SEQUENCER_ARP_DOWN, "down", down, sizeof(down));
+    check_arp(SEQUENCER_ARP_UP_DOWN, "up and down", up_down, sizeof(up_down));
+    check_arp(SEQUENCER_ARP_PLAYED, "as played", played_order, sizeof(played_order));
+
+    sequencer_set_pattern(pattern, sizeof(pattern));
+    reset(SEQUENCER_STEP);
+    CHECK(sequencer_set_pattern(pattern, sizeof(pattern)) == ESP_OK, "pattern refused");
+    key_on(0, 64);
+    key_on(0, 60);
+    key_on(0, 67);
+    run_until(8 * RATE_HZ * 60 / (CONFIG_INTERRUPTER_SYNTH_SEQ_BPM * STEPS_PER_BEAT));
+    uint8_t codes[8];
+    size_t count = note_ons(0, NULL, codes, 8);
+    CHECK(count == sizeof(step), "pattern: %zu notes in 8 steps, %zu expected", count, sizeof(step));
+    for (size_t i = 0; i < count && i < sizeof(step); ++i)
+        CHECK(codes[i] == step[i], "pattern: note %zu is %d, %d expected", i, codes[i], step[i]);
+}
+
+/**
+ * @brief Keys go to the engine or the sequencer by the mode they were pressed in
+ */
+static void check_modes(void)
+{
+    const uint32_t step = RATE_HZ * 60 / (CONFIG_INTERRUPTER_SYNTH_SEQ_BPM * STEPS_PER_BEAT);
+
+    // Pressed while off, released in an arpeggio mode: the release reaches the engine
+    reset(SEQUENCER_OFF);
+    CHECK(!key_on(0, 60), "key taken while off");
+    CHECK(input(MS(100), SYNTH_CMD_CONTROL_CHANGE, SEQUENCER_CC_MODE, 40), "mode controller not taken");
+    CHECK(!key_off(MS(200), 60), "release of a key pressed while off taken, the note hangs");
+    run_until(MS(400));
+    CHECK(out_len == 0, "%zu events out of a sequencer with no key", out_len);
+
+    // Held in an arpeggio, the release stays here
+    CHECK(key_on(MS(400), 62), "key not taken in the arpeggio mode");
+    run_until(MS(400) + 2 * step);
+    CHECK(key_off(MS(400) + 2 * step, 62), "release of a held key passed on");
+    run_until(MS(400) + 4 * step);
+    CHECK(note_ons(0, NULL, NULL, EVENTS_MAX) == 2, "%zu steps for 2 step lengths",
+        note_ons(0, NULL, NULL, EVENTS_MAX));
+    gates_closed(0, 0);
+
+    // Off again: held keys stop stepping, keys pass to the engine
+    reset(SEQUENCER_ARP_UP);
+    key_on(0, 60);
+    key_on(0, 64);
+    run_until(step / 4);
+    CHECK(input(step / 4, SYNTH_CMD_CONTROL_CHANGE, SEQUENCER_CC_MODE, 0), "mode controller not taken");
+    run_until(8 * step);
+    CHECK(note_ons(0, NULL, NULL, EVENTS_MAX) == 1, "%zu steps after the arpeggio was turned off",
+        note_ons(0, NULL, NULL, EVENTS_MAX));
+    gates_closed(0, 0);
+    CHECK(!key_on(8 * step, 67), "key taken while off");
+
+    // To the step mode without keys: nothing plays until one is pressed
+    size_t from = out_len;
+    CHECK(input(9 * step, SYNTH_CMD_CONTROL_CHANGE, SEQUENCER_CC_MODE, 127), "mode controller not taken");
+    CHECK(!key_off(9 * step, 60), "release of a key dropped by the mode change taken");
+    run_until(12 * step);
+    CHECK(out_len == from, "step mode played without a key or clock");
+    key_on(12 * step, 60);
+    run_until(13 * step);
+    CHECK(note_ons(from, NULL, NULL, EVENTS_MAX) == 1, "step mode did not start on the key");
+
+    // All notes off and reset all controllers let go of the held keys, and go on to the engine
+    const uint8_t controllers[] = {SYNTH_CC_ALL_NOTES_OFF, SYNTH_CC_RESET_CONTROLLERS};
+    for (size_t i = 0; i < sizeof(controllers); ++i)
+    {
+        reset(SEQUENCER_ARP_UP);
+        key_on(0, 60);
+        key_on(0, 64);
+        run_until(step + 1);
+        CHECK(!input(step + 1, SYNTH_CMD_CONTROL_CHANGE, controllers[i], 0), "controller %d kept from the engine",
+            controllers[i]);
+        run_until(8 * step);
+        CHECK(note_ons(0, NULL, NULL, EVENTS_MAX) == 2, "controller %d: %zu steps, 2 expected", controllers[i],
+            note_ons(0, NULL, NULL, EVENTS_MAX));
+        gates_closed(0, 0);
+    }
+}
+
+/**
+ * @brief Steps land on every sixth clock, and wait for it across stop and continue
+ */
+static void check_clock(void)
+{
+    const uint32_t period = RATE_HZ * 60 / (SEQUENCER_CLOCKS_PER_BEAT * CLOCK_BPM);
+    const uint32_t start = MS(100);
+    static uint32_t times[EVENTS_MAX];
+    uint32_t t = start;
+
+    reset(SEQUENCER_ARP_UP);
+    key_on(0, 60);
+    key_on(0, 64);
+    clock_at(start, SEQUENCER_RT_START);
+    size_t from = out_len; // The first step played on the internal tempo
+
+    for (int tick = 0; tick < 4 * SEQUENCER_CLOCKS_PER_BEAT; ++tick, t += period) clock_at(t, SEQUENCER_RT_CLOCK);
+    run_until(t);
+
+    size_t count = note_ons(from, times, NULL, EVENTS_MAX);
+    CHECK(count == 4 * STEPS_PER_BEAT, "%zu steps in 4 beats of clock", count);
+    for (size_t k = 0; k < count; ++k)
+        CHECK(times[k] == start + k * CLOCKS_PER_STEP * period, "step %zu at %lu, on clock %lu expected", k,
+            (unsigned long)times[k], (unsigned long)(start + k * CLOCKS_PER_STEP * period));
+
+    // The first step has no clock period measured yet, its gate is on the internal tempo
+    gates_closed(from, 0);
+    for (size_t i = from + 2; i + 1 < out_len; i += 2)
+        CHECK(out[i + 1].time - out[i].time == period * CLOCKS_PER_STEP * GATE_PCT / 100,
+            "note at %lu held %lu samples on the clock", (unsigned long)out[i].time,
+            (unsigned long)(out[i + 1].time - out[i].time));
+
+    // Stop inside a step: clock goes on without steps, the sounding note ends at once
+    clock_at(t, SEQUENCER_RT_CLOCK);
+    t += period;
+    clock_at(t, SEQUENCER_RT_STOP);
+    run_until(t + 1);
+    CHECK(out_len > 0 && out[out_len - 1].cmd.type == SYNTH_CMD_NOTE_OFF && out[out_len - 1].time == t,
+        "last note not released on stop");
+    from = out_len;
+    for (int tick = 0; tick < SEQUENCER_CLOCKS_PER_BEAT; ++tick, t += period) clock_at(t, SEQUENCER_RT_CLOCK);
+    run_until(t);
+    CHECK(out_len == from, "%zu events while stopped", out_len - from);
+
+    // Continue: the step cut by the stop one clock in resumes where it was,
+    // the next one is due after the rest of its clocks
+    clock_at(t + period / 2, SEQUENCER_RT_CONTINUE);
+    t += period;
+    uint32_t resumed = t + (CLOCKS_PER_STEP - 1) * period;
+    for (int tick = 0; tick < SEQUENCER_CLOCKS_PER_BEAT; ++tick, t += period) clock_at(t, SEQUENCER_RT_CLOCK);
+    run_until(t);
+    count = note_ons(from, times, NULL, EVENTS_MAX);
+    CHECK(count == STEPS_PER_BEAT && times[0] == resumed,
+        "%zu steps after continue, first at %lu, %lu expected", count, (unsigned long)times[0], (unsigned long)resumed);
+}
+
+/**
+ * @brief Half a second without clock falls back to the internal tempo
+ *
+ * Running, the held keys go on by themselves from the timeout. Stopped, they
+ * wait for the next key, which starts the internal tempo at once.
+ */
+static void check_clock_timeout(void)
+{
+    const uint32_t period = RATE_HZ * 60 / (SEQUENCER_CLOCKS_PER_BEAT * CLOCK_BPM);
+    const uint32_t step = RATE_HZ * 60 / (CONFIG_INTERRUPTER_SYNTH_SEQ_BPM * STEPS_PER_BEAT);
+    static uint32_t times[EVENTS_MAX];
+
+    for (int stopped = 0; stopped < 2; ++stopped)
+    {
+        uint32_t t = MS(100);
+
+        reset(SEQUENCER_ARP_UP);
+        key_on(0, 60);
+        key_on(0, 64);
+        clock_at(t, SEQUENCER_RT_START);
+        for (int tick = 0; tick < SEQUENCER_CLOCKS_PER_BEAT; ++tick, t += period) clock_at(t, SEQUENCER_RT_CLOCK);
+        uint32_t lost = t - period + CLOCK_TIMEOUT + 1;
+        if (stopped) clock_at(t, SEQUENCER_RT_STOP);
+        run_until(t);
+
+        size_t from = out_len;
+        run_until(lost + 2 * step);
+        size_t count = note_ons(from, times, NULL, EVENTS_MAX);
+
+        if (!stopped)
+        {
+            CHECK(count == 2 && times[0] == lost && times[1] == lost + step,
+                "%zu steps after the clock went silent, first at %lu, %lu expected", count,
+                (unsigned long)(count ? times[0] : 0), (unsigned long)lost);
+            continue;
+        }
+
+        CHECK(count == 0, "%zu steps while stopped with no clock", count);
+        uint32_t key = now;
+        key_on(key, 67);
+        run_until(key + 1);
+        count = note_ons(from, times, NULL, EVENTS_MAX);
+        CHECK(count == 1 && times[0] == key, "%zu steps on the key after the clock stopped, first at %lu", count,
+            (unsigned long)(count ? times[0] : 0));
+    }
+}
+
+/**
+ * @brief Drum channel notes go on to the engine in every mode
+ */
+static void check_drums(void)
+{
+    synth_cmd_t on = {.type = SYNTH_CMD_NOTE_ON, .channel = SYNTH_PERCUSSION_CHANNEL, .data1 = DRUM_CODE, .data2 = 100};
+    synth_cmd_t off = {.type = SYNTH_CMD_NOTE_OFF, .channel = SYNTH_PERCUSSION_CHANNEL, .data1 = DRUM_CODE};
+
+    for (sequencer_mode_t mode = SEQUENCER_ARP_UP; mode < SEQUENCER_MODE_COUNT; ++mode)
+    {
+        reset(mode);
+        CHECK(!sequencer_input(&on, 0), "mode %d: drum note-on taken", mode);
+        run_until(MS(100));
+        CHECK(!sequencer_input(&off, MS(100)), "mode %d: drum note-off taken", mode);
+        run_until(MS(500));
+        CHECK(out_len == 0, "mode %d: %zu events from a drum note", mode, out_len);
+
+        // Keys of the other channels are still taken
+        CHECK(key_on(MS(500), 60), "mode %d: key taken no more after a drum note", mode);
+    }
+}
+
+/**
+ * @brief Under jittered clock, steps stay on their tick and gates near the ideal
+ *
+ * Ticks come up to JITTER early or late around an ideal grid, as over USB.
+ * Steps land on the tick that carries them, so no further from the grid than
+ * the jitter, and the smoothed clock period keeps gates close to the ideal.
+ */
+static void check_jitter(void)
+{
+    const uint32_t period = RATE_HZ * 60 / (SEQUENCER_CLOCKS_PER_BEAT * CLOCK_BPM);
+    const uint32_t start = MS(100);
+    const int ticks = 64 * SEQUENCER_CLOCKS_PER_BEAT;
+    const double gate = (double)period * CLOCKS_PER_STEP * GATE_PCT / 100;
+    static uint32_t times[EVENTS_MAX];
+    uint32_t seed = 12345;
+    int32_t worst_step = 0;
+    double worst_gate = 0;
+
+    reset(SEQUENCER_ARP_UP);
+    key_on(0, 60);
+    clock_at(start, SEQUENCER_RT_START);
+    size_t from = out_len;
+
+    for (int tick = 0; tick < ticks; ++tick)
+    {
+        seed = seed * 1103515245 + 12345;
+        int32_t jitter = tick ? (int32_t)(seed >> 16) % (2 * JITTER + 1) - JITTER : 0;
+        clock_at(start + tick * period + jitter, SEQUENCER_RT_CLOCK);
+    }
+    run_until(start + ticks * period + period);
+
+    size_t count = note_ons(from, times, NULL, EVENTS_MAX);
+    CHECK(count == ticks / CLOCKS_PER_STEP, "%zu steps for %d clocks", count, ticks);
+    for (size_t k = 0; k < count; ++k)
+    {
+        int32_t error = (int32_t)(times[k] - (start + k * CLOCKS_PER_STEP * period));
+        CHECK(abs(error) <= JITTER, "step %zu %ld samples off the grid", k, (long)error);
+        if (abs(error) > worst_step) worst_step = abs(error);
+    }
+
+    // Past the first beat, the smoothing has settled
+    for (size_t i = from; i + 1 < out_len; ++i)
+    {
+        if (out[i].cmd.type != SYNTH_CMD_NOTE_ON || out[i].time < start + SEQUENCER_CLOCKS_PER_BEAT * period) continue;
+
+        double error = ((double)(out[i + 1].time - out[i].time) - gate) / gate;
+        CHECK(out[i + 1].cmd.type == SYNTH_CMD_NOTE_OFF && fabs(error) <= JITTER_GATE_TOL,
+            "gate at %lu of %lu samples, %.0f ideal", (unsigned long)out[i].time,
+            (unsigned long)(out[i + 1].time - out[i].time), gate);
+        if (fabs(error) > worst_gate) worst_gate = fabs(error);
+    }
+
+    printf("clock jitter of %d samples: steps within %ld samples of the grid, gates within %.1f%%\n", JITTER,
+        (long)worst_step, 100 * worst_gate);
+}
+
+static void on_sampling_cb(uint16_t value)
+{
+    if (drained < sizeof(played) / sizeof(played[0])) played[drained] = value;
+    drained++;
+}
+
+static void play_until(uint32_t clock)
+{
+    while (drained < clock)
+    {
+        host_timer_fire();
+        host_rtos_wait_idle();
+    }
+}
+
+static bool sounds_at(uint32_t time, uint32_t len)
+{
+    for (uint32_t n = time; n < time + len; ++n)
+        if (played[n] != SYNTH_OUT_SILENCE) return true;
+
+    return false;
+}
+
+/**
+ * @brief Through the synth: keys and controllers in the order the reports came in
+ *
+ *     0   on 1 60 100
+ *     100 cc 1 3 40
+ *     200 off 1 60
+ *
+ * then an arpeggio cut by all notes off. Both must end in silence.
+ */
+static void check_hanging(void)
+{
+    const synth_note_t c4 = {.octave = 3, .note = 0};
+    uint32_t t0 = drained;
+
+    synth_play_note(c4, CHANNEL, 100);
+    play_until(t0 + MS(100));
+    synth_control_change(CHANNEL, SEQUENCER_CC_MODE, 40);
+    play_until(t0 + MS(200));
+    synth_stop_note(c4, CHANNEL);
+    play_until(t0 + MS(200) + GAP);
+
+    CHECK(sounds_at(t0 + MS(150), MS(10)), "note pressed while off not playing");
+    CHECK(!sounds_at(drained - MS(10), MS(10)), "note pressed while off hangs after the mode change");
+
+    t0 = drained;
+    synth_play_note(c4, CHANNEL, 100);
+    play_until(t0 + MS(300));
+    synth_control_change(CHANNEL, SYNTH_CC_ALL_NOTES_OFF, 0);
+    play_until(t0 + MS(300) + GAP);
+
+    CHECK(sounds_at(t0, MS(300)), "arpeggio not playing");
+    CHECK(!sounds_at(drained - MS(10), MS(10)), "arpeggio goes on after all notes off");
+    synth_control_change(CHANNEL, SEQUENCER_CC_MODE, 0);
+    play_until(drained + GAP);
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    // The synth first, the checks after it drive the sequencer directly
+    if (synth_init() != ESP_OK) return 1;
+    synth_set_on_sampling_cb(on_sampling_cb);
+    host_rtos_wait_idle();
+    synth_enable();
+    play_until(SYNTH_BLOCK_COUNT * SYNTH_BLOCK_SIZE);
+    check_hanging();
+
+    check_step_timing();
+    check_orders();
+    check_modes();
+    check_clock();
+    check_clock_timeout();
+    check_jitter();
+    check_drums();
+
+    return host_check_report("sequencer_check");
+}
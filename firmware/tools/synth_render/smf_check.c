@@ -0,0 +1,478 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file smf_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "core/smf.h"
+#include "host_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: smf_check [file.mid...]\n"                                                                                 \
+    "\n"                                                                                                               \
+    "Builds MIDI files in memory and checks the events the reader returns:\n"                                          \
+    "running status, type 1 tracks merged as their type 0 equivalent, tempo\n"                                         \
+    "and time signature changes, SMPTE divisions, and truncated or corrupt\n"                                          \
+    "files that must stop the reader without reading past their end.\n"                                               \
+    "\n"                                                                                                               \
+    "Given files instead, reads each one through to its end over and over and\n"                                      \
+    "prints how many events per second of host time the reader returns.\n"
+
+#define RATE_HZ 16000
+#define FILE_MAX 4096
+#define EVENTS_MAX 512
+#define PARSE_NS_MIN 2e8 // Host time each file is read for
+
+#define NOTE_ON 0x90
+#define NOTE_OFF 0x80
+#define CONTROL 0xB0
+#define PROGRAM 0xC0
+
+// Byte lists, appended to the file being built
+#define PUT(...) put((const uint8_t[]){__VA_ARGS__}, sizeof((const uint8_t[]){__VA_ARGS__}))
+#define TEMPO(us) 0xFF, 0x51, 0x03, (uint8_t)((us) >> 16), (uint8_t)((us) >> 8), (uint8_t)(us)
+#define END_OF_TRACK 0xFF, 0x2F, 0x00
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t tick;
+    uint32_t tempo_us;
+} tempo_change_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static uint8_t file[FILE_MAX];
+static size_t file_len = 0;
+static size_t track_start = 0;
+
+static smf_t smf;
+static smf_event_t events[EVENTS_MAX];
+static smf_event_t expected[EVENTS_MAX];
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void put(const uint8_t *bytes, size_t len)
+{
+    memcpy(file + file_len, bytes, len);
+    file_len += len;
+}
+
+static void put_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+/**
+ * @brief Start a new file, the division as stored in the header
+ */
+static void begin_file(uint16_t format, uint16_t tracks, uint16_t division)
+{
+    file_len = 0;
+    PUT('M', 'T', 'h', 'd', 0, 0, 0, 6, format >> 8, format, tracks >> 8, tracks, division >> 8, division);
+}
+
+static void begin_track(void)
+{
+    PUT('M', 'T', 'r', 'k', 0, 0, 0, 0);
+    track_start = file_len;
+}
+
+static void end_track(void) { put_be32(file + track_start - 4, file_len - track_start); }
+
+/**
+ * @brief Open the file built and read all of its events
+ */
+static size_t read_all(size_t size)
+{
+    size_t count = 0;
+
+    if (!CHECK(smf_open(&smf, file, size, RATE_HZ) == ESP_OK, "file of %zu bytes not opened", size)) return 0;
+    while (count < EVENTS_MAX && smf_next(&smf, &events[count])) count++;
+
+    return count;
+}
+
+static bool same_event(const smf_event_t *a, const smf_event_t *b)
+{
+    return a->time == b->time && a->status == b->status && a->data1 == b->data1 && a->data2 == b->data2;
+}
+
+static void check_events(const char *what, size_t count, const smf_event_t *want, size_t want_count)
+{
+    if (!CHECK(count == want_count, "%s: %zu events, %zu expected", what, count, want_count)) return;
+
+    for (size_t i = 0; i < count; ++i)
+        CHECK(same_event(&events[i], &want[i]), "%s: event %zu is %02X %d %d at %lu, %02X %d %d at %lu expected", what,
+            i, events[i].status, events[i].data1, events[i].data2, (unsigned long)events[i].time, want[i].status,
+            want[i].data1, want[i].data2, (unsigned long)want[i].time);
+}
+
+/**
+ * @brief Events per second of host time of reading a file to its end
+ */
+static double parse_rate(const uint8_t *data, size_t size, size_t *count)
+{
+    smf_event_t event;
+    double start = host_check_now_ns(), elapsed = 0;
+    uint64_t total = 0;
+
+    *count = 0;
+    if (smf_open(&smf, data, size, RATE_HZ) != ESP_OK) return 0;
+    while (smf_next(&smf, &event)) ++*count;
+    if (*count == 0) return 0;
+
+    do
+    {
+        smf_rewind(&smf);
+        while (smf_next(&smf, &event)) total++;
+        elapsed = host_check_now_ns() - start;
+    } while (elapsed < PARSE_NS_MIN);
+
+    return total * 1e9 / elapsed;
+}
+
+static void check_parse_rate(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!CHECK(f, "%s: not opened", path)) return;
+
+    fseek(f, 0, SEEK_END);
+    size_t size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = malloc(size ? size : 1);
+    bool read = data && fread(data, 1, size, f) == size;
+    fclose(f);
+
+    size_t count = 0;
+    double rate = read ? parse_rate(data, size, &count) : 0;
+    if (CHECK(read, "%s: not read", path) && CHECK(count > 0, "%s: no events read", path))
+        printf("%s: %zu bytes, %zu events, %.0f events per second (host time)\n", path, size, count, rate);
+    free(data);
+}
+
+/**
+ * @brief Sample of a tick through a tempo map, rounded down once at the end
+ */
+static uint32_t samples_at(const tempo_change_t *map, size_t len, uint16_t division, uint32_t tick)
+{
+    uint64_t sum = 0; // Tick microseconds times the division
+
+    for (size_t i = 0; i < len && map[i].tick < tick; ++i)
+    {
+        uint32_t end = i + 1 < len && map[i + 1].tick < tick ? map[i + 1].tick : tick;
+        sum += (uint64_t)(end - map[i].tick) * map[i].tempo_us;
+    }
+
+    return sum * RATE_HZ / ((uint64_t)division * 1000000);
+}
+
+/**
+ * @brief Data bytes without their status take the one before
+ */
+static void check_running_status(void)
+{
+    begin_file(0, 1, 96);
+    begin_track();
+    PUT(0x00, NOTE_ON, 60, 100);
+    PUT(0x00, 64, 100);                // Running note on
+    PUT(0x60, 60, 0);                  // Running, velocity 0
+    PUT(0x00, CONTROL, 7, 80);
+    PUT(0x00, PROGRAM | 1, 5);
+    PUT(0x10, 34);                     // Running, one data byte
+    PUT(0x00, 0xF0, 0x02, 0x7E, 0xF7); // Sysex, skipped
+    PUT(0x00, NOTE_OFF, 64, 0);
+    PUT(0x00, END_OF_TRACK);
+    end_track();
+
+    // 96 ticks at 120 BPM are half a second, 112 ticks 9333.3 samples
+    const smf_event_t want[] = {
+        {0, NOTE_ON, 60, 100},
+        {0, NOTE_ON, 64, 100},
+        {8000, NOTE_ON, 60, 0},
+        {8000, CONTROL, 7, 80},
+        {8000, PROGRAM | 1, 5, 0},
+        {9333, PROGRAM | 1, 34, 0},
+        {9333, NOTE_OFF, 64, 0},
+    };
+    check_events("running status", read_all(file_len), want, sizeof(want) / sizeof(want[0]));
+}
+
+/**
+ * @brief Three tracks: a tempo map and two overlapping parts
+ */
+static void build_type1(void)
+{
+    begin_file(1, 3, 96);
+    begin_track();
+    PUT(0x00, TEMPO(400000));
+    PUT(0x48, TEMPO(600000)); // Tick 72
+    PUT(0x00, END_OF_TRACK);
+    end_track();
+    begin_track();
+    PUT(0x00, NOTE_ON, 60, 100);
+    PUT(0x60, NOTE_OFF, 60, 0); // Tick 96
+    PUT(0x00, NOTE_ON | 2, 67, 90);
+    PUT(0x00, END_OF_TRACK);
+    end_track();
+    begin_track();
+    PUT(0x00, NOTE_ON | 1, 64, 80);       // Same tick as the first note, after it
+    PUT(0x30, NOTE_OFF | 1, 64, 0);       // Tick 48
+    PUT(0x30, NOTE_ON | 1, 65, 80);       // Tick 96, after the first track
+    PUT(0x83, 0x00, NOTE_OFF | 1, 65, 0); // Tick 480
+    PUT(0x00, END_OF_TRACK);
+    end_track();
+}
+
+/**
+ * @brief Type 1 tracks come out as the type 0 file holding the same events
+ *
+ * Events on one tick keep the order of their tracks.
+ */
+static void check_merge(void)
+{
+    build_type1();
+    size_t count = read_all(file_len);
+    memcpy(expected, events, count * sizeof(events[0]));
+
+    begin_file(0, 1, 96);
+    begin_track();
+    PUT(0x00, TEMPO(400000));
+    PUT(0x00, NOTE_ON, 60, 100);
+    PUT(0x00, NOTE_ON | 1, 64, 80);
+    PUT(0x30, NOTE_OFF | 1, 64, 0);
+    PUT(0x18, TEMPO(600000));
+    PUT(0x18, NOTE_OFF, 60, 0);
+    PUT(0x00, NOTE_ON | 2, 67, 90);
+    PUT(0x00, NOTE_ON | 1, 65, 80);
+    PUT(0x83, 0x00, NOTE_OFF | 1, 65, 0);
+    PUT(0x00, END_OF_TRACK);
+    end_track();
+
+    const smf_event_t want[] = {
+        {0, NOTE_ON, 60, 100},
+        {0, NOTE_ON | 1, 64, 80},
+        {3200, NOTE_OFF | 1, 64, 0},
+        {7200, NOTE_OFF, 60, 0},
+        {7200, NOTE_ON | 2, 67, 90},
+        {7200, NOTE_ON | 1, 65, 80},
+        {45600, NOTE_OFF | 1, 65, 0},
+    };
+    check_events("type 1", count, want, sizeof(want) / sizeof(want[0]));
+    check_events("type 0", read_all(file_len), expected, count);
+
+    // Read again from the start
+    smf_rewind(&smf);
+    count = 0;
+    while (count < EVENTS_MAX && smf_next(&smf, &events[count])) count++;
+    check_events("rewound", count, want, sizeof(want) / sizeof(want[0]));
+}
+
+/**
+ * @brief Event times follow every tempo change with no rounding drift
+ *
+ * Notes every 7 ticks at 480 per quarter never land on a whole sample at
+ * these tempos, a time rounded per event would drift away over the song.
+ * The time signature changes to 3/4 on the way.
+ */
+static void check_tempo(void)
+{
+    const uint16_t division = 480;
+    const tempo_change_t map[] = {{0, 500000}, {480, 333333}, {1500, 1234567}, {2200, 250000}};
+    const int notes = 400;
+    size_t want_count = 0;
+
+    begin_file(1, 2, division);
+    begin_track();
+    PUT(0x00, TEMPO(500000));
+    PUT(0x83, 0x60, TEMPO(333333));           // Tick 480
+    PUT(0x00, 0xFF, 0x58, 0x04, 3, 2, 24, 8); // 3/4 from the second bar
+    PUT(0x87, 0x7C, TEMPO(1234567));          // Tick 1500
+    PUT(0x85, 0x3C, TEMPO(250000));           // Tick 2200
+    PUT(0x00, END_OF_TRACK);
+    end_track();
+    begin_track();
+    PUT(0x00, NOTE_ON, 60, 100);
+    for (int i = 1; i < notes; ++i) PUT(0x07, 60, i & 1 ? 0 : 100);
+    PUT(0x00, END_OF_TRACK);
+    end_track();
+
+    for (int i = 0; i < notes; ++i)
+    {
+        uint32_t tick = 7 * i;
+        expected[want_count++] =
+            (smf_event_t){samples_at(map, sizeof(map) / sizeof(map[0]), division, tick), NOTE_ON, 60, i & 1 ? 0 : 100};
+    }
+
+    if (!CHECK(smf_open(&smf, file, file_len, RATE_HZ) == ESP_OK, "tempo file not opened")) return;
+    size_t count = 0;
+    while (count < EVENTS_MAX && smf_next(&smf, &events[count]))
+    {
+        // A bar of 4/4 then bars of 3/4, from tick 480
+        uint32_t tick = 7 * count;
+        uint32_t want_bar = tick < 480 ? 1 : 2 + (tick - 480) / 1440;
+        uint8_t want_beat = tick < 480 ? 1 : (tick - 480) % 1440 / 480 + 1;
+        uint32_t bar;
+        uint8_t beat;
+
+        smf_position(&smf, &bar, &beat);
+        CHECK(bar == want_bar && beat == want_beat, "tick %lu at bar %lu beat %d, %lu %d expected",
+            (unsigned long)tick, (unsigned long)bar, beat, (unsigned long)want_bar, want_beat);
+        count++;
+    }
+    check_events("tempo map", count, expected, want_count);
+
+    printf("%d notes over 4 tempos, last at %lu samples\n", notes, (unsigned long)expected[want_count - 1].time);
+}
+
+/**
+ * @brief SMPTE divisions count ticks per second and ignore tempo events
+ */
+static void check_smpte(void)
+{
+    const struct
+    {
+        int8_t fps;
+        uint8_t ticks_per_frame;
+    } divisions[] = {{-24, 4}, {-25, 40}, {-29, 100}, {-30, 80}};
+
+    for (size_t i = 0; i < sizeof(divisions) / sizeof(divisions[0]); ++i)
+    {
+        uint32_t per_second = -divisions[i].fps * divisions[i].ticks_per_frame;
+        char what[32];
+
+        begin_file(0, 1, (uint8_t)divisions[i].fps << 8 | divisions[i].ticks_per_frame);
+        begin_track();
+        PUT(0x00, NOTE_ON, 60, 100);
+        PUT(0x00, TEMPO(250000));
+        PUT(0x03, NOTE_OFF, 60, 0);  // 3 ticks
+        PUT(0x7F, NOTE_ON, 62, 100); // 130 ticks
+        PUT(0x00, END_OF_TRACK);
+        end_track();
+
+        const smf_event_t want[] = {
+            {0, NOTE_ON, 60, 100},
+            {3 * RATE_HZ / per_second, NOTE_OFF, 60, 0},
+            {130 * RATE_HZ / per_second, NOTE_ON, 62, 100},
+        };
+        snprintf(what, sizeof(what), "SMPTE %d x %d", -divisions[i].fps, divisions[i].ticks_per_frame);
+        check_events(what, read_all(file_len), want, sizeof(want) / sizeof(want[0]));
+    }
+}
+
+/**
+ * @brief A track ending inside an event stops there, on the events before it
+ */
+static void check_truncated_track(const char *what, const uint8_t *tail, size_t len)
+{
+    begin_file(0, 1, 96);
+    begin_track();
+    PUT(0x00, NOTE_ON, 60, 100);
+    put(tail, len);
+    end_track();
+    PUT('M', 'T', 'r', 'k', 0, 0, 0, 4, 0x00, NOTE_ON, 61, 100); // Past the counted tracks, never read
+
+    const smf_event_t want[] = {{0, NOTE_ON, 60, 100}};
+    check_events(what, read_all(file_len), want, 1);
+    CHECK(!smf_next(&smf, &events[0]), "%s: events past the end", what);
+}
+
+/**
+ * @brief Cut files and corrupt headers are refused, cut events end their track
+ */
+static void check_truncated(void)
+{
+    build_type1();
+    size_t full = file_len;
+
+    CHECK(smf_file_size(file, full) == full, "complete file sized %zu", smf_file_size(file, full));
+    CHECK(smf_file_size(file, full + 100) == full, "file followed by data sized %zu", smf_file_size(file, full + 100));
+    for (size_t size = 0; size < full; ++size)
+    {
+        CHECK(smf_file_size(file, size) == 0, "file cut to %zu bytes sized", size);
+        CHECK(smf_open(&smf, file, size, RATE_HZ) == ESP_ERR_INVALID_ARG, "file cut to %zu bytes opened", size);
+    }
+
+    // Header fields
+    file[9] = 2;
+    CHECK(smf_open(&smf, file, full, RATE_HZ) == ESP_ERR_NOT_SUPPORTED, "type 2 file opened");
+    file[9] = 1;
+    file[12] = file[13] = 0;
+    CHECK(smf_open(&smf, file, full, RATE_HZ) == ESP_ERR_INVALID_ARG, "division 0 opened");
+    file[13] = 96;
+    CHECK(smf_open(&smf, file, full, 0) == ESP_ERR_INVALID_ARG, "rate 0 opened");
+    file[7] = 5;
+    CHECK(smf_file_size(file, full) == 0, "header of 5 bytes sized");
+    file[7] = 6;
+    file[0] = 'm';
+    CHECK(smf_file_size(file, full) == 0, "bad magic sized");
+
+    check_truncated_track("cut note", (const uint8_t[]){0x60, NOTE_OFF, 60}, 3);
+    check_truncated_track("cut running note", (const uint8_t[]){0x60, 60}, 2);
+    check_truncated_track("cut delta", (const uint8_t[]){0x81}, 1);
+    check_truncated_track("delta past 4 bytes", (const uint8_t[]){0x81, 0x81, 0x81, 0x81, 0x01, 0x90, 60, 0}, 8);
+    check_truncated_track("cut meta", (const uint8_t[]){0x00, 0xFF, 0x01, 0x7F, 'a'}, 5);
+    check_truncated_track("cut meta type", (const uint8_t[]){0x00, 0xFF}, 2);
+    check_truncated_track("cut sysex", (const uint8_t[]){0x00, 0xF0, 0x05, 0x7E}, 4);
+    check_truncated_track("system common", (const uint8_t[]){0x00, 0xF2, 0x00, 0x00}, 4);
+    check_truncated_track("running status after sysex", (const uint8_t[]){0x00, 0xF0, 0x01, 0xF7, 0x00, 60, 0}, 7);
+    check_truncated_track("no end of track", (const uint8_t[]){0}, 0);
+
+    // Data without any status first
+    begin_file(0, 1, 96);
+    begin_track();
+    PUT(0x00, 60, 100, 0x00, NOTE_ON, 60, 100);
+    end_track();
+    CHECK(read_all(file_len) == 0, "data bytes read without a status");
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc > 1 && argv[1][0] == '-')
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    if (argc > 1)
+    {
+        for (int i = 1; i < argc; ++i) check_parse_rate(argv[i]);
+        return host_check_report("smf_check");
+    }
+
+    check_running_status();
+    check_merge();
+    check_tempo();
+    check_smpte();
+    check_truncated();
+
+    return host_check_report("smf_check");
+}
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file soft_clip_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/mixer.h"
+#include "dsp/synth_engine.h"
+#include "host_check.h"
+#include "sdkconfig.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: soft_clip_check\n"                                                                                         \
+    "\n"                                                                                                               \
+    "Sweeps every voice sum through the soft-clip curve of the mixer: exact\n"                                        \
+    "gain below the knee, monotonic, odd, never above the linear gain and\n"                                           \
+    "bounded to full scale, and prints the level of chords at full scale.\n"                                          \
+    "The divide-by-voice-count and clamp the synth mixed with before is kept\n"                                       \
+    "as the reference: chord and single voice levels of both are printed, with\n"                                     \
+    "the host time per sample of each.\n"
+
+#define FULL_SCALE 32767
+#define LINEAR_LSB_MAX 1.5 // Curve entries are rounded, the interpolation floors
+#define SYMMETRY_LSB_MAX 1 // Floor of the interpolation on each side
+
+#define BENCH_LEN 4096
+#define BENCH_REPEATS 200
+#define BENCH_RUNS 5 // Best of, against scheduling noise
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint8_t voices;
+    uint16_t gain_pct;
+} setup_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const setup_t setups[] = {
+    {SYNTH_MAX_CHORD_SIZE, CONFIG_INTERRUPTER_SYNTH_VOICE_GAIN_PCT},
+    {SYNTH_MAX_CHORD_SIZE, 100},
+    {32, 50},
+    {1, 100},
+    {4, 1},
+};
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief Mixer output of one sum, centered on 0
+ */
+static int32_t clip(int32_t sum)
+{
+    uint16_t out;
+    mixer_process(&sum, &out, 1);
+
+    return (int32_t)out - FULL_SCALE;
+}
+
+/**
+ * @brief The mix the synth had before the soft clip: the sum over the voices
+ * sounding, clamped
+ */
+static void old_process(const int32_t *sum, uint16_t *out, size_t len, uint8_t voices)
+{
+    for (size_t n = 0; n < len; ++n)
+    {
+        int32_t mixed = sum[n] / voices;
+        if (mixed > FULL_SCALE)
+            mixed = FULL_SCALE;
+        else if (mixed < -FULL_SCALE - 1)
+            mixed = -FULL_SCALE - 1;
+        out[n] = (uint16_t)(mixed + FULL_SCALE);
+    }
+}
+
+static int32_t old_clip(int32_t sum, uint8_t voices)
+{
+    uint16_t out;
+    old_process(&sum, &out, 1, voices);
+
+    return (int32_t)out - FULL_SCALE;
+}
+
+static double dbfs(int32_t y) { return 20 * log10((double)y / FULL_SCALE); }
+
+static void check_setup(const setup_t *s)
+{
+    double gain = s->gain_pct / 100.0;
+    int32_t range = s->voices * (FULL_SCALE + 1); // Every voice at full scale, the end of the curve
+    int32_t step = 2 * range >> MIXER_CURVE_BITS;  // Sums between two curve entries for these voice counts
+    int32_t knee = (int32_t)(MIXER_KNEE_PCT / 100.0 * (FULL_SCALE + 1) / gain);
+    if (knee > range) knee = range;
+    unsigned long nonlinear = 0, reversed = 0, asymmetric = 0, louder = 0, out_of_range = 0;
+
+    mixer_init(s->voices, s->gain_pct);
+
+    CHECK(clip(0) == 0, "%d voices at %d%%: silence is %ld", s->voices, s->gain_pct, (long)clip(0));
+
+    // Twice past the end of the curve, where sums are clamped
+    int32_t prev = clip(-2 * range);
+    for (int32_t sum = -2 * range; sum <= 2 * range; ++sum)
+    {
+        int32_t y = clip(sum);
+        int32_t clamped = sum < -range ? -range : sum > range ? range : sum;
+        double linear = clamped * gain * FULL_SCALE / (FULL_SCALE + 1);
+
+        // One curve step under the knee, the segment across it bends
+        if (abs(sum) < knee - step && fabs(y - linear) > LINEAR_LSB_MAX) nonlinear++;
+        if (y < prev) reversed++;
+        if (abs(y + clip(-sum)) > SYMMETRY_LSB_MAX) asymmetric++;
+        if (sum > 0 ? y > linear + LINEAR_LSB_MAX : y < linear - LINEAR_LSB_MAX) louder++;
+        if (y > FULL_SCALE || y < -FULL_SCALE) out_of_range++;
+        prev = y;
+    }
+
+    CHECK(nonlinear == 0, "%d voices at %d%%: %lu sums under the knee off the gain", s->voices, s->gain_pct,
+        nonlinear);
+    CHECK(reversed == 0, "%d voices at %d%%: %lu sums louder than the next one", s->voices, s->gain_pct, reversed);
+    CHECK(asymmetric == 0, "%d voices at %d%%: %lu sums not odd", s->voices, s->gain_pct, asymmetric);
+    CHECK(louder == 0, "%d voices at %d%%: %lu sums above the linear gain", s->voices, s->gain_pct, louder);
+    CHECK(out_of_range == 0, "%d voices at %d%%: %lu sums past full scale", s->voices, s->gain_pct, out_of_range);
+
+    // Sums past every voice at full scale hold at the end of the curve
+    CHECK(clip(INT32_MAX / 2) == clip(range) && clip(-INT32_MAX / 2) == clip(-range),
+        "%d voices at %d%%: sums past the curve move", s->voices, s->gain_pct);
+}
+
+/**
+ * @brief Peak of chords of in-phase voices at full scale, at the configured gain
+ */
+static void print_headroom(void)
+{
+    mixer_init(SYNTH_MAX_CHORD_SIZE, CONFIG_INTERRUPTER_SYNTH_VOICE_GAIN_PCT);
+
+    printf("knee at %.2f voices at full scale, gain %d%%\n",
+        MIXER_KNEE_PCT / (double)CONFIG_INTERRUPTER_SYNTH_VOICE_GAIN_PCT, CONFIG_INTERRUPTER_SYNTH_VOICE_GAIN_PCT);
+    for (int voices = 1; voices <= SYNTH_MAX_CHORD_SIZE; voices *= 2)
+    {
+        int32_t y = clip(voices * FULL_SCALE);
+        printf("%2d voices: peak %5ld, %6.2f dBFS\n", voices, (long)y, 20 * log10((double)y / FULL_SCALE));
+    }
+
+    // One voice keeps the 6 dB of headroom the gain gives it
+    int32_t one = clip(FULL_SCALE);
+    CHECK(fabs(one - FULL_SCALE * CONFIG_INTERRUPTER_SYNTH_VOICE_GAIN_PCT / 100.0) <= LINEAR_LSB_MAX,
+        "one voice at full scale peaks at %ld", (long)one);
+}
+
+/**
+ * @brief Levels against the old mix, the chord at full scale and one voice of it
+ *
+ * The old mix put every chord at full scale and took each voice down by the
+ * count of the ones sounding, so a held note dropped as others were added.
+ */
+static void print_old_levels(void)
+{
+    mixer_init(SYNTH_MAX_CHORD_SIZE, CONFIG_INTERRUPTER_SYNTH_VOICE_GAIN_PCT);
+
+    printf("voices   chord old    new   one voice old    new (dBFS)\n");
+    for (int voices = 1; voices <= SYNTH_MAX_CHORD_SIZE; voices *= 2)
+    {
+        int32_t old_chord = old_clip(voices * FULL_SCALE, voices), chord = clip(voices * FULL_SCALE);
+        int32_t old_one = old_clip(FULL_SCALE, voices), one = clip(FULL_SCALE);
+
+        CHECK(old_chord == FULL_SCALE && old_one == FULL_SCALE / voices,
+            "old mix of %d voices: chord %ld, one voice %ld", voices, (long)old_chord, (long)old_one);
+        printf("%6d   %9.2f %6.2f   %13.2f %6.2f\n", voices, dbfs(old_chord), dbfs(chord), dbfs(old_one), dbfs(one));
+    }
+}
+
+/**
+ * @brief Host time per sample of both mixes over sums of a full chord
+ */
+static void print_cost(void)
+{
+    static int32_t sums[BENCH_LEN];
+    static uint16_t out[BENCH_LEN];
+    static volatile uint8_t voices = SYNTH_MAX_CHORD_SIZE; // Not a constant to divide by, as on the board
+    static volatile uint32_t sink;
+    double best = 0, old_best = 0;
+
+    mixer_init(SYNTH_MAX_CHORD_SIZE, CONFIG_INTERRUPTER_SYNTH_VOICE_GAIN_PCT);
+    srand(1);
+    for (size_t n = 0; n < BENCH_LEN; ++n)
+        sums[n] = (int32_t)((rand() / (double)RAND_MAX * 2 - 1) * SYNTH_MAX_CHORD_SIZE * FULL_SCALE);
+
+    for (int run = 0; run < BENCH_RUNS; ++run)
+    {
+        double t0 = host_check_now_ns();
+        for (int r = 0; r < BENCH_REPEATS; ++r)
+        {
+            mixer_process(sums, out, BENCH_LEN);
+            sink += out[r];
+        }
+        double t1 = host_check_now_ns();
+        for (int r = 0; r < BENCH_REPEATS; ++r)
+        {
+            old_process(sums, out, BENCH_LEN, voices);
+            sink += out[r];
+        }
+        double t2 = host_check_now_ns();
+
+        double ns = (t1 - t0) / (BENCH_REPEATS * BENCH_LEN), old_ns = (t2 - t1) / (BENCH_REPEATS * BENCH_LEN);
+        if (run == 0 || ns < best) best = ns;
+        if (run == 0 || old_ns < old_best) old_best = old_ns;
+    }
+
+    printf("host time per sample: %.2f ns soft clip, %.2f ns old mix\n", best, old_best);
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    for (size_t i = 0; i < sizeof(setups) / sizeof(setups[0]); ++i) check_setup(&setups[i]);
+    print_headroom();
+    print_old_levels();
+    print_cost();
+
+    return host_check_report("soft_clip_check");
+}
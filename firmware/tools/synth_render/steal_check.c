@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file steal_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/synth_engine.h"
+#include "host_check.h"
+#include <stdio.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: steal_check\n"                                                                                             \
+    "\n"                                                                                                               \
+    "Fills every voice and strikes one more note under each steal policy,\n"                                          \
+    "then checks which note lost its voice.\n"
+
+#define VOICES SYNTH_MAX_CHORD_SIZE
+#define FIRST_CODE 40
+#define EXTRA_CODE 100 // The note that needs a voice
+#define QUIET_INDEX 7  // Neither the oldest nor the lowest
+#define SETTLE_SAMPLES (SYNTH_SAMPLING_RATE_HZ / 4) // Past the default attack and decay
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const char *policy_names[SYNTH_STEAL_COUNT] = {"oldest", "quietest", "lowest", "retrigger"};
+
+static int16_t scratch[SETTLE_SAMPLES];
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+/**
+ * @brief Code of the note struck in i-th position
+ *
+ * Descending after the first one, so the oldest is not the lowest.
+ */
+static uint8_t code_at(int i) { return i == 0 ? FIRST_CODE + VOICES : FIRST_CODE + VOICES - i; }
+
+static void fill(synth_steal_policy_t policy)
+{
+    synth_engine_init();
+    synth_engine_set_steal_policy(policy);
+
+    for (int i = 0; i < VOICES; ++i)
+        CHECK(synth_engine_note_on(code_at(i), 0, i == QUIET_INDEX ? 20 : 100) == ESP_OK, "%s: note %d refused",
+            policy_names[policy], code_at(i));
+
+    host_check_render(scratch, SETTLE_SAMPLES);
+    CHECK(synth_engine_active_voices() == VOICES, "%s: %d voices after filling", policy_names[policy],
+        synth_engine_active_voices());
+}
+
+/**
+ * @brief Strike one more note and check that only the victim's key is gone
+ */
+static void check_victim(synth_steal_policy_t policy, uint8_t victim, int released)
+{
+    synth_engine_stats_t stats;
+
+    CHECK(synth_engine_note_on(EXTRA_CODE, 0, 100) == ESP_OK, "%s: no voice for a new note", policy_names[policy]);
+    synth_engine_get_stats(&stats);
+    CHECK(stats.steals == 1, "%s: %lu steals", policy_names[policy], (unsigned long)stats.steals);
+    CHECK(synth_engine_active_voices() == VOICES, "%s: %d voices", policy_names[policy],
+        synth_engine_active_voices());
+
+    for (int i = 0; i < VOICES; ++i)
+    {
+        uint8_t code = code_at(i);
+        bool down = i != released && code != victim;
+        CHECK((synth_engine_note_off(code, 0) == ESP_OK) == down, "%s: note %d %s", policy_names[policy], code,
+            down ? "lost its voice" : "kept its voice");
+    }
+    CHECK(synth_engine_note_off(EXTRA_CODE, 0) == ESP_OK, "%s: new note not sounding", policy_names[policy]);
+}
+
+static void check_policies(void)
+{
+    uint8_t lowest = FIRST_CODE + 1;
+
+    fill(SYNTH_STEAL_OLDEST);
+    check_victim(SYNTH_STEAL_OLDEST, code_at(0), -1);
+
+    fill(SYNTH_STEAL_QUIETEST);
+    check_victim(SYNTH_STEAL_QUIETEST, code_at(QUIET_INDEX), -1);
+
+    fill(SYNTH_STEAL_LOWEST);
+    check_victim(SYNTH_STEAL_LOWEST, lowest, -1);
+
+    // A new note on full voices: RETRIGGER steals like OLDEST
+    fill(SYNTH_STEAL_RETRIGGER);
+    check_victim(SYNTH_STEAL_RETRIGGER, code_at(0), -1);
+}
+
+static void check_release_tails(void)
+{
+    for (synth_steal_policy_t policy = SYNTH_STEAL_OLDEST; policy < SYNTH_STEAL_COUNT; ++policy)
+    {
+        // Neither the oldest, the quietest nor the lowest, released it goes first
+        int released = 3;
+        fill(policy);
+        synth_engine_note_off(code_at(released), 0);
+        check_victim(policy, code_at(released), released);
+    }
+}
+
+static void check_retrigger(void)
+{
+    synth_engine_stats_t stats;
+
+    for (synth_steal_policy_t policy = SYNTH_STEAL_OLDEST; policy < SYNTH_STEAL_COUNT; ++policy)
+    {
+        synth_engine_init();
+        synth_engine_set_steal_policy(policy);
+
+        synth_engine_note_on(60, 0, 100);
+        synth_engine_note_on(60, 0, 100);
+        synth_engine_get_stats(&stats);
+
+        // Others let the first strike ring out in a voice of its own
+        bool retrigger = policy == SYNTH_STEAL_RETRIGGER;
+        CHECK(synth_engine_active_voices() == (retrigger ? 1 : 2), "%s: %d voices for a note struck twice",
+            policy_names[policy], synth_engine_active_voices());
+        CHECK(stats.retriggers == retrigger && stats.notes == 2 && stats.steals == 0,
+            "%s: %lu retriggers, %lu notes, %lu steals", policy_names[policy], (unsigned long)stats.retriggers,
+            (unsigned long)stats.notes, (unsigned long)stats.steals);
+
+        // One note-off is enough either way
+        CHECK(synth_engine_note_off(60, 0) == ESP_OK, "%s: note struck twice has no key", policy_names[policy]);
+        CHECK(synth_engine_note_off(60, 0) == ESP_ERR_INVALID_STATE, "%s: note struck twice has two keys",
+            policy_names[policy]);
+        host_check_render_until_idle(SYNTH_SAMPLING_RATE_HZ);
+        CHECK(synth_engine_active_voices() == 0, "%s: note struck twice is stuck", policy_names[policy]);
+    }
+
+    // Same code on another channel is another note, the policy set as the
+    // driver queues it
+    synth_cmd_t setting = {SYNTH_CMD_SETTING, 0, SYNTH_SETTING_STEAL_POLICY, SYNTH_STEAL_RETRIGGER};
+    synth_engine_init();
+    CHECK(synth_engine_apply(&setting) == ESP_OK, "steal policy setting refused");
+    synth_engine_note_on(60, 0, 100);
+    synth_engine_note_on(60, 1, 100);
+    synth_engine_get_stats(&stats);
+    CHECK(synth_engine_active_voices() == 2 && stats.retriggers == 0, "retrigger across channels");
+
+    synth_engine_note_on(60, 0, 100);
+    synth_engine_get_stats(&stats);
+    CHECK(stats.retriggers == 1, "steal policy setting not applied");
+
+    setting.data2 = SYNTH_STEAL_COUNT;
+    CHECK(synth_engine_apply(&setting) == ESP_ERR_INVALID_ARG, "unknown policy accepted");
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    check_policies();
+    check_release_tails();
+    check_retrigger();
+
+    return host_check_report("steal_check");
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file esp_check.h
+ * @brief Host stand-in for the ESP-IDF error checking macros
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#pragma once
+
+#include "esp_err.h"
+#include "esp_log.h"
+
+#define ESP_RETURN_ON_ERROR(x, tag, fmt, ...)                                                                          \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        esp_err_t err_rc_ = (x);                                                                                       \
+        if (err_rc_ != ESP_OK)                                                                                         \
+        {                                                                                                              \
+            ESP_LOGE(tag, "%s(%d): " fmt, __func__, __LINE__, ##__VA_ARGS__);                                          \
+            return err_rc_;                                                                                            \
+        }                                                                                                              \
+    } while (0)
+
+#define ESP_RETURN_ON_FALSE(a, err_code, tag, fmt, ...)                                                                \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(a))                                                                                                      \
+        {                                                                                                              \
+            ESP_LOGE(tag, "%s(%d): " fmt, __func__, __LINE__, ##__VA_ARGS__);                                          \
+            return err_code;                                                                                           \
+        }                                                                                                              \
+    } while (0)
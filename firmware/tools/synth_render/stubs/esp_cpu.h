@@ -0,0 +1,22 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file esp_cpu.h
+ * @brief Host stand-in for the CPU cycle counter
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Render thread CPU time scaled to CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ, so that the
+// load log of the firmware runs on the host. Not cycles of the target.
+uint32_t esp_cpu_get_cycle_count(void);
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file timing_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "hal/synth.h"
+#include "host_check.h"
+#include "host_rtos.h"
+#include "sdkconfig.h"
+#include <stdio.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: timing_check\n"                                                                                            \
+    "\n"                                                                                                               \
+    "Plays notes through the render task at every offset in a block and checks\n"                                      \
+    "that each starts on the sample synth_now() gave when it was queued: live,\n"                                      \
+    "scheduled after another event of the same block, late, and as pulses.\n"                                        \
+    "Then prints the host time per block of a full chord, built once for one\n"                                        \
+    "core and once for two so that both can be compared.\n"
+
+#define LEN (40 * SYNTH_SAMPLING_RATE_HZ)
+#define GAP (SYNTH_SAMPLING_RATE_HZ / 4) // Past the release, the next onset starts from silence
+#define ONSET_WINDOW (2 * SYNTH_BLOCK_SIZE)
+#define CHANNEL 0
+#define PULSE_WIDTH_US 20
+#define NO_PULSE UINT32_MAX
+#define COST_BLOCKS 2000
+
+#if CONFIG_INTERRUPTER_SYNTH_DUAL_CORE
+#define CORES_NAME "two cores"
+#else
+#define CORES_NAME "one core"
+#endif
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const synth_note_t note = {.octave = 3, .note = 9}; // A4, code 69
+
+static uint16_t played[LEN];
+static uint32_t drained = 0;
+static uint32_t first_pulse_us = NO_PULSE;
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static void on_sampling_cb(uint16_t value)
+{
+    if (drained < LEN) played[drained] = value;
+    drained++;
+}
+
+static void on_pulse_cb(const pulse_t *pulse)
+{
+    if (first_pulse_us == NO_PULSE) first_pulse_us = pulse->start;
+}
+
+/**
+ * @brief Drain samples until the play clock reaches the given sample
+ */
+static void play_until(uint32_t clock)
+{
+    while (drained < clock)
+    {
+        host_timer_fire();
+        host_rtos_wait_idle();
+    }
+}
+
+/**
+ * @brief Drain until events queued now land at the given offset in a block
+ */
+static void align(uint32_t offset)
+{
+    while (synth_now() % SYNTH_BLOCK_SIZE != offset) play_until(drained + 1);
+}
+
+/**
+ * @brief First sample from the given one that is not silence, LEN if none
+ */
+static uint32_t onset_from(uint32_t from)
+{
+    for (uint32_t n = from; n < drained && n < LEN; ++n)
+        if (played[n] != SYNTH_OUT_SILENCE) return n;
+
+    return LEN;
+}
+
+static void release(void)
+{
+    synth_stop_note(note, CHANNEL);
+    play_until(drained + GAP);
+    CHECK(played[drained - 1] == SYNTH_OUT_SILENCE, "note still sounds %d samples after its release", GAP);
+}
+
+/**
+ * @brief Live notes and chords land on the sample synth_now() gave
+ */
+static void check_live(void)
+{
+    for (uint32_t offset = 0; offset < SYNTH_BLOCK_SIZE; ++offset)
+    {
+        align(offset);
+        uint32_t from = drained;
+        uint32_t stamp = synth_now();
+        synth_play_note(note, CHANNEL, 127);
+        play_until(stamp + ONSET_WINDOW);
+
+        uint32_t onset = onset_from(from);
+        CHECK(onset == stamp, "note queued for sample %lu (offset %lu) starts at %lu", (unsigned long)stamp,
+            (unsigned long)offset, (unsigned long)onset);
+        release();
+    }
+
+    // Chord notes queued together start together
+    align(SYNTH_BLOCK_SIZE / 2 + 1);
+    uint32_t from = drained;
+    uint32_t stamp = synth_now();
+    for (int i = 0; i < 3; ++i) synth_play_note((synth_note_t){.octave = 3, .note = 4 * i}, CHANNEL, 100);
+    play_until(stamp + ONSET_WINDOW);
+    CHECK(onset_from(from) == stamp, "chord queued for %lu starts at %lu", (unsigned long)stamp,
+        (unsigned long)onset_from(from));
+    for (int i = 0; i < 3; ++i) synth_stop_note((synth_note_t){.octave = 3, .note = 4 * i}, CHANNEL);
+    play_until(drained + GAP);
+}
+
+/**
+ * @brief Events of one block split it at each of their offsets
+ *
+ * A silent event first, so the note is the second split of its block.
+ */
+static void check_scheduled(void)
+{
+    synth_cmd_t program = {SYNTH_CMD_PROGRAM_CHANGE, CHANNEL, 1, 0};
+    synth_cmd_t note_on = {SYNTH_CMD_NOTE_ON, CHANNEL, 69, 127};
+    synth_cmd_t note_off = {SYNTH_CMD_NOTE_OFF, CHANNEL, 69, 0};
+
+    for (uint32_t offset = 1; offset < SYNTH_BLOCK_SIZE; ++offset)
+    {
+        align(0);
+        uint32_t from = drained;
+        uint32_t block = synth_now() + SYNTH_BLOCK_SIZE;
+        CHECK(synth_schedule(block + offset / 2, &program) == ESP_OK, "program change not queued");
+        CHECK(synth_schedule(block + offset, &note_on) == ESP_OK, "note not queued");
+        play_until(block + offset + ONSET_WINDOW);
+
+        uint32_t onset = onset_from(from);
+        CHECK(onset == block + offset, "note scheduled at offset %lu after an event at %lu starts at offset %ld",
+            (unsigned long)offset, (unsigned long)offset / 2, (long)(onset - block));
+
+        synth_schedule(drained + SYNTH_BLOCK_COUNT * SYNTH_BLOCK_SIZE * 2, &note_off);
+        play_until(drained + GAP);
+    }
+
+    // Too late for its sample: played at the start of the next block rendered
+    align(SYNTH_BLOCK_SIZE / 2);
+    uint32_t from = drained;
+    uint32_t now = synth_now();
+    CHECK(synth_schedule(now - SYNTH_BLOCK_SIZE, &note_on) == ESP_OK, "late note not queued");
+    play_until(now + ONSET_WINDOW);
+    uint32_t onset = onset_from(from);
+    CHECK(onset == now - now % SYNTH_BLOCK_SIZE, "late note at %lu starts at %lu, %lu expected",
+        (unsigned long)(now - SYNTH_BLOCK_SIZE), (unsigned long)onset, (unsigned long)(now - now % SYNTH_BLOCK_SIZE));
+    synth_schedule(synth_now(), &note_off);
+    play_until(drained + GAP);
+}
+
+/**
+ * @brief Pulse trains start on the microsecond of their sample
+ */
+static void check_pulses(void)
+{
+    synth_set_on_pulse_cb(on_pulse_cb);
+    synth_set_pulse_width(PULSE_WIDTH_US);
+    synth_set_output(SYNTH_OUTPUT_PULSES);
+
+    for (uint32_t offset = 0; offset < SYNTH_BLOCK_SIZE; offset += 5)
+    {
+        align(offset);
+        first_pulse_us = NO_PULSE;
+        uint32_t stamp = synth_now();
+        uint32_t expected = (uint64_t)stamp * 1000000 / SYNTH_SAMPLING_RATE_HZ;
+        synth_play_note(note, CHANNEL, 127);
+        play_until(stamp + ONSET_WINDOW);
+
+        CHECK(first_pulse_us == expected, "pulses of a note queued for sample %lu start at %lu us, %lu expected",
+            (unsigned long)stamp, (unsigned long)first_pulse_us, (unsigned long)expected);
+        synth_stop_note(note, CHANNEL);
+        play_until(drained + GAP);
+    }
+
+    synth_set_output(SYNTH_OUTPUT_AUDIO);
+}
+
+/**
+ * @brief Host time per block of every voice held, on the render task and on
+ * all tasks
+ *
+ * With two cores the render task only renders its half of the voices, and
+ * the helper the other half.
+ */
+static void print_block_cost(void)
+{
+    for (int i = 0; i < SYNTH_MAX_CHORD_SIZE; ++i)
+        synth_play_note((synth_note_t){.octave = 2 + i / 12, .note = i % 12}, CHANNEL, 100);
+    play_until(drained + SYNTH_BLOCK_COUNT * SYNTH_BLOCK_SIZE);
+
+    uint64_t render_ns = host_rtos_measured_ns(), tasks_ns = host_rtos_cpu_ns();
+    play_until(drained + COST_BLOCKS * SYNTH_BLOCK_SIZE);
+    render_ns = host_rtos_measured_ns() - render_ns;
+    tasks_ns = host_rtos_cpu_ns() - tasks_ns;
+
+    printf("%s, %d voices: %.0f ns per block of %d on the render task, %.0f ns on all tasks (host time)\n",
+        CORES_NAME, SYNTH_MAX_CHORD_SIZE, (double)render_ns / COST_BLOCKS, SYNTH_BLOCK_SIZE,
+        (double)tasks_ns / COST_BLOCKS);
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    if (synth_init() != ESP_OK) return 1;
+    synth_set_on_sampling_cb(on_sampling_cb);
+    host_rtos_wait_idle();
+    synth_enable();
+    play_until(SYNTH_BLOCK_COUNT * SYNTH_BLOCK_SIZE);
+
+    check_live();
+    check_scheduled();
+    check_pulses();
+
+    CHECK(drained < LEN, "%lu samples drained, past the %d recorded", (unsigned long)drained, LEN);
+    printf("%lu samples drained, %d offsets in blocks of %d\n", (unsigned long)drained, SYNTH_BLOCK_SIZE,
+        SYNTH_BLOCK_SIZE);
+    print_block_cost();
+
+    return host_check_report("timing_check");
+}
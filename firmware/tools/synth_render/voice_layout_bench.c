@@ -0,0 +1,307 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file voice_layout_bench.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/envelope.h"
+#include "dsp/fm.h"
+#include "dsp/mixer.h"
+#include "dsp/note_table.h"
+#include "dsp/synth_engine.h"
+#include "dsp/velocity.h"
+#include "dsp/wavetable.h"
+#include "sdkconfig.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: voice_layout_bench\n"                                                                                      \
+    "\n"                                                                                                               \
+    "Times the engine render against the voice loop it replaced, an array of\n"                                       \
+    "voice structs scanned slot by slot, for held saw chords of 0 to every\n"                                         \
+    "voice. Both render the same samples, checked before timing. Then times\n"                                      \
+    "the engine per voice for each kind of voice against the plain sine.\n"
+
+#define RENDER_CHUNK 64 // Control rate of the replaced loop
+#define BENCH_LEN SYNTH_SAMPLING_RATE_HZ
+#define BENCH_RUNS 5 // Best of, against scheduling noise
+#define FIRST_CODE 48
+#define CODE_STEP 3
+#define VELOCITY 100
+#define CHANNEL 0
+#define SHAPE WAVETABLE_SHAPE_SAW
+
+#define BEND_BITS 13
+#define BEND_CENTER (1 << BEND_BITS)
+
+// -----------------------------------------------------------------------------
+// Private Typedefs
+// -----------------------------------------------------------------------------
+// Voice of the replaced loop, free while its envelope is idle
+typedef struct
+{
+    uint8_t code : 7;
+    uint8_t key_down : 1;
+    uint8_t channel : 4;
+    uint8_t sostenuto : 1;
+    uint32_t phase_acc;
+    uint32_t phase_inc;
+    int32_t gain;
+    uint32_t age;
+    const int16_t *table;
+    envelope_t env;
+} note_data_t;
+
+typedef struct
+{
+    int16_t bend;
+    uint8_t bend_range;
+    int16_t vibrato_depth;
+} channel_data_t;
+
+typedef struct
+{
+    const char *name;
+    bool fm;
+    int id; // Shape, or patch when fm
+} voice_kind_t;
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const envelope_config_t envelope_cfg = {
+    .attack_ms = CONFIG_INTERRUPTER_SYNTH_ATTACK_MS,
+    .decay_ms = CONFIG_INTERRUPTER_SYNTH_DECAY_MS,
+    .sustain_level = CONFIG_INTERRUPTER_SYNTH_SUSTAIN_PCT * 32767 / 100,
+    .release_ms = CONFIG_INTERRUPTER_SYNTH_RELEASE_MS,
+};
+
+static note_data_t active_notes[SYNTH_MAX_CHORD_SIZE];
+static channel_data_t channels[SYNTH_CHANNEL_COUNT];
+static uint32_t lfo_phase = 0;
+static uint32_t lfo_inc = 0;
+
+static const voice_kind_t voice_kinds[] = {
+    {"sine", false, WAVETABLE_SHAPE_SINE},
+    {"square", false, WAVETABLE_SHAPE_SQUARE},
+    {"saw", false, WAVETABLE_SHAPE_SAW},
+    {"pulse", false, WAVETABLE_SHAPE_PULSE},
+    {"fm epiano", true, FM_PATCH_EPIANO},
+    {"fm bell", true, FM_PATCH_BELL},
+    {"fm brass", true, FM_PATCH_BRASS},
+    {"fm bass", true, FM_PATCH_BASS},
+};
+
+static uint16_t out_struct[BENCH_LEN];
+static uint16_t out_engine[BENCH_LEN];
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static inline bool voice_is_free(const note_data_t *note) { return note->env.stage == ENVELOPE_STAGE_IDLE; }
+
+static void struct_update_pitch(int32_t lfo)
+{
+    for (int i = 0; i < SYNTH_MAX_CHORD_SIZE; ++i)
+    {
+        note_data_t *note = &active_notes[i];
+        if (voice_is_free(note)) continue;
+
+        const channel_data_t *ch = &channels[note->channel];
+        int32_t fine = ((int32_t)ch->bend * (ch->bend_range << NOTE_TABLE_FINE_BITS) + BEND_CENTER / 2) >> BEND_BITS;
+        fine += (lfo * ch->vibrato_depth) >> 15;
+        note->phase_inc = fine ? note_table_phase_inc_fine(note->code, fine) : note_table_phase_inc(note->code);
+    }
+}
+
+static void struct_render(uint16_t *out, size_t len)
+{
+    static int32_t acc[RENDER_CHUNK];
+
+    for (size_t start = 0; start < len; start += RENDER_CHUNK)
+    {
+        size_t chunk = len - start < RENDER_CHUNK ? len - start : RENDER_CHUNK;
+        for (size_t n = 0; n < chunk; ++n) acc[n] = 0;
+
+        struct_update_pitch(wavetable_read(wavetable_sine(), lfo_phase));
+        lfo_phase += lfo_inc * chunk;
+
+        for (int i = 0; i < SYNTH_MAX_CHORD_SIZE; ++i)
+        {
+            note_data_t *note = &active_notes[i];
+            if (voice_is_free(note)) continue;
+
+            for (size_t n = 0; n < chunk; ++n)
+            {
+                note->phase_acc += note->phase_inc;
+                int32_t sample = wavetable_read(note->table, note->phase_acc);
+
+                sample = (sample * envelope_step(&note->env)) >> ENVELOPE_OUT_BITS;
+                acc[n] += (sample * note->gain) >> VELOCITY_GAIN_BITS;
+            }
+        }
+
+        mixer_process(acc, out + start, chunk);
+    }
+}
+
+/**
+ * @brief Strike the same chord in both layouts, from silence
+ */
+static void start_chord(int voices)
+{
+    synth_engine_init();
+    synth_engine_set_shape(CHANNEL, SHAPE);
+    memset(active_notes, 0, sizeof(active_notes));
+    for (int i = 0; i < SYNTH_CHANNEL_COUNT; ++i) channels[i] = (channel_data_t){.bend_range = 2};
+    lfo_phase = 0;
+    lfo_inc = (uint32_t)(CONFIG_INTERRUPTER_SYNTH_VIBRATO_RATE_DHZ / 10.0 / SYNTH_SAMPLING_RATE_HZ * 4294967296.0);
+
+    for (int i = 0; i < voices; ++i)
+    {
+        uint8_t code = FIRST_CODE + CODE_STEP * i;
+        note_data_t *note = &active_notes[i];
+
+        synth_engine_note_on(code, CHANNEL, VELOCITY);
+        *note = (note_data_t){.code = code, .key_down = 1, .channel = CHANNEL, .age = i};
+        note->gain = velocity_gain(VELOCITY_CURVE_LINEAR, VELOCITY);
+        note->table = wavetable_get(SHAPE, code);
+        envelope_start(&note->env, &envelope_cfg, SYNTH_SAMPLING_RATE_HZ);
+    }
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief Best time per sample over the runs, in ns
+ */
+static double time_render(void (*render)(uint16_t *, size_t), uint16_t *out)
+{
+    double best = 0;
+
+    for (int run = 0; run < BENCH_RUNS; ++run)
+    {
+        double t0 = now_ns();
+        render(out, BENCH_LEN);
+        double ns = (now_ns() - t0) / BENCH_LEN;
+        if (run == 0 || ns < best) best = ns;
+    }
+
+    return best;
+}
+
+/**
+ * @brief Best engine time per sample of a held chord of one kind, in ns
+ *
+ * Each run strikes the chord again, so that decaying patches are timed over
+ * the same second.
+ */
+static double time_kind(const voice_kind_t *kind, int voices)
+{
+    double best = 0;
+
+    for (int run = 0; run < BENCH_RUNS; ++run)
+    {
+        synth_engine_init();
+        if (kind->fm)
+            synth_engine_set_fm_patch(CHANNEL, kind->id);
+        else
+            synth_engine_set_shape(CHANNEL, kind->id);
+        for (int i = 0; i < voices; ++i) synth_engine_note_on(FIRST_CODE + CODE_STEP * i, CHANNEL, VELOCITY);
+
+        double t0 = now_ns();
+        synth_engine_render(out_engine, BENCH_LEN);
+        double ns = (now_ns() - t0) / BENCH_LEN;
+        if (run == 0 || ns < best) best = ns;
+
+        if (synth_engine_active_voices() != voices)
+            printf("%s: %d of %d voices ended before the last sample\n", kind->name,
+                voices - synth_engine_active_voices(), voices);
+    }
+
+    return best;
+}
+
+/**
+ * @brief Cost of one voice of each kind, the full chord less silence
+ */
+static void print_kinds(void)
+{
+    double sine = 0;
+
+    printf("\nns per voice per sample, %d voices held\n", SYNTH_MAX_CHORD_SIZE);
+    printf("kind        voice  ratio to sine\n");
+    for (size_t k = 0; k < sizeof(voice_kinds) / sizeof(voice_kinds[0]); ++k)
+    {
+        const voice_kind_t *kind = &voice_kinds[k];
+        double voice = (time_kind(kind, SYNTH_MAX_CHORD_SIZE) - time_kind(kind, 0)) / SYNTH_MAX_CHORD_SIZE;
+
+        if (k == 0) sine = voice;
+        printf("%-10s  %5.2f  %13.2f\n", kind->name, voice, voice / sine);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    const int counts[] = {0, 1, 2, 4, 8, SYNTH_MAX_CHORD_SIZE};
+    int failed = 0;
+
+    printf("%d voices, %d Hz, ns per sample, best of %d runs of %d samples\n", SYNTH_MAX_CHORD_SIZE,
+        SYNTH_SAMPLING_RATE_HZ, BENCH_RUNS, BENCH_LEN);
+    printf("voices  structs  arrays  ratio\n");
+
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i)
+    {
+        int voices = counts[i];
+
+        start_chord(voices);
+        struct_render(out_struct, BENCH_LEN);
+        synth_engine_render(out_engine, BENCH_LEN);
+        if (memcmp(out_struct, out_engine, sizeof(out_engine)) != 0)
+        {
+            fprintf(stderr, "%d voices: layouts render different samples\n", voices);
+            failed++;
+            continue;
+        }
+
+        double structs = time_render(struct_render, out_struct);
+        double arrays = time_render(synth_engine_render, out_engine);
+        printf("%6d  %7.2f  %6.2f  %5.2f\n", voices, structs, arrays, structs / arrays);
+    }
+
+    print_kinds();
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2025 Stanley Arnaud <stantonik@stantonik-mba.local>
+ *
+ * Distributed under terms of the MIT license.
+ */
+
+/**
+ * @file wavetable_check.c
+ * @brief
+ *
+ * @author Stanley Arnaud
+ * @date 10/17/2026
+ * @version 0
+ */
+
+// -----------------------------------------------------------------------------
+// Includes
+// -----------------------------------------------------------------------------
+#include "dsp/note_table.h"
+#include "dsp/synth_engine.h"
+#include "dsp/wavetable.h"
+#include "host_check.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// -----------------------------------------------------------------------------
+// Macros and Constants
+// -----------------------------------------------------------------------------
+#define USAGE                                                                                                          \
+    "usage: wavetable_check\n"                                                                                         \
+    "\n"                                                                                                               \
+    "Measures the interpolated sine against sin() at random phases and around\n"                                      \
+    "the wrap, and the THD and THD+N of one second of it at a few notes. The\n"                                      \
+    "256-entry truncated table the synth played before is measured alongside\n"                                       \
+    "as the reference, and the host time per sample of both is printed.\n"
+
+#define PHASE_ONE 4294967296.0
+#define RANDOM_PHASES 1000000
+#define WRAP_PHASES 4096
+
+#define ERROR_LSB_MAX 2.0 // Table rounding, plus the truncated interpolation weight
+#define THD_DB_MAX -90.0
+#define THDN_DB_MAX -85.0
+#define THDN_GAIN_DB_MIN 30.0 // Over the old table, at every note
+#define HARMONICS 10
+
+#define OLD_TABLE_BITS 8
+#define OLD_TABLE_SIZE (1 << OLD_TABLE_BITS)
+
+#define BENCH_RUNS 5 // Best of, against scheduling noise
+
+// -----------------------------------------------------------------------------
+// Static Variables
+// -----------------------------------------------------------------------------
+static const uint8_t thd_notes[] = {21, 33, 45, 57, 69, 81, 93, 105};
+
+// The sine the synth played before the interpolated table, read truncated
+static int16_t old_table[OLD_TABLE_SIZE];
+
+// -----------------------------------------------------------------------------
+// Static Function Definitions
+// -----------------------------------------------------------------------------
+static double read_error(const int16_t *sine, uint32_t phase)
+{
+    return wavetable_read(sine, phase) - WAVETABLE_MAX * sin(2 * M_PI * phase / PHASE_ONE);
+}
+
+static void old_init(void)
+{
+    for (int i = 0; i < OLD_TABLE_SIZE; ++i)
+        old_table[i] = (int16_t)(sinf(2.0f * M_PI * i / OLD_TABLE_SIZE) * WAVETABLE_MAX);
+}
+
+static void old_oscillator(int16_t *buf, size_t len, uint32_t inc)
+{
+    uint32_t phase = 0;
+    for (size_t n = 0; n < len; ++n)
+    {
+        phase += inc;
+        buf[n] = old_table[phase >> (32 - OLD_TABLE_BITS)];
+    }
+}
+
+static void new_oscillator(int16_t *buf, size_t len, uint32_t inc)
+{
+    const int16_t *sine = wavetable_sine();
+    uint32_t phase = 0;
+    for (size_t n = 0; n < len; ++n)
+    {
+        phase += inc;
+        buf[n] = wavetable_read(sine, phase);
+    }
+}
+
+/**
+ * @brief THD in dB of a second of sine at a note, harmonics under Nyquist
+ */
+static double sine_thd_db(uint8_t code, int16_t *buf, size_t len)
+{
+    uint32_t inc = note_table_phase_inc(code);
+    new_oscillator(buf, len, inc);
+
+    double freq_hz = inc * (double)SYNTH_SAMPLING_RATE_HZ / PHASE_ONE;
+    double fundamental = host_check_amplitude(buf, len, freq_hz, SYNTH_SAMPLING_RATE_HZ);
+    double distortion = 0;
+    for (int h = 2; h <= HARMONICS && h * freq_hz < SYNTH_SAMPLING_RATE_HZ / 2; ++h)
+    {
+        double a = host_check_amplitude(buf, len, h * freq_hz, SYNTH_SAMPLING_RATE_HZ);
+        distortion += a * a;
+    }
+
+    // No harmonic under Nyquist, the floor of the measurement stands for it
+    if (distortion == 0) distortion = 1e-3;
+
+    return 10 * log10(distortion / (fundamental * fundamental));
+}
+
+/**
+ * @brief THD+N in dB of a second of an oscillator at a note
+ *
+ * Everything but the fundamental: the sine of the note phase that fits the
+ * output best is taken out, and what is left counts, DC included.
+ */
+static double thdn_db(void (*oscillator)(int16_t *, size_t, uint32_t), uint8_t code, int16_t *buf, size_t len)
+{
+    uint32_t inc = note_table_phase_inc(code);
+    double ss = 0, sc = 0, cc = 0, xs = 0, xc = 0;
+    uint32_t phase = 0;
+
+    oscillator(buf, len, inc);
+    for (size_t n = 0; n < len; ++n)
+    {
+        phase += inc;
+        double a = 2 * M_PI * phase / PHASE_ONE;
+        ss += sin(a) * sin(a);
+        sc += sin(a) * cos(a);
+        cc += cos(a) * cos(a);
+        xs += buf[n] * sin(a);
+        xc += buf[n] * cos(a);
+    }
+
+    // Least squares amplitudes of the sine and cosine of the phase
+    double det = ss * cc - sc * sc;
+    double a_sin = (xs * cc - xc * sc) / det;
+    double a_cos = (xc * ss - xs * sc) / det;
+    double signal = 0, rest = 0;
+
+    phase = 0;
+    for (size_t n = 0; n < len; ++n)
+    {
+        phase += inc;
+        double a = 2 * M_PI * phase / PHASE_ONE;
+        double fit = a_sin * sin(a) + a_cos * cos(a);
+        signal += fit * fit;
+        rest += (buf[n] - fit) * (buf[n] - fit);
+    }
+
+    return 10 * log10(rest / signal);
+}
+
+/**
+ * @brief Best host time per sample of an oscillator over the runs, in ns
+ */
+static double oscillator_ns(void (*oscillator)(int16_t *, size_t, uint32_t), int16_t *buf, size_t len)
+{
+    double best = 0;
+
+    for (int run = 0; run < BENCH_RUNS; ++run)
+    {
+        double t0 = host_check_now_ns();
+        oscillator(buf, len, note_table_phase_inc(69));
+        double ns = (host_check_now_ns() - t0) / len;
+        if (run == 0 || ns < best) best = ns;
+    }
+
+    return best;
+}
+
+// -----------------------------------------------------------------------------
+// Function Definitions
+// -----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        fputs(USAGE, stderr);
+        return 2;
+    }
+
+    wavetable_init();
+    old_init();
+    const int16_t *sine = wavetable_sine();
+
+    // Guard entries, read by the interpolation at the end of the table
+    CHECK(sine[WAVETABLE_SIZE] == sine[0], "sine guard %d, %d at the start", sine[WAVETABLE_SIZE], sine[0]);
+    for (int shape = WAVETABLE_SHAPE_SINE; shape < WAVETABLE_SHAPE_COUNT; ++shape)
+    {
+        for (int code = 0; code < NOTE_TABLE_SIZE; ++code)
+        {
+            const int16_t *table = wavetable_get(shape, code);
+            if (!CHECK(table[WAVETABLE_SIZE] == table[0], "shape %d note %d: guard entry is not the first", shape,
+                    code))
+                break;
+        }
+    }
+
+    double worst = 0, sum_sq = 0;
+    uint32_t worst_phase = 0;
+    uint32_t seed = 1;
+
+    for (uint32_t i = 0; i < RANDOM_PHASES + WRAP_PHASES; ++i)
+    {
+        seed = seed * 1664525 + 1013904223;
+        uint32_t phase = i < RANDOM_PHASES ? seed : (uint32_t)(i - RANDOM_PHASES - WRAP_PHASES / 2);
+        double err = read_error(sine, phase);
+        sum_sq += err * err;
+        if (fabs(err) > worst)
+        {
+            worst = fabs(err);
+            worst_phase = phase;
+        }
+    }
+
+    CHECK(worst <= ERROR_LSB_MAX, "interpolation off by %.3f LSB at phase 0x%08lx", worst,
+        (unsigned long)worst_phase);
+    printf("interpolation: %.3f LSB at most, %.3f LSB rms\n", worst, sqrt(sum_sq / (RANDOM_PHASES + WRAP_PHASES)));
+
+    int16_t *buf = malloc(SYNTH_SAMPLING_RATE_HZ * sizeof(*buf));
+    if (!buf)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    for (size_t i = 0; i < sizeof(thd_notes); ++i)
+    {
+        uint8_t code = thd_notes[i];
+        double thd = sine_thd_db(code, buf, SYNTH_SAMPLING_RATE_HZ);
+        double thdn = thdn_db(new_oscillator, code, buf, SYNTH_SAMPLING_RATE_HZ);
+        double old_thdn = thdn_db(old_oscillator, code, buf, SYNTH_SAMPLING_RATE_HZ);
+
+        CHECK(thd <= THD_DB_MAX, "note %d: THD %.1f dB", code, thd);
+        CHECK(thdn <= THDN_DB_MAX, "note %d: THD+N %.1f dB", code, thdn);
+        CHECK(old_thdn - thdn >= THDN_GAIN_DB_MIN, "note %d: THD+N %.1f dB against %.1f dB with the old table", code,
+            thdn, old_thdn);
+        printf("note %3d %8.2f Hz: THD %.1f dB, THD+N %.1f dB, old table THD+N %.1f dB\n", code,
+            note_table_freq_hz(code), thd, thdn, old_thdn);
+    }
+
+    printf("host time per sample: %.2f ns interpolated, %.2f ns old table\n",
+        oscillator_ns(new_oscillator, buf, SYNTH_SAMPLING_RATE_HZ),
+        oscillator_ns(old_oscillator, buf, SYNTH_SAMPLING_RATE_HZ));
+
+    free(buf);
+
+    return host_check_report("wavetable_check");
+}